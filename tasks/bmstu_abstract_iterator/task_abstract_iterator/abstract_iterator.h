@@ -1,5 +1,8 @@
 #pragma once
 #include <cstddef>	// for std::ptrdiff_t
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
 
 namespace bmstu
 {
@@ -9,6 +12,29 @@ struct Identity
 	using element_type = Z;
 };
 
+namespace
+{
+template <typename It>
+concept steps_back =
+	requires(It& it) { it.decrement(); } ||
+	requires(It& it, std::ptrdiff_t n) { it.advance(n); };
+}  // namespace
+
+// CRTP mixin: Derived implements a few primitives and gets the whole
+// operator set, with no virtual functions, so an iterator stays as small and
+// as trivially copyable as its own members and every operator can inline.
+//
+// Required:
+//   reference dereference() const;
+//   void increment();
+//   bool equal(const Derived& other) const;
+// Optional:
+//   void decrement();                               enables --
+//   void advance(difference_type n);                O(1) +=, otherwise n steps
+//   difference_type distance_to(const Derived&) const;  O(1) it - it
+//   bool is_valid() const;                          enables explicit bool
+// -= and it - n need decrement() or advance(); without either, += and
+// it + n throw std::invalid_argument on a negative step.
 template <typename Derived,
 		  typename Type,
 		  typename Tag,
@@ -17,33 +43,132 @@ struct abstract_iterator
 {
    public:
 	using iterator_category = Tag;
-	using value_type = Type;
+	using value_type = std::remove_cv_t<Type>;
 	using pointer = Type*;
 	using reference = Type&;
 	using difference_type = std::ptrdiff_t;
 	using element_type = typename Wrapper<Type>::element_type;
 
-	virtual ~abstract_iterator() = default;
+	reference operator*() const { return self().dereference(); }
+
+	pointer operator->() const { return std::addressof(**this); }
+
+	Derived& operator++()
+	{
+		self().increment();
+		return self();
+	}
+
+	Derived operator++(int)
+	{
+		Derived copy(self());
+		self().increment();
+		return copy;
+	}
+
+	Derived& operator--()
+		requires requires(Derived& it) { it.decrement(); }
+	{
+		self().decrement();
+		return self();
+	}
+
+	Derived operator--(int)
+		requires requires(Derived& it) { it.decrement(); }
+	{
+		Derived copy(self());
+		self().decrement();
+		return copy;
+	}
+
+	Derived& operator+=(const difference_type& n)
+	{
+		if constexpr (requires(Derived& it) { it.advance(n); })
+		{
+			self().advance(n);
+		}
+		else
+		{
+			if constexpr (!steps_back<Derived>)
+			{
+				if (n < 0)
+				{
+					throw std::invalid_argument(
+						"Iterator can't step backwards");
+				}
+			}
+			for (difference_type i = 0; i < n; ++i)
+			{
+				self().increment();
+			}
+			if constexpr (steps_back<Derived>)
+			{
+				for (difference_type i = 0; i > n; --i)
+				{
+					self().decrement();
+				}
+			}
+		}
+		return self();
+	}
+
+	Derived& operator-=(const difference_type& n)
+		requires steps_back<Derived>
+	{
+		return *this += -n;
+	}
+
+	friend Derived operator+(Derived it, const difference_type& n)
+	{
+		it += n;
+		return it;
+	}
 
-	virtual Derived& operator++() = 0;
-	virtual Derived& operator--() = 0;
+	friend Derived operator+(const difference_type& n, Derived it)
+	{
+		it += n;
+		return it;
+	}
 
-	virtual Derived operator++(int) = 0;
-	virtual Derived operator--(int) = 0;
+	friend Derived operator-(Derived it, const difference_type& n)
+		requires steps_back<Derived>
+	{
+		it -= n;
+		return it;
+	}
 
-	virtual Derived& operator+=(const difference_type& n) = 0;
-	virtual Derived& operator-=(const difference_type& n) = 0;
-	virtual Derived operator+(const difference_type& n) const = 0;
-	virtual Derived operator-(const difference_type& n) const = 0;
+	// Without distance_to, last must be reachable from first
+	friend difference_type operator-(const Derived& last, const Derived& first)
+	{
+		if constexpr (requires { first.distance_to(last); })
+		{
+			return first.distance_to(last);
+		}
+		else
+		{
+			difference_type n = 0;
+			for (Derived it = first; !it.equal(last); it.increment())
+			{
+				++n;
+			}
+			return n;
+		}
+	}
 
-	virtual reference operator*() const = 0;
-	virtual pointer operator->() const = 0;
+	friend bool operator==(const Derived& lhs, const Derived& rhs)
+	{
+		return lhs.equal(rhs);
+	}
 
-	virtual bool operator==(const Derived& other) const = 0;
-	virtual bool operator!=(const Derived& other) const = 0;
+	explicit operator bool() const
+		requires requires(const Derived& it) { it.is_valid(); }
+	{
+		return self().is_valid();
+	}
 
-	virtual explicit operator bool() const = 0;
+   private:
+	Derived& self() { return static_cast<Derived&>(*this); }
 
-	virtual difference_type operator-(const Derived& other) const = 0;
+	const Derived& self() const { return static_cast<const Derived&>(*this); }
 };
-}  // namespace bmstu
\ No newline at end of file
+}  // namespace bmstu
@@ -2,7 +2,291 @@
 
 #include "abstract_iterator.h"
 
-TEST(AbstractIteratorTest, PositiveNumbers)
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "bmstu_list.h"
+#include "bmstu_map.h"
+
+namespace
+{
+// Random access over the integers, built only from the primitives
+struct counting_iterator
+	: public bmstu::abstract_iterator<counting_iterator,
+									  const long,
+									  std::random_access_iterator_tag>
+{
+	long value = 0;
+
+	counting_iterator() = default;
+
+	explicit counting_iterator(long v) : value(v) {}
+
+	const long& dereference() const { return value; }
+
+	void increment() { ++value; }
+
+	void decrement() { --value; }
+
+	void advance(difference_type n) { value += n; }
+
+	difference_type distance_to(const counting_iterator& other) const
+	{
+		return other.value - value;
+	}
+
+	bool equal(const counting_iterator& other) const
+	{
+		return value == other.value;
+	}
+};
+
+// Forward only, no is_valid: no --, no explicit bool
+struct forward_only
+	: public bmstu::abstract_iterator<forward_only,
+									  int,
+									  std::forward_iterator_tag>
+{
+	int* ptr = nullptr;
+
+	int& dereference() const { return *ptr; }
+
+	void increment() { ++ptr; }
+
+	bool equal(const forward_only& other) const { return ptr == other.ptr; }
+};
+
+template <typename It>
+concept can_step_back = requires(It it) {
+	it -= 1;
+	it - 1;
+};
+}  // namespace
+
+static_assert(sizeof(bmstu::list<int>::iterator) == sizeof(void*));
+static_assert(std::is_trivially_copyable_v<bmstu::list<int>::iterator>);
+static_assert(!std::is_polymorphic_v<bmstu::list<int>::iterator>);
+static_assert(std::bidirectional_iterator<bmstu::list<int>::iterator>);
+static_assert(sizeof(bmstu::map<int, int>::iterator) == 2 * sizeof(void*));
+static_assert(std::is_trivially_copyable_v<bmstu::map<int, int>::iterator>);
+static_assert(std::bidirectional_iterator<bmstu::map<int, int>::iterator>);
+static_assert(std::forward_iterator<forward_only>);
+static_assert(!std::bidirectional_iterator<forward_only>);
+static_assert(!std::is_constructible_v<bool, forward_only>);
+static_assert(!can_step_back<forward_only>);
+static_assert(can_step_back<bmstu::list<int>::iterator>);
+static_assert(std::is_constructible_v<bool, bmstu::list<int>::iterator>);
+
+TEST(AbstractIteratorTest, DerivedOperators)
+{
+	counting_iterator it(10);
+	ASSERT_EQ(*it, 10);
+	ASSERT_EQ(*++it, 11);
+	ASSERT_EQ(*it++, 11);
+	ASSERT_EQ(*it, 12);
+	ASSERT_EQ(*--it, 11);
+	ASSERT_EQ(*it--, 11);
+	ASSERT_EQ(*(it + 5), 15);
+	ASSERT_EQ(*(5 + it), 15);
+	ASSERT_EQ(*(it - 3), 7);
+	it += 4;
+	ASSERT_EQ(*it, 14);
+	it -= 2;
+	ASSERT_EQ(*it, 12);
+	ASSERT_EQ(counting_iterator(20) - counting_iterator(5), 15);
+	ASSERT_TRUE(counting_iterator(3) == counting_iterator(3));
+	ASSERT_TRUE(counting_iterator(3) != counting_iterator(4));
+}
+
+TEST(AbstractIteratorTest, StepwiseFallbacks)
+{
+	int data[] = {1, 2, 3, 4, 5};
+	forward_only first;
+	first.ptr = data;
+	forward_only last;
+	last.ptr = data + 5;
+	ASSERT_EQ(last - first, 5);
+	ASSERT_EQ(*(first + 3), 4);
+	ASSERT_EQ(std::distance(first, last), 5);
+	forward_only it3 = first + 3;
+	ASSERT_THROW(it3 += -2, std::invalid_argument);
+	ASSERT_THROW(-1 + it3, std::invalid_argument);
+	ASSERT_EQ(*it3, 4);
+
+	bmstu::list<int> list{1, 2, 3, 4, 5};
+	auto it = list.end();
+	it -= 2;
+	ASSERT_EQ(*it, 4);
+	it += -1;
+	ASSERT_EQ(*it, 3);
+	ASSERT_TRUE(static_cast<bool>(it));
+}
+
+TEST(AbstractIteratorTest, MapIterator)
+{
+	bmstu::map<int, int> map;
+	for (int i = 0; i < 100; ++i)
+	{
+		map[(i * 37) % 100] = i;
+	}
+	int expected_key = 0;
+	for (auto it = map.begin(); it != map.end(); ++it)
+	{
+		ASSERT_EQ(it->first, expected_key++);
+	}
+	ASSERT_EQ(expected_key, 100);
+	ASSERT_EQ((--map.end())->first, 99);
+	ASSERT_EQ(map.end() - map.begin(), 100);
+	auto it = map.begin() + 10;
+	(*it).second = -1;
+	ASSERT_EQ(map[10], -1);
+}
+
+namespace
+{
+// The previous interface, kept here to measure what the virtual calls cost
+template <typename Derived, typename Type, typename Tag>
+struct legacy_abstract_iterator
+{
+	using iterator_category = Tag;
+	using value_type = Type;
+	using pointer = Type*;
+	using reference = Type&;
+	using difference_type = std::ptrdiff_t;
+
+	virtual ~legacy_abstract_iterator() = default;
+
+	virtual Derived& operator++() = 0;
+	virtual reference operator*() const = 0;
+	virtual pointer operator->() const = 0;
+	virtual bool operator==(const Derived& other) const = 0;
+	virtual bool operator!=(const Derived& other) const = 0;
+};
+
+template <typename It>
+struct legacy_iterator
+	: legacy_abstract_iterator<legacy_iterator<It>,
+							   typename It::value_type,
+							   typename It::iterator_category>
+{
+	explicit legacy_iterator(It it) : it_(it) {}
+
+	legacy_iterator& operator++() override
+	{
+		++it_;
+		return *this;
+	}
+
+	typename It::reference operator*() const override { return *it_; }
+
+	typename It::pointer operator->() const override { return &*it_; }
+
+	bool operator==(const legacy_iterator& other) const override
+	{
+		return it_ == other.it_;
+	}
+
+	bool operator!=(const legacy_iterator& other) const override
+	{
+		return it_ != other.it_;
+	}
+
+	It it_;
+};
+
+struct plain_value
+{
+	template <typename T>
+	long long operator()(const T& value) const
+	{
+		return value;
+	}
+};
+
+struct mapped_value
+{
+	template <typename T>
+	long long operator()(const T& pair) const
+	{
+		return pair.second;
+	}
+};
+
+template <typename It, typename Proj>
+[[gnu::noipa]] long long sum_static(It first, It last, Proj proj)
+{
+	long long sum = 0;
+	for (; first != last; ++first)
+	{
+		sum += proj(*first);
+	}
+	return sum;
+}
+
+// Goes through the base class, as code written against the interface would
+template <typename Derived, typename Type, typename Tag, typename Proj>
+[[gnu::noipa]] long long sum_virtual(
+	legacy_abstract_iterator<Derived, Type, Tag>& first,
+	const Derived& last,
+	Proj proj)
+{
+	long long sum = 0;
+	for (; first != last; ++first)
+	{
+		sum += proj(*first);
+	}
+	return sum;
+}
+
+template <typename Func>
+void time_it(const char* name, Func func)
+{
+	auto start = std::chrono::steady_clock::now();
+	long long checksum = func();
+	auto elapsed = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start);
+	std::cout << name << ": " << elapsed.count() << " ms (checksum "
+			  << checksum << ")" << std::endl;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(AbstractIteratorBench, DISABLED_SumList)
+{
+	bmstu::list<int> list;
+	for (int i = 0; i < 10'000'000; ++i)
+	{
+		list.push_back(i % 1000);
+	}
+	time_it("list, CRTP iterator",
+			[&]
+			{ return sum_static(list.begin(), list.end(), plain_value()); });
+	time_it("list, virtual iterator",
+			[&]
+			{
+				legacy_iterator first(list.begin());
+				legacy_iterator last(list.end());
+				return sum_virtual(first, last, plain_value());
+			});
+}
+
+TEST(AbstractIteratorBench, DISABLED_SumMap)
 {
-	std::cout << "Tests need here" << std::endl;
+	bmstu::map<int, int> map;
+	for (int i = 0; i < 10'000'000; ++i)
+	{
+		map.insert(i, i % 1000);
+	}
+	time_it("map, CRTP iterator",
+			[&]
+			{ return sum_static(map.begin(), map.end(), mapped_value()); });
+	time_it("map, virtual iterator",
+			[&]
+			{
+				legacy_iterator first(map.begin());
+				legacy_iterator last(map.end());
+				return sum_virtual(first, last, mapped_value());
+			});
 }
@@ -0,0 +1,294 @@
+#include "bmstu_any_iterator.h"
+
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+#include "bmstu_list.h"
+#include "bmstu_map.h"
+#include "bmstu_simple_vector.h"
+
+namespace
+{
+template <typename T>
+using any_iter = bmstu::any_forward_iterator<T>;
+
+// Bigger than the inline buffer, with an instance count to catch leaks
+struct fat_iterator
+{
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = int;
+	using difference_type = std::ptrdiff_t;
+	using pointer = int*;
+	using reference = int&;
+
+	fat_iterator() { ++alive; }
+
+	explicit fat_iterator(int* p) : ptr(p) { ++alive; }
+
+	fat_iterator(const fat_iterator& other) : ptr(other.ptr) { ++alive; }
+
+	fat_iterator& operator=(const fat_iterator& other) = default;
+
+	~fat_iterator() { --alive; }
+
+	int& operator*() const { return *ptr; }
+
+	fat_iterator& operator++()
+	{
+		++ptr;
+		return *this;
+	}
+
+	fat_iterator operator++(int)
+	{
+		fat_iterator copy(*this);
+		++ptr;
+		return copy;
+	}
+
+	bool operator==(const fat_iterator& other) const
+	{
+		return ptr == other.ptr;
+	}
+
+	int* ptr = nullptr;
+	std::array<char, 64> padding{};
+	inline static int alive = 0;
+};
+}  // namespace
+
+static_assert(std::forward_iterator<any_iter<int>>);
+static_assert(any_iter<int>::stored_inline<bmstu::list<int>::iterator>);
+static_assert(
+	any_iter<int>::stored_inline<bmstu::simple_vector<int>::iterator>);
+static_assert(any_iter<std::pair<const int, int>>::stored_inline<
+			  bmstu::map<int, int>::iterator>);
+static_assert(any_iter<int>::stored_inline<std::vector<int>::iterator>);
+static_assert(!any_iter<int>::stored_inline<fat_iterator>);
+
+TEST(AnyIteratorTest, List)
+{
+	bmstu::list<int> list{1, 2, 3, 4};
+	bmstu::any_range<int> range(list);
+	ASSERT_FALSE(range.empty());
+	ASSERT_EQ(std::accumulate(range.begin(), range.end(), 0), 10);
+	*range.begin() = 10;
+	ASSERT_EQ(*list.begin(), 10);
+}
+
+TEST(AnyIteratorTest, SimpleVector)
+{
+	bmstu::simple_vector<std::string> vec{"a", "bb", "ccc"};
+	bmstu::any_range<const std::string> range(vec);
+	size_t total = 0;
+	for (const auto& str : range)
+	{
+		total += str.size();
+	}
+	ASSERT_EQ(total, 6u);
+	ASSERT_EQ(range.begin()->size(), 1u);
+}
+
+TEST(AnyIteratorTest, Map)
+{
+	bmstu::map<int, std::string> map;
+	map[2] = "two";
+	map[1] = "one";
+	bmstu::any_range<std::pair<const int, std::string>> range(map);
+	std::vector<int> keys;
+	for (auto& [key, value] : range)
+	{
+		keys.push_back(key);
+		value += "!";
+	}
+	ASSERT_EQ(keys, (std::vector<int>{1, 2}));
+	ASSERT_EQ(map[1], "one!");
+}
+
+TEST(AnyIteratorTest, CopyMoveCompare)
+{
+	bmstu::list<int> list{1, 2, 3};
+	any_iter<int> it = list.begin();
+	any_iter<int> copy = it;
+	++it;
+	ASSERT_EQ(*copy, 1);
+	ASSERT_EQ(*it, 2);
+	ASSERT_EQ(*copy++, 1);
+	ASSERT_TRUE(copy == it);
+
+	any_iter<int> moved = std::move(copy);
+	ASSERT_TRUE(moved == it);
+	ASSERT_TRUE(copy == any_iter<int>());
+	copy = moved;
+	ASSERT_TRUE(copy == it);
+
+	// different underlying types are never equal
+	std::vector<int> vec{2};
+	ASSERT_FALSE(any_iter<int>(vec.begin()) == it);
+	ASSERT_TRUE(any_iter<int>() == any_iter<int>());
+}
+
+TEST(AnyIteratorTest, HeapFallback)
+{
+	int data[] = {1, 2, 3, 4, 5};
+	{
+		bmstu::any_range<int> range(fat_iterator(data),
+									fat_iterator(data + 5));
+		ASSERT_EQ(std::accumulate(range.begin(), range.end(), 0), 15);
+		auto it = range.begin();
+		auto other = it;
+		other = range.end();
+		ASSERT_FALSE(it == other);
+		int out[8];
+		ASSERT_EQ(range.next_n(out, 8), 5u);
+		ASSERT_EQ(out[4], 5);
+	}
+	ASSERT_EQ(fat_iterator::alive, 0);
+}
+
+TEST(AnyIteratorTest, NextN)
+{
+	bmstu::simple_vector<int> vec;
+	for (int i = 0; i < 10; ++i)
+	{
+		vec.push_back(i);
+	}
+	bmstu::any_range<int> range(vec);
+	int out[4];
+	ASSERT_EQ(range.next_n(out, 4), 4u);
+	ASSERT_EQ(out[3], 3);
+	ASSERT_EQ(range.next_n(out, 4), 4u);
+	ASSERT_EQ(out[0], 4);
+	ASSERT_EQ(range.next_n(out, 4), 2u);
+	ASSERT_EQ(out[1], 9);
+	ASSERT_EQ(range.next_n(out, 4), 0u);
+	ASSERT_TRUE(range.empty());
+}
+
+namespace
+{
+// What a plugin interface without type erasure would look like
+struct virtual_int_cursor
+{
+	virtual ~virtual_int_cursor() = default;
+	virtual int& get() const = 0;
+	virtual void next() = 0;
+	virtual bool done() const = 0;
+};
+
+struct vector_cursor final : virtual_int_cursor
+{
+	vector_cursor(int* first, int* last) : first_(first), last_(last) {}
+
+	int& get() const override { return *first_; }
+
+	void next() override { ++first_; }
+
+	bool done() const override { return first_ == last_; }
+
+	int* first_;
+	int* last_;
+};
+
+struct list_cursor final : virtual_int_cursor
+{
+	explicit list_cursor(bmstu::list<int>& list)
+		: first_(list.begin()), last_(list.end())
+	{
+	}
+
+	int& get() const override { return *first_; }
+
+	void next() override { ++first_; }
+
+	bool done() const override { return first_ == last_; }
+
+	bmstu::list<int>::iterator first_;
+	bmstu::list<int>::iterator last_;
+};
+
+[[gnu::noipa]] long long sum_cursor(virtual_int_cursor& cursor)
+{
+	long long sum = 0;
+	for (; !cursor.done(); cursor.next())
+	{
+		sum += cursor.get();
+	}
+	return sum;
+}
+
+[[gnu::noipa]] long long sum_any(const bmstu::any_range<int>& range)
+{
+	long long sum = 0;
+	for (auto it = range.begin(), end = range.end(); it != end; ++it)
+	{
+		sum += *it;
+	}
+	return sum;
+}
+
+[[gnu::noipa]] long long sum_batched(bmstu::any_range<int> range)
+{
+	long long sum = 0;
+	int batch[256];
+	while (size_t count = range.next_n(batch, 256))
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			sum += batch[i];
+		}
+	}
+	return sum;
+}
+
+template <typename Func>
+void time_it(const char* name, Func func)
+{
+	auto start = std::chrono::steady_clock::now();
+	long long checksum = func();
+	auto elapsed = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start);
+	std::cout << name << ": " << elapsed.count() << " ms (checksum "
+			  << checksum << ")" << std::endl;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(AnyIteratorBench, DISABLED_Sum)
+{
+	bmstu::simple_vector<int> vec;
+	for (int i = 0; i < 10'000'000; ++i)
+	{
+		vec.push_back(i % 1000);
+	}
+	time_it("concrete iterator",
+			[&]
+			{
+				long long sum = 0;
+				for (int value : vec)
+				{
+					sum += value;
+				}
+				return sum;
+			});
+	// a second implementation keeps the call site genuinely polymorphic
+	bmstu::list<int> list{1, 2, 3};
+	list_cursor other(list);
+	ASSERT_EQ(sum_cursor(other), 6);
+	time_it("virtual call per element",
+			[&]
+			{
+				int* first = &*vec.begin();
+				vector_cursor cursor(first, first + vec.size());
+				return sum_cursor(cursor);
+			});
+	time_it("any_forward_iterator per element",
+			[&] { return sum_any(bmstu::any_range<int>(vec)); });
+	time_it("any_range::next_n, 256 per call",
+			[&] { return sum_batched(bmstu::any_range<int>(vec)); });
+}
@@ -0,0 +1,297 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace bmstu
+{
+// Runtime-polymorphic forward iterator over T, for interfaces that can't be
+// templates. Iterators of up to buffer_size bytes (every bmstu container
+// iterator) are stored inline, larger ones go to the heap. Each operation is
+// one indirect call, so prefer the concrete iterator (or next_n) in hot loops.
+template <typename T>
+class any_forward_iterator
+{
+   public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::remove_cv_t<T>;
+	using pointer = T*;
+	using reference = T&;
+	using difference_type = std::ptrdiff_t;
+
+	static constexpr size_t buffer_size = 32;
+
+	template <typename It>
+	static constexpr bool stored_inline =
+		sizeof(It) <= buffer_size && alignof(It) <= alignof(std::max_align_t) &&
+		std::is_nothrow_move_constructible_v<It>;
+
+	any_forward_iterator() noexcept = default;
+
+	template <typename It>
+		requires(!std::is_same_v<std::remove_cvref_t<It>,
+								 any_forward_iterator> &&
+				 std::convertible_to<std::iter_reference_t<It>, T&>)
+	any_forward_iterator(It it) : ops_(&ops_for<It>)
+	{
+		if constexpr (stored_inline<It>)
+		{
+			::new (static_cast<void*>(buffer_)) It(std::move(it));
+		}
+		else
+		{
+			set_heap_ptr(new It(std::move(it)));
+		}
+	}
+
+	any_forward_iterator(const any_forward_iterator& other) : ops_(other.ops_)
+	{
+		if (ops_ != nullptr)
+		{
+			ops_->copy(other, *this);
+		}
+	}
+
+	any_forward_iterator(any_forward_iterator&& other) noexcept
+		: ops_(other.ops_)
+	{
+		if (ops_ != nullptr)
+		{
+			ops_->move(other, *this);
+			other.ops_ = nullptr;
+		}
+	}
+
+	any_forward_iterator& operator=(const any_forward_iterator& other)
+	{
+		if (this != &other)
+		{
+			any_forward_iterator copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	any_forward_iterator& operator=(any_forward_iterator&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			ops_ = other.ops_;
+			if (ops_ != nullptr)
+			{
+				ops_->move(other, *this);
+				other.ops_ = nullptr;
+			}
+		}
+		return *this;
+	}
+
+	~any_forward_iterator() { reset(); }
+
+	T& operator*() const { return ops_->dereference(*this); }
+
+	T* operator->() const { return std::addressof(**this); }
+
+	any_forward_iterator& operator++()
+	{
+		ops_->increment(*this);
+		return *this;
+	}
+
+	any_forward_iterator operator++(int)
+	{
+		any_forward_iterator copy(*this);
+		ops_->increment(*this);
+		return copy;
+	}
+
+	// Iterators wrapping different types never compare equal
+	friend bool operator==(const any_forward_iterator& lhs,
+						   const any_forward_iterator& rhs)
+	{
+		if (lhs.ops_ != rhs.ops_)
+		{
+			return false;
+		}
+		return lhs.ops_ == nullptr || lhs.ops_->equal(lhs, rhs);
+	}
+
+	// Copies up to n elements into out and advances past them, stopping at
+	// last, which must wrap the same iterator type. One indirect call per
+	// batch instead of three per element.
+	size_t next_n(value_type* out, size_t n, const any_forward_iterator& last)
+		requires std::is_copy_assignable_v<value_type>
+	{
+		return ops_ == nullptr ? 0 : ops_->next_n(*this, last, out, n);
+	}
+
+   private:
+	struct ops_table
+	{
+		void (*copy)(const any_forward_iterator& from,
+					 any_forward_iterator& to);
+		void (*move)(any_forward_iterator& from,
+					 any_forward_iterator& to) noexcept;
+		void (*destroy)(any_forward_iterator& self) noexcept;
+		T& (*dereference)(const any_forward_iterator& self);
+		void (*increment)(any_forward_iterator& self);
+		bool (*equal)(const any_forward_iterator& lhs,
+					  const any_forward_iterator& rhs);
+		size_t (*next_n)(any_forward_iterator& self,
+						 const any_forward_iterator& last,
+						 value_type* out,
+						 size_t n);
+	};
+
+	template <typename It>
+	static It& get(any_forward_iterator& self) noexcept
+	{
+		if constexpr (stored_inline<It>)
+		{
+			return *std::launder(reinterpret_cast<It*>(self.buffer_));
+		}
+		else
+		{
+			return *static_cast<It*>(self.heap_ptr());
+		}
+	}
+
+	template <typename It>
+	static const It& get(const any_forward_iterator& self) noexcept
+	{
+		return get<It>(const_cast<any_forward_iterator&>(self));
+	}
+
+	template <typename It>
+	static constexpr ops_table ops_for = {
+		[](const any_forward_iterator& from, any_forward_iterator& to)
+		{
+			if constexpr (stored_inline<It>)
+			{
+				::new (static_cast<void*>(to.buffer_)) It(get<It>(from));
+			}
+			else
+			{
+				to.set_heap_ptr(new It(get<It>(from)));
+			}
+		},
+		[](any_forward_iterator& from, any_forward_iterator& to) noexcept
+		{
+			if constexpr (stored_inline<It>)
+			{
+				It& source = get<It>(from);
+				::new (static_cast<void*>(to.buffer_)) It(std::move(source));
+				std::destroy_at(std::addressof(source));
+			}
+			else
+			{
+				to.set_heap_ptr(from.heap_ptr());
+			}
+		},
+		[](any_forward_iterator& self) noexcept
+		{
+			if constexpr (stored_inline<It>)
+			{
+				std::destroy_at(std::addressof(get<It>(self)));
+			}
+			else
+			{
+				delete static_cast<It*>(self.heap_ptr());
+			}
+		},
+		[](const any_forward_iterator& self) -> T&
+		{ return *get<It>(self); },
+		[](any_forward_iterator& self) { ++get<It>(self); },
+		[](const any_forward_iterator& lhs, const any_forward_iterator& rhs)
+		{ return get<It>(lhs) == get<It>(rhs); },
+		[](any_forward_iterator& self,
+		   const any_forward_iterator& last,
+		   value_type* out,
+		   size_t n) -> size_t
+		{
+			if constexpr (std::is_copy_assignable_v<value_type>)
+			{
+				It& it = get<It>(self);
+				const It& end = get<It>(last);
+				size_t count = 0;
+				for (; count < n && !(it == end); ++count, ++it)
+				{
+					out[count] = *it;
+				}
+				return count;
+			}
+			else
+			{
+				return 0;
+			}
+		},
+	};
+
+	void reset() noexcept
+	{
+		if (ops_ != nullptr)
+		{
+			ops_->destroy(*this);
+			ops_ = nullptr;
+		}
+	}
+
+	// An out-of-line iterator is owned through a pointer kept in buffer_
+	void set_heap_ptr(void* ptr) noexcept
+	{
+		::new (static_cast<void*>(buffer_)) void*(ptr);
+	}
+
+	void* heap_ptr() const noexcept
+	{
+		return *std::launder(reinterpret_cast<void* const*>(buffer_));
+	}
+
+	alignas(std::max_align_t) unsigned char buffer_[buffer_size];
+	const ops_table* ops_ = nullptr;
+};
+
+// A pair of any_forward_iterator, e.g. for handing a container to a plugin
+template <typename T>
+class any_range
+{
+   public:
+	using iterator = any_forward_iterator<T>;
+	using value_type = typename iterator::value_type;
+
+	any_range() = default;
+
+	template <typename It>
+	any_range(It first, It last)
+		: first_(std::move(first)), last_(std::move(last))
+	{
+	}
+
+	template <typename Range>
+		requires(!std::is_same_v<std::remove_cvref_t<Range>, any_range>)
+	any_range(Range& range) : any_range(range.begin(), range.end())
+	{
+	}
+
+	iterator begin() const { return first_; }
+
+	iterator end() const { return last_; }
+
+	bool empty() const { return first_ == last_; }
+
+	// Pops up to n elements from the front into out, returns how many
+	size_t next_n(value_type* out, size_t n)
+	{
+		return first_.next_n(out, n, last_);
+	}
+
+   private:
+	iterator first_;
+	iterator last_;
+};
+}  // namespace bmstu
@@ -1,6 +1,11 @@
+#pragma once
+#include <algorithm>
+#include <compare>
 #include <cstddef>
+#include <initializer_list>
 #include <iterator>
 #include <ostream>
+#include <utility>
 #include "abstract_iterator.h"
 
 namespace bmstu
@@ -12,8 +17,11 @@ class list
 	{
 		node() = default;
 
-		node(node* prev, const T& value, node* next)
-			: next_node_(nullptr), prev_node_(nullptr)
+		template <typename Type>
+		node(node* prev, Type&& value, node* next)
+			: value_(std::forward<Type>(value)),
+			  next_node_(next),
+			  prev_node_(prev)
 		{
 		}
 
@@ -27,110 +35,87 @@ class list
 		: public abstract_iterator<iterator, T, std::bidirectional_iterator_tag>
 	{
 		node* current;
+
 		iterator() : current(nullptr) {}
+
 		iterator(node* node) : current(node) {}
-		iterator& operator++() override { return *this; }
-		iterator& operator--() override { return *this; }
-		iterator operator++(int) override { return nullptr; }
-		iterator operator--(int) override { return nullptr; }
-		iterator& operator+=(
-			const typename abstract_iterator<
-				iterator,
-				T,
-				std::bidirectional_iterator_tag>::difference_type& n) override
-		{
-			return *this;
-		}
-		iterator& operator-=(
-			const typename abstract_iterator<
-				iterator,
-				T,
-				std::bidirectional_iterator_tag>::difference_type& n) override
-		{
-			return *this;
-		}
-		iterator operator+(const typename abstract_iterator<
-						   iterator,
-						   T,
-						   std::bidirectional_iterator_tag>::difference_type& n)
-			const override
-		{
-			return nullptr;
-		}
-		iterator operator-(const typename abstract_iterator<
-						   iterator,
-						   T,
-						   std::bidirectional_iterator_tag>::difference_type& n)
-			const override
-		{
-			return nullptr;
-		}
-		typename abstract_iterator<iterator,
-								   T,
-								   std::bidirectional_iterator_tag>::reference
-		operator*() const override
-		{
-			return current->value_;
-		}
-		typename abstract_iterator<iterator,
-								   T,
-								   std::bidirectional_iterator_tag>::pointer
-		operator->() const override
-		{
-			return &(current->value_);
-		}
-		bool operator==(const iterator& other) const override
+
+		T& dereference() const { return current->value_; }
+
+		void increment() { current = current->next_node_; }
+
+		void decrement() { current = current->prev_node_; }
+
+		bool equal(const iterator& other) const
 		{
 			return current == other.current;
 		}
-		bool operator!=(const iterator& other) const override
-		{
-			return current != other.current;
-		}
-		explicit operator bool() const override { return current != nullptr; }
-		typename abstract_iterator<
-			iterator,
-			T,
-			std::bidirectional_iterator_tag>::difference_type
-		operator-(const iterator& other) const override
-		{
-			return 0;
-		}
+
+		bool is_valid() const { return current != nullptr; }
 	};
 	using const_iterator = iterator;
 
-	list() {}
+	list() : tail_(new node()), head_(new node())
+	{
+		head_->next_node_ = tail_;
+		tail_->prev_node_ = head_;
+	}
 
 	template <typename it>
-	list(it begin, it end)
+	list(it begin, it end) : list()
 	{
+		for (; begin != end; ++begin)
+		{
+			push_back(*begin);
+		}
 	}
 
-	list(std::initializer_list<T> values) {}
+	list(std::initializer_list<T> values) : list(values.begin(), values.end())
+	{
+	}
 
-	list(const list& other) {}
+	list(const list& other) : list(other.begin(), other.end()) {}
 
-	list(list&& other) {}
+	list(list&& other) : list() { swap(other); }
+
+	list& operator=(const list& other)
+	{
+		if (this != &other)
+		{
+			list copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	list& operator=(list&& other) noexcept
+	{
+		if (this != &other)
+		{
+			clear();
+			swap(other);
+		}
+		return *this;
+	}
 
-#pragma endregion
 #pragma region pushs
 
 	template <typename Type>
-	void push_back(const Type& value)
+	void push_back(Type&& value)
 	{
 		node* last = tail_->prev_node_;
-		node* new_last = new node(tail_->prev_node_, value, tail_);
+		node* new_last = new node(last, std::forward<Type>(value), tail_);
 		tail_->prev_node_ = new_last;
 		last->next_node_ = new_last;
 		++size_;
 	}
 
 	template <typename Type>
-	void push_front(const Type& value)
+	void push_front(Type&& value)
 	{
-		// адрес реального последнего элемента
+		// адрес реального первого элемента
 		node* first = head_->next_node_;
-		node* new_first = new node(head_, value, first);
+		node* new_first = new node(head_, std::forward<Type>(value), first);
 		head_->next_node_ = new_first;
 		first->prev_node_ = new_first;
 		++size_;
@@ -138,101 +123,120 @@ class list
 
 #pragma endregion
 
-	bool empty() const
+	bool empty() const noexcept { return (size_ == 0u); }
 
-		noexcept
+	~list()
 	{
-		return (size_ == 0u);
+		clear();
+		delete head_;
+		delete tail_;
 	}
 
-	~list() {}
-
-	void clear() {}
-
-	size_t size() const { return 0; }
+	void clear()
+	{
+		node* current = head_->next_node_;
+		while (current != tail_)
+		{
+			node* next = current->next_node_;
+			delete current;
+			current = next;
+		}
+		head_->next_node_ = tail_;
+		tail_->prev_node_ = head_;
+		size_ = 0;
+	}
 
-	void swap(list& other)
+	size_t size() const { return size_; }
 
-		noexcept
+	void swap(list& other) noexcept
 	{
+		std::swap(size_, other.size_);
+		std::swap(tail_, other.tail_);
+		std::swap(head_, other.head_);
 	}
 
 	friend void swap(list& l, list& r) { l.swap(r); }
 
 #pragma region iterators
 
-	iterator begin()
-
-		noexcept
-	{
-		return iterator{head_->next_node_};
-	}
+	iterator begin() noexcept { return iterator{head_->next_node_}; }
 
-	iterator end()
+	iterator end() noexcept { return iterator{tail_}; }
 
-		noexcept
+	const_iterator begin() const noexcept
 	{
-		return iterator{tail_};
+		return const_iterator{head_->next_node_};
 	}
 
-	const_iterator begin() const
+	const_iterator end() const noexcept { return const_iterator{tail_}; }
 
-		noexcept
+	const_iterator cbegin() const noexcept
 	{
 		return const_iterator{head_->next_node_};
 	}
 
-	const_iterator end() const
+	const_iterator cend() const noexcept { return const_iterator{tail_}; }
 
-		noexcept
-	{
-		return const_iterator{tail_};
-	}
+#pragma endregion
+
+	T operator[](size_t pos) const { return *(begin() + pos); }
 
-	const_iterator cbegin() const
+	T& operator[](size_t pos) { return *(begin() + pos); }
 
-		noexcept
+	friend bool operator==(const list& l, const list& r)
 	{
-		return const_iterator{head_->next_node_};
+		return l.size_ == r.size_ && std::equal(l.begin(), l.end(), r.begin());
 	}
 
-	const_iterator cend() const
+	friend bool operator!=(const list& l, const list& r) { return !(l == r); }
 
-		noexcept
+	friend auto operator<=>(const list& lhs, const list& rhs)
 	{
-		return const_iterator{tail_};
+		if (lexicographical_compare_(lhs, rhs))
+		{
+			return std::weak_ordering::less;
+		}
+		if (lexicographical_compare_(rhs, lhs))
+		{
+			return std::weak_ordering::greater;
+		}
+		return std::weak_ordering::equivalent;
 	}
 
-#pragma endregion
-
-	T operator[](size_t pos) const {}
-
-	T& operator[](size_t pos) { return *(static_cast<T*>((void*)&pos)); }
-
-	friend bool operator==(const list& l, const list& r) { return true; }
-
-	friend bool operator!=(const list& l, const list& r) { return false; }
-
-	friend auto operator<=>(const list& lhs, const list& rhs) { return true; }
-
 	friend std::ostream& operator<<(std::ostream& os, const list& other)
 	{
-		return os;
+		os << "{";
+		for (auto it = other.begin(); it != other.end(); ++it)
+		{
+			if (it != other.begin())
+			{
+				os << ", ";
+			}
+			os << *it;
+		}
+		return os << "}";
 	}
 
 	iterator insert(const_iterator pos, const T& value)
 	{
-		return iterator{nullptr};
+		node* next = pos.current;
+		node* prev = next->prev_node_;
+		node* inserted = new node(prev, value, next);
+		prev->next_node_ = inserted;
+		next->prev_node_ = inserted;
+		++size_;
+		return iterator{inserted};
 	}
 
    private:
 	static bool lexicographical_compare_(const list<T>& l, const list<T>& r)
 	{
-		return "123";
+		return std::lexicographical_compare(l.begin(), l.end(), r.begin(),
+											r.end());
 	}
 
 	size_t size_ = 0;
 	node* tail_ = nullptr;
 	node* head_ = nullptr;
 };
-}  // namespace bmstu
\ No newline at end of file
+}  // namespace bmstu
@@ -1,3 +1,4 @@
+#pragma once
 /*
  * ЗАДАНИЕ: Реализация std::map на основе AVL-дерева
  *
@@ -19,7 +20,7 @@
  *    - Конструктор для инициализации (найти самый левый узел для begin)
  *    - operator*() - разыменование (вернуть std::pair<const K, V>)
  *    - operator++() - переход к следующему элементу в in-order обходе
- *    - Использовать std::stack для обхода дерева
+ *    - Переход к соседнему узлу по указателям parent, без std::stack
  *
  * 3. Map (map):
  *    - Все публичные методы уже реализованы и используют AVL дерево
@@ -35,12 +36,13 @@
  * - Все 18 тестов должны пройти успешно после полной реализации
  */
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <iterator>
-#include <stack>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include "abstract_iterator.h"
 
@@ -50,36 +52,40 @@ namespace bmstu
 template <typename K, typename V>
 struct tree_node
 {
-	tree_node(const K& k, const V& v)
-		: key(k), value(v), left(nullptr), right(nullptr), height(1)
-	{
-	}
-
-	K key;
-	V value;
-	uint8_t height;
-	tree_node* left;
-	tree_node* right;
+	tree_node(const K& k, const V& v) : data(k, v) {}
+
+	std::pair<const K, V> data;
+	uint8_t height = 1;
+	tree_node* left = nullptr;
+	tree_node* right = nullptr;
+	// lets an iterator step to the in-order neighbour without a stack
+	tree_node* parent = nullptr;
 };
 
 // ==================== AVL Balanced Tree ====================
-// ЗАДАНИЕ ДЛЯ СТУДЕНТОВ:
-// Реализуйте самобалансирующееся AVL-дерево с поддержкой вставки, удаления и
-// поиска по ключам. Дерево должно автоматически балансироваться после каждой
-// операции.
 template <typename K, typename V>
 class avl_balanced_tree
 {
    public:
 	avl_balanced_tree() : root_(nullptr), size_(0) {}
+	avl_balanced_tree(const avl_balanced_tree&) = delete;
+	avl_balanced_tree& operator=(const avl_balanced_tree&) = delete;
 	~avl_balanced_tree() { clear(root_); }
 
 	void insert(const K& key, const V& value)
 	{
 		this->insert(key, value, root_);
+		root_->parent = nullptr;
 	}
 
-	void remove(const K& key) { this->remove(key, root_); }
+	void remove(const K& key)
+	{
+		this->remove(key, root_);
+		if (root_ != nullptr)
+		{
+			root_->parent = nullptr;
+		}
+	}
 
 	tree_node<K, V>* find(const K& key) { return this->find(key, root_); }
 
@@ -106,88 +112,235 @@ class avl_balanced_tree
 		std::cout << "\n";
 	}
 
+	// Node is tree_node<K, V> or const tree_node<K, V>
+	template <typename Node>
+	static Node* findMinPtr(Node* node)
+	{
+		while (node != nullptr && node->left != nullptr)
+		{
+			node = node->left;
+		}
+		return node;
+	}
+
+	template <typename Node>
+	static Node* findMaxPtr(Node* node)
+	{
+		while (node != nullptr && node->right != nullptr)
+		{
+			node = node->right;
+		}
+		return node;
+	}
+
+	// In-order neighbours, nullptr past either end
+	template <typename Node>
+	static Node* next(Node* node)
+	{
+		if (node->right != nullptr)
+		{
+			return findMinPtr(node->right);
+		}
+		while (node->parent != nullptr && node->parent->right == node)
+		{
+			node = node->parent;
+		}
+		return node->parent;
+	}
+
+	template <typename Node>
+	static Node* prev(Node* node)
+	{
+		if (node->left != nullptr)
+		{
+			return findMaxPtr(node->left);
+		}
+		while (node->parent != nullptr && node->parent->left == node)
+		{
+			node = node->parent;
+		}
+		return node->parent;
+	}
+
    private:
-	tree_node<K, V>* insert(const K& key,
-							const V& value,
-							tree_node<K, V>*& node)
-	{
-		// TODO: Реализовать вставку узла в AVL дерево
-		// 1. Если node == nullptr, создать новый узел
-		// 2. Рекурсивно вставить в левое или правое поддерево в зависимости от
-		// ключа
-		// 3. Обновить значение, если ключ уже существует
-		// 4. Вызвать balance(node) для балансировки
-		return nullptr;
+	void insert(const K& key, const V& value, tree_node<K, V>*& node)
+	{
+		if (node == nullptr)
+		{
+			node = new tree_node<K, V>(key, value);
+			++size_;
+			return;
+		}
+		if (key < node->data.first)
+		{
+			insert(key, value, node->left);
+		}
+		else if (node->data.first < key)
+		{
+			insert(key, value, node->right);
+		}
+		else
+		{
+			node->data.second = value;
+			return;
+		}
+		balance(node);
 	}
 
 	void remove(const K& key, tree_node<K, V>*& node)
 	{
-		// TODO: Реализовать удаление узла из AVL дерева
-		// 1. Найти узел с заданным ключом
-		// 2. Обработать 4 случая:
-		//    - Узел без детей (лист)
-		//    - Узел с одним ребенком (левым или правым)
-		//    - Узел с двумя детьми (заменить на минимальный из правого
-		//    поддерева)
-		// 3. Декрементировать size_
-		// 4. Вызвать balance(node) для балансировки
+		if (node == nullptr)
+		{
+			return;
+		}
+		if (key < node->data.first)
+		{
+			remove(key, node->left);
+		}
+		else if (node->data.first < key)
+		{
+			remove(key, node->right);
+		}
+		else
+		{
+			tree_node<K, V>* removed = node;
+			if (node->left == nullptr || node->right == nullptr)
+			{
+				node = node->left != nullptr ? node->left : node->right;
+			}
+			else
+			{
+				// the key is const, so the successor node takes the place
+				// of the removed one instead of having its data copied
+				tree_node<K, V>* successor = detachMin(node->right);
+				successor->left = node->left;
+				successor->right = node->right;
+				node = successor;
+			}
+			delete removed;
+			--size_;
+			if (node == nullptr)
+			{
+				return;
+			}
+		}
+		balance(node);
+	}
+
+	tree_node<K, V>* detachMin(tree_node<K, V>*& node)
+	{
+		if (node->left == nullptr)
+		{
+			tree_node<K, V>* min = node;
+			node = node->right;
+			return min;
+		}
+		tree_node<K, V>* min = detachMin(node->left);
+		balance(node);
+		return min;
 	}
 
 	tree_node<K, V>* find(const K& key, tree_node<K, V>* node) const
 	{
-		// TODO: Реализовать поиск узла по ключу
-		// Рекурсивно искать в левом или правом поддереве
+		while (node != nullptr)
+		{
+			if (key < node->data.first)
+			{
+				node = node->left;
+			}
+			else if (node->data.first < key)
+			{
+				node = node->right;
+			}
+			else
+			{
+				return node;
+			}
+		}
 		return nullptr;
 	}
 
-	tree_node<K, V>* findMinPtr(tree_node<K, V>* node)
+	static uint8_t heightOfTree(tree_node<K, V>* t)
 	{
-		// TODO: Найти узел с минимальным ключом в поддереве
-		// Подсказка: идти влево, пока возможно
-		return nullptr;
+		return t == nullptr ? 0 : t->height;
 	}
 
-	uint8_t heightOfTree(tree_node<K, V>* t)
+	// Recomputes the height of t and points its children back at it
+	static void update(tree_node<K, V>* t)
 	{
-		// TODO: Вычислить высоту дерева
-		// Высота пустого дерева = 0
-		// Высота дерева = 1 + max(высота левого, высота правого)
-		return 0;
+		t->height =
+			1 + std::max(heightOfTree(t->left), heightOfTree(t->right));
+		if (t->left != nullptr)
+		{
+			t->left->parent = t;
+		}
+		if (t->right != nullptr)
+		{
+			t->right->parent = t;
+		}
 	}
 
 	void rotateWithLeftChild(tree_node<K, V>*& k2)
 	{
-		// TODO: Реализовать правый поворот (rotation with left child)
-		// Используется для балансировки Left-Left случая
+		tree_node<K, V>* k1 = k2->left;
+		k2->left = k1->right;
+		k1->right = k2;
+		update(k2);
+		update(k1);
+		k2 = k1;
 	}
 
 	void rotateWithRightChild(tree_node<K, V>*& k1)
 	{
-		// TODO: Реализовать левый поворот (rotation with right child)
-		// Используется для балансировки Right-Right случая
+		tree_node<K, V>* k2 = k1->right;
+		k1->right = k2->left;
+		k2->left = k1;
+		update(k1);
+		update(k2);
+		k1 = k2;
 	}
 
 	void doubleWithLeftChild(tree_node<K, V>*& k3)
 	{
-		// TODO: Реализовать двойной поворот Left-Right
-		// Сначала левый поворот на левом ребенке, затем правый поворот на узле
+		rotateWithRightChild(k3->left);
+		rotateWithLeftChild(k3);
 	}
 
 	void doubleWithRightChild(tree_node<K, V>*& k1)
 	{
-		// TODO: Реализовать двойной поворот Right-Left
-		// Сначала правый поворот на правом ребенке, затем левый поворот на узле
+		rotateWithLeftChild(k1->right);
+		rotateWithRightChild(k1);
 	}
 
 	void balance(tree_node<K, V>*& t)
 	{
-		// TODO: Реализовать балансировку AVL дерева
-		// 1. Вычислить разность высот левого и правого поддеревьев
-		// 2. Если разность > 1, выполнить соответствующие повороты:
-		//    - Left-Left: rotateWithLeftChild
-		//    - Left-Right: doubleWithLeftChild
-		//    - Right-Right: rotateWithRightChild
-		//    - Right-Left: doubleWithRightChild
+		const int diff = heightOfTree(t->left) - heightOfTree(t->right);
+		if (diff > 1)
+		{
+			if (heightOfTree(t->left->left) >= heightOfTree(t->left->right))
+			{
+				rotateWithLeftChild(t);
+			}
+			else
+			{
+				doubleWithLeftChild(t);
+			}
+		}
+		else if (diff < -1)
+		{
+			if (heightOfTree(t->right->right) >= heightOfTree(t->right->left))
+			{
+				rotateWithRightChild(t);
+			}
+			else
+			{
+				doubleWithRightChild(t);
+			}
+		}
+		else
+		{
+			update(t);
+		}
 	}
 
 	void inorder_print(tree_node<K, V>* node)
@@ -197,7 +350,8 @@ class avl_balanced_tree
 			return;
 		}
 		inorder_print(node->left);
-		std::cout << "[" << node->key << ":" << node->value << "] ";
+		std::cout << "[" << node->data.first << ":" << node->data.second
+				  << "] ";
 		inorder_print(node->right);
 	}
 
@@ -223,7 +377,7 @@ class avl_balanced_tree
 		{
 			std::cout << " ";
 		}
-		std::cout << node->key << ":" << node->value << "\n";
+		std::cout << node->data.first << ":" << node->data.second << "\n";
 		this->print_tree_(node->left, space);
 	}
 
@@ -232,10 +386,6 @@ class avl_balanced_tree
 };
 
 // ==================== Map Class ====================
-// ЗАДАНИЕ ДЛЯ СТУДЕНТОВ:
-// Используя реализованное AVL-дерево, создайте полноценный аналог std::map
-// с поддержкой вставки, удаления, поиска и итерации по элементам в порядке
-// возрастания ключей.
 template <typename K, typename V>
 class map
 {
@@ -245,114 +395,62 @@ class map
 	using value_type = std::pair<const K, V>;
 
 	// ==================== Iterator ====================
-	// ЗАДАНИЕ ДЛЯ СТУДЕНТОВ:
-	// Реализуйте итератор для обхода элементов map в порядке возрастания ключей
-	// (in-order обход AVL дерева). Итератор должен поддерживать операции
-	// инкремента и разыменования.
-	struct iterator : public abstract_iterator<iterator,
-											   std::pair<const K, V>,
-											   std::bidirectional_iterator_tag>
+	// In-order walk over the parent links. end() is a null node, the tree
+	// pointer lets --end() find the last element. Type is value_type or
+	// const value_type; the node and tree pointers carry the same const.
+	template <typename Type>
+	struct basic_iterator
+		: public abstract_iterator<basic_iterator<Type>,
+								   Type,
+								   std::bidirectional_iterator_tag>
 	{
-		tree_node<K, V>* current_;
-		std::stack<tree_node<K, V>*> stack_;
-		mutable typename iterator::value_type pair_cache_;
-
-		iterator() : current_(nullptr), pair_cache_(K{}, V{}) {}
-
-		explicit iterator(tree_node<K, V>* root, bool is_end = false)
-			: current_(nullptr), pair_cache_(K{}, V{})
-		{
-			// TODO: Реализовать инициализацию итератора
-			// Для begin(): нужно найти самый левый узел
-			// Для end(): current_ должен остаться nullptr
-		}
-
-		typename iterator::reference operator*() const override
-		{
-			// TODO: Реализовать разыменование
-			// Нужно вернуть std::pair<const K, V> с текущим ключом и значением
-			return pair_cache_;
-		}
+		static constexpr bool is_const = std::is_const_v<Type>;
+		using node_type = std::conditional_t<is_const,
+											 const tree_node<K, V>,
+											 tree_node<K, V>>;
+		using tree_type = std::conditional_t<is_const,
+											 const avl_balanced_tree<K, V>,
+											 avl_balanced_tree<K, V>>;
 
-		typename iterator::pointer operator->() const override
-		{
-			// TODO: Реализовать оператор стрелки
-			return &pair_cache_;
-		}
+		node_type* current_ = nullptr;
+		tree_type* tree_ = nullptr;
 
-		iterator& operator++() override
-		{
-			// TODO: Реализовать переход к следующему элементу (in-order)
-			// Подсказка: используйте стек для обхода дерева
-			return *this;
-		}
+		basic_iterator() = default;
 
-		iterator operator++(int) override
+		basic_iterator(node_type* node, tree_type* tree)
+			: current_(node), tree_(tree)
 		{
-			iterator temp = *this;
-			++(*this);
-			return temp;
 		}
 
-		iterator& operator--() override
+		// iterator -> const_iterator
+		template <typename Other>
+			requires(is_const && std::is_same_v<Other, value_type>)
+		basic_iterator(const basic_iterator<Other>& other)
+			: current_(other.current_), tree_(other.tree_)
 		{
-			// Необязательно для bidirectional_iterator в этой реализации
-			return *this;
 		}
 
-		iterator operator--(int) override
-		{
-			// Необязательно для bidirectional_iterator в этой реализации
-			return *this;
-		}
+		Type& dereference() const { return current_->data; }
 
-		iterator& operator+=(
-			const typename iterator::difference_type& n) override
-		{
-			// Не требуется для bidirectional_iterator
-			return *this;
-		}
-
-		iterator& operator-=(
-			const typename iterator::difference_type& n) override
-		{
-			// Не требуется для bidirectional_iterator
-			return *this;
-		}
-
-		iterator operator+(
-			const typename iterator::difference_type& n) const override
-		{
-			// Не требуется для bidirectional_iterator
-			return *this;
-		}
+		void increment() { current_ = avl_balanced_tree<K, V>::next(current_); }
 
-		iterator operator-(
-			const typename iterator::difference_type& n) const override
+		void decrement()
 		{
-			// Не требуется для bidirectional_iterator
-			return *this;
+			current_ = current_ == nullptr
+						   ? avl_balanced_tree<K, V>::findMaxPtr(
+								 tree_->get_root())
+						   : avl_balanced_tree<K, V>::prev(current_);
 		}
 
-		bool operator==(const iterator& other) const override
+		bool equal(const basic_iterator& other) const
 		{
 			return current_ == other.current_;
 		}
 
-		bool operator!=(const iterator& other) const override
-		{
-			return current_ != other.current_;
-		}
-
-		explicit operator bool() const override { return current_ != nullptr; }
-
-		typename iterator::difference_type operator-(
-			const iterator& other) const override
-		{
-			// Не требуется точное вычисление для bidirectional_iterator
-			return 0;
-		}
+		bool is_valid() const { return current_ != nullptr; }
 	};
+	using iterator = basic_iterator<value_type>;
+	using const_iterator = basic_iterator<const value_type>;
 
 	map() = default;
 	~map() = default;
@@ -372,19 +470,19 @@ class map
 			tree_.insert(key, V());
 			node = tree_.find(key);
 		}
-		return node->value;
+		return node->data.second;
 	}
 
 	V* find(const K& key)
 	{
 		auto node = tree_.find(key);
-		return node ? &node->value : nullptr;
+		return node ? &node->data.second : nullptr;
 	}
 
 	const V* find(const K& key) const
 	{
 		auto node = tree_.find(key);
-		return node ? &node->value : nullptr;
+		return node ? &node->data.second : nullptr;
 	}
 
 	V& at(const K& key)
@@ -394,7 +492,7 @@ class map
 		{
 			throw std::out_of_range("Key not found in map");
 		}
-		return node->value;
+		return node->data.second;
 	}
 
 	const V& at(const K& key) const
@@ -404,7 +502,7 @@ class map
 		{
 			throw std::out_of_range("Key not found in map");
 		}
-		return node->value;
+		return node->data.second;
 	}
 
 	// Удаление
@@ -430,9 +528,21 @@ class map
 	void inorder_print() { tree_.inorder_print(); }
 
 	// Итераторы
-	iterator begin() { return iterator(tree_.get_root(), false); }
+	iterator begin()
+	{
+		return iterator(avl_balanced_tree<K, V>::findMinPtr(tree_.get_root()),
+						&tree_);
+	}
+
+	iterator end() { return iterator(nullptr, &tree_); }
+
+	const_iterator begin() const
+	{
+		return const_iterator(
+			avl_balanced_tree<K, V>::findMinPtr(tree_.get_root()), &tree_);
+	}
 
-	iterator end() { return iterator(tree_.get_root(), true); }
+	const_iterator end() const { return const_iterator(nullptr, &tree_); }
 
    private:
 	avl_balanced_tree<K, V> tree_;
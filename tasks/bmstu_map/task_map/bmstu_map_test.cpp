@@ -2,7 +2,9 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <iterator>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 TEST(MapTest, BasicInsertAndAccess)
@@ -348,4 +350,83 @@ TEST(MapTest, RangeBasedForDemo)
 
 	EXPECT_EQ(catalog.size(), 5);
 	EXPECT_EQ(catalog["apple"], "fruit");
-}
\ No newline at end of file
+}
+TEST(MapTest, IteratorDecrement)
+{
+	bmstu::map<int, int> map;
+	for (int i = 0; i < 50; ++i)
+	{
+		map[(i * 7) % 50] = i;
+	}
+	int expected_key = 49;
+	auto it = map.end();
+	while (it != map.begin())
+	{
+		--it;
+		EXPECT_EQ(it->first, expected_key--);
+	}
+	EXPECT_EQ(expected_key, -1);
+}
+
+TEST(MapTest, ConstIterator)
+{
+	using int_map = bmstu::map<int, int>;
+	static_assert(std::bidirectional_iterator<int_map::const_iterator>);
+	static_assert(std::is_same_v<decltype(*std::declval<const int_map&>()
+											  .begin()),
+								 const std::pair<const int, int>&>);
+	static_assert(
+		std::is_convertible_v<int_map::iterator, int_map::const_iterator>);
+	static_assert(
+		!std::is_convertible_v<int_map::const_iterator, int_map::iterator>);
+
+	int_map map;
+	for (int i = 0; i < 10; ++i)
+	{
+		map[i] = i * i;
+	}
+	const int_map& view = map;
+	int_map::const_iterator it = map.begin();
+	EXPECT_EQ(it, view.begin());
+	int expected_key = 10;
+	for (auto back = view.end(); back != view.begin();)
+	{
+		--back;
+		--expected_key;
+		EXPECT_EQ(back->first, expected_key);
+		EXPECT_EQ(back->second, expected_key * expected_key);
+	}
+	EXPECT_EQ(expected_key, 0);
+}
+
+TEST(MapTest, InsertEraseKeepsOrder)
+{
+	bmstu::map<int, int> map;
+	std::vector<int> present(1000, 0);
+	unsigned state = 12345;
+	for (int step = 0; step < 5000; ++step)
+	{
+		state = state * 1103515245u + 12345u;
+		const int key = static_cast<int>((state >> 8) % 1000);
+		if (step % 3 == 0)
+		{
+			map.erase(key);
+			present[key] = 0;
+		}
+		else
+		{
+			map[key] = key;
+			present[key] = 1;
+		}
+	}
+	std::vector<int> keys;
+	for (const auto& [key, value] : map)
+	{
+		EXPECT_EQ(key, value);
+		keys.push_back(key);
+	}
+	EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+	EXPECT_EQ(keys.size(), map.size());
+	EXPECT_EQ(static_cast<int>(map.size()),
+			  std::count(present.begin(), present.end(), 1));
+}
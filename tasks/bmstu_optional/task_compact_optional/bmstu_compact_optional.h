@@ -0,0 +1,258 @@
+#pragma once
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "bmstu_optional.h"
+
+namespace bmstu
+{
+// A policy tells compact_optional which value of T means "empty":
+//   static T empty_value();
+//   static bool is_empty(const T& value);
+// The sentinel itself can't be stored as an engaged value.
+
+// One particular quiet NaN, compared bit by bit, so ordinary NaNs can still
+// be stored
+template <std::floating_point T>
+struct nan_policy
+{
+	using bits_type = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+	static_assert(sizeof(T) == sizeof(bits_type),
+				  "nan_policy supports float and double");
+
+	static constexpr bits_type empty_bits =
+		sizeof(T) == 4 ? bits_type(0x7fc0dead)
+					   : bits_type(0x7ff8deadbeefdeadull);
+
+	static constexpr T empty_value() noexcept
+	{
+		return std::bit_cast<T>(empty_bits);
+	}
+
+	static constexpr bool is_empty(const T& value) noexcept
+	{
+		return std::bit_cast<bits_type>(value) == empty_bits;
+	}
+};
+
+template <typename T>
+	requires std::is_pointer_v<T>
+struct nullptr_policy
+{
+	static constexpr T empty_value() noexcept { return nullptr; }
+
+	static constexpr bool is_empty(const T& value) noexcept
+	{
+		return value == nullptr;
+	}
+};
+
+template <typename T, T Sentinel>
+struct sentinel_policy
+{
+	static constexpr T empty_value() noexcept { return Sentinel; }
+
+	static constexpr bool is_empty(const T& value) noexcept
+	{
+		return value == Sentinel;
+	}
+};
+
+// Floating point and pointers get a policy for free, a class can provide its
+// own through a nested compact_policy (see basic_string)
+template <typename T>
+struct default_compact_policy;
+
+template <std::floating_point T>
+struct default_compact_policy<T> : nan_policy<T>
+{
+};
+
+template <typename T>
+struct default_compact_policy<T*> : nullptr_policy<T*>
+{
+};
+
+template <typename T>
+	requires requires { typename T::compact_policy; }
+struct default_compact_policy<T> : T::compact_policy
+{
+};
+
+// Same interface as optional<T>, but emptiness is encoded inside T, so
+// sizeof(compact_optional<T>) == sizeof(T). The T object is always alive:
+// a disengaged compact_optional holds Policy::empty_value().
+template <typename T, typename Policy = default_compact_policy<T>>
+class compact_optional
+{
+   public:
+	using value_type = T;
+	using policy_type = Policy;
+
+	constexpr compact_optional() noexcept(
+		std::is_nothrow_move_constructible_v<T>)
+		: value_(Policy::empty_value())
+	{
+	}
+
+	constexpr compact_optional(nullopt_t) noexcept(
+		std::is_nothrow_move_constructible_v<T>)
+		: compact_optional()
+	{
+	}
+
+	// Copying the bits of a trivially copyable T copies the sentinel too.
+	// Anything else may not know about its sentinel (basic_string would
+	// copy 255 characters out of its small buffer), so an empty one is
+	// rebuilt from the policy instead of copied or moved.
+	constexpr compact_optional(const compact_optional& other)
+		requires std::is_trivially_copyable_v<T>
+	= default;
+
+	constexpr compact_optional(const compact_optional& other)
+		requires(!std::is_trivially_copyable_v<T>)
+		: value_(Policy::is_empty(other.value_) ? Policy::empty_value()
+												: T(other.value_))
+	{
+	}
+
+	constexpr compact_optional(compact_optional&& other) noexcept
+		requires std::is_trivially_copyable_v<T>
+	= default;
+
+	// A moved-from empty one stays empty; an engaged one keeps its
+	// moved-from T, like optional
+	constexpr compact_optional(compact_optional&& other) noexcept(
+		std::is_nothrow_move_constructible_v<T>)
+		requires(!std::is_trivially_copyable_v<T>)
+		: value_(Policy::is_empty(other.value_) ? Policy::empty_value()
+												: T(std::move(other.value_)))
+	{
+	}
+
+	constexpr compact_optional(const T& value) : value_(value) {}
+
+	constexpr compact_optional(T&& value) : value_(std::move(value)) {}
+
+	constexpr compact_optional& operator=(const compact_optional& other)
+		requires std::is_trivially_copyable_v<T>
+	= default;
+
+	constexpr compact_optional& operator=(const compact_optional& other)
+		requires(!std::is_trivially_copyable_v<T>)
+	{
+		if (Policy::is_empty(other.value_))
+		{
+			reset();
+		}
+		else if (this != &other)
+		{
+			value_ = other.value_;
+		}
+		return *this;
+	}
+
+	constexpr compact_optional& operator=(compact_optional&& other) noexcept
+		requires std::is_trivially_copyable_v<T>
+	= default;
+
+	constexpr compact_optional& operator=(compact_optional&& other)
+		requires(!std::is_trivially_copyable_v<T>)
+	{
+		if (Policy::is_empty(other.value_))
+		{
+			reset();
+		}
+		else if (this != &other)
+		{
+			value_ = std::move(other.value_);
+		}
+		return *this;
+	}
+
+	constexpr compact_optional& operator=(nullopt_t)
+	{
+		reset();
+		return *this;
+	}
+
+	constexpr compact_optional& operator=(const T& value)
+	{
+		value_ = value;
+		return *this;
+	}
+
+	constexpr compact_optional& operator=(T&& value)
+	{
+		value_ = std::move(value);
+		return *this;
+	}
+
+	constexpr T& operator*() & { return value_; }
+
+	constexpr const T& operator*() const& { return value_; }
+
+	constexpr T&& operator*() && { return std::move(value_); }
+
+	constexpr const T&& operator*() const&& { return std::move(value_); }
+
+	constexpr T* operator->() { return std::addressof(value_); }
+
+	constexpr const T* operator->() const { return std::addressof(value_); }
+
+	constexpr T& value() &
+	{
+		check();
+		return value_;
+	}
+
+	constexpr const T& value() const&
+	{
+		check();
+		return value_;
+	}
+
+	constexpr T&& value() &&
+	{
+		check();
+		return std::move(value_);
+	}
+
+	constexpr const T&& value() const&&
+	{
+		check();
+		return std::move(value_);
+	}
+
+	template <typename... Args>
+	constexpr T& emplace(Args&&... args)
+	{
+		value_ = T(std::forward<Args>(args)...);
+		return value_;
+	}
+
+	constexpr void reset() { value_ = Policy::empty_value(); }
+
+	constexpr bool has_value() const noexcept
+	{
+		return !Policy::is_empty(value_);
+	}
+
+	constexpr explicit operator bool() const noexcept { return has_value(); }
+
+   private:
+	constexpr void check() const
+	{
+		if (!has_value())
+		{
+			throw bad_optional_access();
+		}
+	}
+
+	T value_;
+};
+}  // namespace bmstu
@@ -0,0 +1,206 @@
+#include "bmstu_compact_optional.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include "bmstu_optional.h"
+#include "bmstu_simple_vector.h"
+#include "bmstu_sso_string.h"
+
+static_assert(sizeof(bmstu::compact_optional<double>) == sizeof(double));
+static_assert(sizeof(bmstu::compact_optional<float>) == sizeof(float));
+static_assert(sizeof(bmstu::compact_optional<int*>) == sizeof(int*));
+static_assert(sizeof(bmstu::compact_optional<
+					 int, bmstu::sentinel_policy<int, -1>>) == sizeof(int));
+static_assert(sizeof(bmstu::compact_optional<bmstu::string>) ==
+			  sizeof(bmstu::string));
+static_assert(sizeof(bmstu::compact_optional<double>) <
+			  sizeof(bmstu::optional<double>));
+static_assert(std::is_trivially_copyable_v<bmstu::compact_optional<double>>);
+static_assert(std::is_trivially_copyable_v<bmstu::compact_optional<int*>>);
+
+TEST(CompactOptionalTest, DoubleDefault)
+{
+	bmstu::compact_optional<double> opt;
+	ASSERT_FALSE(opt.has_value());
+	ASSERT_FALSE(opt);
+	ASSERT_THROW(opt.value(), bmstu::bad_optional_access);
+	opt = 3.5;
+	ASSERT_TRUE(opt.has_value());
+	ASSERT_EQ(*opt, 3.5);
+	ASSERT_EQ(opt.value(), 3.5);
+	opt = bmstu::nullopt;
+	ASSERT_FALSE(opt.has_value());
+}
+
+TEST(CompactOptionalTest, DoubleKeepsOrdinaryNaN)
+{
+	bmstu::compact_optional<double> opt(
+		std::numeric_limits<double>::quiet_NaN());
+	ASSERT_TRUE(opt.has_value());
+	ASSERT_TRUE(std::isnan(*opt));
+	opt = -std::numeric_limits<double>::infinity();
+	ASSERT_TRUE(opt.has_value());
+
+	bmstu::compact_optional<float> small(bmstu::nullopt);
+	ASSERT_FALSE(small.has_value());
+	small.emplace(std::nanf(""));
+	ASSERT_TRUE(small.has_value());
+}
+
+TEST(CompactOptionalTest, Constexpr)
+{
+	constexpr bmstu::compact_optional<double> empty;
+	constexpr bmstu::compact_optional<double> engaged(1.0);
+	static_assert(!empty.has_value());
+	static_assert(engaged.has_value() && *engaged == 1.0);
+	SUCCEED();
+}
+
+TEST(CompactOptionalTest, Pointer)
+{
+	int value = 42;
+	bmstu::compact_optional<int*> opt;
+	ASSERT_FALSE(opt.has_value());
+	opt = &value;
+	ASSERT_TRUE(opt.has_value());
+	ASSERT_EQ(**opt, 42);
+	opt.reset();
+	ASSERT_FALSE(opt.has_value());
+	ASSERT_THROW(opt.value(), bmstu::bad_optional_access);
+}
+
+TEST(CompactOptionalTest, Sentinel)
+{
+	using index_optional =
+		bmstu::compact_optional<int, bmstu::sentinel_policy<int, -1>>;
+	index_optional opt;
+	ASSERT_FALSE(opt.has_value());
+	opt = 0;
+	ASSERT_TRUE(opt.has_value());
+	ASSERT_EQ(opt.value(), 0);
+	ASSERT_EQ(opt.emplace(7), 7);
+	ASSERT_EQ(*opt, 7);
+	// the sentinel itself reads back as empty
+	opt = -1;
+	ASSERT_FALSE(opt.has_value());
+}
+
+TEST(CompactOptionalTest, String)
+{
+	bmstu::compact_optional<bmstu::string> opt;
+	ASSERT_FALSE(opt.has_value());
+	ASSERT_THROW(opt.value(), bmstu::bad_optional_access);
+
+	opt = bmstu::string();
+	ASSERT_TRUE(opt.has_value());
+	ASSERT_EQ(opt->size(), 0u);
+
+	opt = bmstu::string("short");
+	ASSERT_TRUE(opt.has_value());
+	ASSERT_STREQ(opt->c_str(), "short");
+
+	opt.emplace("a string that is too long for the small buffer");
+	ASSERT_TRUE(opt.has_value());
+	ASSERT_STREQ(opt.value().c_str(),
+				 "a string that is too long for the small buffer");
+
+	bmstu::compact_optional<bmstu::string> copy(*opt);
+	ASSERT_TRUE(copy.has_value());
+	ASSERT_STREQ(copy->c_str(), opt->c_str());
+
+	opt.reset();
+	ASSERT_FALSE(opt.has_value());
+	bmstu::string moved = std::move(*copy);
+	ASSERT_STREQ(moved.c_str(),
+				 "a string that is too long for the small buffer");
+}
+
+TEST(CompactOptionalTest, EmptyStringCopyAndMove)
+{
+	const bmstu::compact_optional<bmstu::string> empty;
+	bmstu::compact_optional<bmstu::string> copy(empty);
+	ASSERT_FALSE(copy.has_value());
+
+	bmstu::compact_optional<bmstu::string> moved(std::move(copy));
+	ASSERT_FALSE(moved.has_value());
+	ASSERT_FALSE(copy.has_value());
+
+	bmstu::compact_optional<bmstu::string> target(
+		bmstu::string("a string that is too long for the small buffer"));
+	target = empty;
+	ASSERT_FALSE(target.has_value());
+
+	target = bmstu::string("short");
+	target = std::move(moved);
+	ASSERT_FALSE(target.has_value());
+	ASSERT_FALSE(moved.has_value());
+
+	// engaged ones still copy and move their value
+	bmstu::compact_optional<bmstu::string> engaged(bmstu::string("value"));
+	target = engaged;
+	ASSERT_STREQ(target->c_str(), "value");
+	bmstu::compact_optional<bmstu::string> taken(std::move(target));
+	ASSERT_STREQ(taken->c_str(), "value");
+	copy = std::move(taken);
+	ASSERT_STREQ(copy->c_str(), "value");
+}
+
+TEST(CompactOptionalTest, InSimpleVector)
+{
+	bmstu::simple_vector<bmstu::compact_optional<double>> vec(4);
+	vec[1] = 2.0;
+	vec.push_back(5.0);
+	vec.push_back(bmstu::nullopt);
+	ASSERT_EQ(vec.size(), 6u);
+	size_t engaged = 0;
+	for (const auto& opt : vec)
+	{
+		engaged += opt.has_value();
+	}
+	ASSERT_EQ(engaged, 2u);
+}
+
+namespace
+{
+template <typename Optional>
+void footprint(const char* name, size_t count)
+{
+	auto start = std::chrono::steady_clock::now();
+	bmstu::simple_vector<Optional> vec(count);
+	for (size_t i = 0; i < count; i += 3)
+	{
+		vec[i] = static_cast<double>(i);
+	}
+	double sum = 0;
+	for (int round = 0; round < 10; ++round)
+	{
+		for (const auto& opt : vec)
+		{
+			if (opt.has_value())
+			{
+				sum += *opt;
+			}
+		}
+	}
+	auto elapsed = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start);
+	std::cout << name << ": " << count * sizeof(Optional) << " bytes, "
+			  << elapsed.count() << " ms (checksum " << sum << ")"
+			  << std::endl;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(CompactOptionalBench, DISABLED_Footprint)
+{
+	const size_t count = 1 << 23;
+	footprint<bmstu::optional<double>>("simple_vector<optional<double>>",
+									   count);
+	footprint<bmstu::compact_optional<double>>(
+		"simple_vector<compact_optional<double>>", count);
+}
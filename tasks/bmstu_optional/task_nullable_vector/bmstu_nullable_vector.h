@@ -0,0 +1,386 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "array_ptr.h"
+#include "bmstu_optional.h"
+#include "bmstu_popcount.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Kernels over a validity bitmap (bit i of word i / 64 is set when element i
+// holds a value) and a dense value buffer. Null slots always hold T{}, so a
+// sum doesn't have to look at the bitmap at all.
+namespace bmstu
+{
+namespace
+{
+template <typename T>
+using nullable_sum_t =
+	std::conditional_t<std::is_floating_point_v<T>, double,
+					   std::conditional_t<std::is_signed_v<T>, int64_t,
+										  uint64_t>>;
+
+template <typename T>
+nullable_sum_t<T> sum_dense(const T* values, size_t size)
+{
+	nullable_sum_t<T> sum = 0;
+	for (size_t i = 0; i < size; ++i)
+	{
+		sum += values[i];
+	}
+	return sum;
+}
+
+inline int64_t sum_dense(const int32_t* values, size_t size)
+{
+	int64_t sum = 0;
+	size_t i = 0;
+#if defined(__AVX2__)
+	__m256i acc = _mm256_setzero_si256();
+	for (; i + 8 <= size; i += 8)
+	{
+		const __m256i x =
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+		acc = _mm256_add_epi64(
+			acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+		acc = _mm256_add_epi64(
+			acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+	}
+	alignas(32) int64_t lanes[4];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+	sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#elif defined(__SSE2__)
+	__m128i acc = _mm_setzero_si128();
+	for (; i + 4 <= size; i += 4)
+	{
+		const __m128i x =
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+		const __m128i sign = _mm_srai_epi32(x, 31);
+		acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(x, sign));
+		acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(x, sign));
+	}
+	alignas(16) int64_t lanes[2];
+	_mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+	sum += lanes[0] + lanes[1];
+#endif
+	for (; i < size; ++i)
+	{
+		sum += values[i];
+	}
+	return sum;
+}
+
+inline double sum_dense(const double* values, size_t size)
+{
+	double sum = 0;
+	size_t i = 0;
+#if defined(__AVX2__)
+	__m256d acc = _mm256_setzero_pd();
+	for (; i + 4 <= size; i += 4)
+	{
+		acc = _mm256_add_pd(acc, _mm256_loadu_pd(values + i));
+	}
+	alignas(32) double lanes[4];
+	_mm256_store_pd(lanes, acc);
+	sum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(__SSE2__)
+	__m128d acc = _mm_setzero_pd();
+	for (; i + 2 <= size; i += 2)
+	{
+		acc = _mm_add_pd(acc, _mm_loadu_pd(values + i));
+	}
+	alignas(16) double lanes[2];
+	_mm_store_pd(lanes, acc);
+	sum += lanes[0] + lanes[1];
+#endif
+	for (; i < size; ++i)
+	{
+		sum += values[i];
+	}
+	return sum;
+}
+
+// Writes value into every slot of values[0, 64) whose bit in word is clear
+template <typename T>
+void fill_unset(T* values, uint64_t word, const T& value)
+{
+	size_t j = 0;
+	if constexpr (sizeof(T) == 4 && std::is_trivially_copyable_v<T>)
+	{
+		int32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+#if defined(__AVX2__)
+		const __m256i fill = _mm256_set1_epi32(bits);
+		const __m256i lane_bits =
+			_mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+		for (; j < 64; j += 8)
+		{
+			const __m256i byte = _mm256_set1_epi32(int((word >> j) & 0xff));
+			const __m256i valid = _mm256_cmpeq_epi32(
+				_mm256_and_si256(byte, lane_bits), lane_bits);
+			auto* ptr = reinterpret_cast<__m256i*>(values + j);
+			_mm256_storeu_si256(
+				ptr, _mm256_blendv_epi8(fill, _mm256_loadu_si256(ptr), valid));
+		}
+#elif defined(__SSE2__)
+		const __m128i fill = _mm_set1_epi32(bits);
+		const __m128i lane_bits = _mm_setr_epi32(1, 2, 4, 8);
+		for (; j < 64; j += 4)
+		{
+			const __m128i nibble = _mm_set1_epi32(int((word >> j) & 0xf));
+			const __m128i valid =
+				_mm_cmpeq_epi32(_mm_and_si128(nibble, lane_bits), lane_bits);
+			auto* ptr = reinterpret_cast<__m128i*>(values + j);
+			_mm_storeu_si128(
+				ptr, _mm_or_si128(_mm_and_si128(valid, _mm_loadu_si128(ptr)),
+								  _mm_andnot_si128(valid, fill)));
+		}
+#endif
+	}
+	for (; j < 64; ++j)
+	{
+		if (((word >> j) & 1) == 0)
+		{
+			values[j] = value;
+		}
+	}
+}
+}  // namespace
+
+// A column of optional<T> in the Arrow layout: a packed validity bitmap next
+// to a dense buffer of values. optional<int32_t> takes 8 bytes, here an
+// element costs 4 bytes and 1 bit, and whole-column kernels never branch per
+// element.
+template <typename T>
+	requires std::is_arithmetic_v<T>
+class nullable_vector
+{
+   public:
+	using value_type = T;
+	using sum_type = nullable_sum_t<T>;
+
+	nullable_vector() noexcept = default;
+
+	nullable_vector(std::initializer_list<optional<T>> init)
+	{
+		reserve(init.size());
+		for (const auto& value : init)
+		{
+			push_back(value);
+		}
+	}
+
+	nullable_vector(const nullable_vector& other)
+	{
+		reserve(other.size_);
+		std::copy_n(other.values_.get(), other.size_, values_.get());
+		std::copy_n(other.words_.get(), words_for(other.size_),
+					words_.get());
+		size_ = other.size_;
+	}
+
+	nullable_vector(nullable_vector&& other) noexcept { swap(other); }
+
+	nullable_vector& operator=(const nullable_vector& other)
+	{
+		if (this != &other)
+		{
+			nullable_vector copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	nullable_vector& operator=(nullable_vector&& other) noexcept
+	{
+		if (this != &other)
+		{
+			nullable_vector moved(std::move(other));
+			swap(moved);
+		}
+		return *this;
+	}
+
+	~nullable_vector() = default;
+
+	void swap(nullable_vector& other) noexcept
+	{
+		values_.swap(other.values_);
+		words_.swap(other.words_);
+		std::swap(size_, other.size_);
+		std::swap(capacity_, other.capacity_);
+	}
+
+	size_t size() const noexcept { return size_; }
+
+	size_t capacity() const noexcept { return capacity_; }
+
+	bool empty() const noexcept { return size_ == 0; }
+
+	optional<T> operator[](size_t index) const
+	{
+		if (!is_valid(index))
+		{
+			return nullopt;
+		}
+		return values_[index];
+	}
+
+	optional<T> at(size_t index) const
+	{
+		if (index >= size_)
+		{
+			throw std::out_of_range("Index out of range");
+		}
+		return (*this)[index];
+	}
+
+	bool is_valid(size_t index) const noexcept
+	{
+		return (words_[index / 64] >> (index % 64)) & 1;
+	}
+
+	void set(size_t index, const optional<T>& value)
+	{
+		if (value.has_value())
+		{
+			values_[index] = *value;
+			words_[index / 64] |= uint64_t(1) << (index % 64);
+		}
+		else
+		{
+			values_[index] = T{};
+			words_[index / 64] &= ~(uint64_t(1) << (index % 64));
+		}
+	}
+
+	void push_back(const optional<T>& value)
+	{
+		if (size_ == capacity_)
+		{
+			reserve(capacity_ == 0 ? 64 : 2 * capacity_);
+		}
+		++size_;
+		set(size_ - 1, value);
+	}
+
+	void pop_back() noexcept
+	{
+		if (size_ > 0)
+		{
+			--size_;
+			words_[size_ / 64] &= ~(uint64_t(1) << (size_ % 64));
+		}
+	}
+
+	void clear() noexcept
+	{
+		if (words_)
+		{
+			std::fill_n(words_.get(), words_for(size_), uint64_t(0));
+		}
+		size_ = 0;
+	}
+
+	// Capacity is kept a multiple of 64 so the bitmap is made of whole words
+	void reserve(size_t new_cap)
+	{
+		new_cap = words_for(new_cap) * 64;
+		if (new_cap <= capacity_)
+		{
+			return;
+		}
+		array_ptr<T> new_values(new_cap);
+		array_ptr<uint64_t> new_words(new_cap / 64);
+		if (size_ > 0)
+		{
+			std::copy_n(values_.get(), size_, new_values.get());
+		}
+		const size_t used_words = words_for(size_);
+		if (used_words > 0)
+		{
+			std::copy_n(words_.get(), used_words, new_words.get());
+		}
+		// bits past size_ must read as null
+		std::fill(new_words.get() + used_words, new_words.get() + new_cap / 64,
+				  uint64_t(0));
+		values_.swap(new_values);
+		words_.swap(new_words);
+		capacity_ = new_cap;
+	}
+
+	size_t count_valid() const noexcept
+	{
+		return words_ ? popcount_words(words_.get(), words_for(size_)) : 0;
+	}
+
+	size_t null_count() const noexcept { return size_ - count_valid(); }
+
+	// Sum of the non-null elements, integers are widened to 64 bits
+	sum_type sum() const noexcept
+	{
+		return values_ ? sum_type(sum_dense(values_.get(), size_)) : 0;
+	}
+
+	// Replaces every null with value, afterwards all elements are valid
+	void fill_nulls(const T& value)
+	{
+		const size_t full_words = size_ / 64;
+		for (size_t w = 0; w < full_words; ++w)
+		{
+			if (words_[w] != ~uint64_t(0))
+			{
+				fill_unset(values_.get() + w * 64, words_[w], value);
+				words_[w] = ~uint64_t(0);
+			}
+		}
+		for (size_t i = full_words * 64; i < size_; ++i)
+		{
+			if (!is_valid(i))
+			{
+				set(i, value);
+			}
+		}
+	}
+
+	// Raw column buffers for kernels written elsewhere
+	const T* values() const noexcept { return values_.get(); }
+
+	const uint64_t* validity() const noexcept { return words_.get(); }
+
+	friend bool operator==(const nullable_vector& lhs,
+						   const nullable_vector& rhs)
+	{
+		if (lhs.size_ != rhs.size_)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < lhs.size_; ++i)
+		{
+			if (lhs.is_valid(i) != rhs.is_valid(i) ||
+				lhs.values_[i] != rhs.values_[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+   private:
+	static size_t words_for(size_t size) noexcept { return (size + 63) / 64; }
+
+	array_ptr<T> values_;
+	array_ptr<uint64_t> words_;
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+};
+}  // namespace bmstu
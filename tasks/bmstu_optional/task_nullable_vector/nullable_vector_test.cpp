@@ -0,0 +1,240 @@
+#include "bmstu_nullable_vector.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "bmstu_optional.h"
+#include "bmstu_simple_vector.h"
+
+TEST(NullableVectorTest, Empty)
+{
+	bmstu::nullable_vector<int32_t> vec;
+	ASSERT_TRUE(vec.empty());
+	ASSERT_EQ(vec.size(), 0u);
+	ASSERT_EQ(vec.count_valid(), 0u);
+	ASSERT_EQ(vec.sum(), 0);
+	vec.clear();
+	vec.fill_nulls(1);
+	ASSERT_THROW(vec.at(0), std::out_of_range);
+}
+
+TEST(NullableVectorTest, PushBackAndAccess)
+{
+	bmstu::nullable_vector<int32_t> vec{1, bmstu::nullopt, 3};
+	vec.push_back(bmstu::optional<int32_t>(4));
+	vec.push_back(bmstu::nullopt);
+	ASSERT_EQ(vec.size(), 5u);
+	ASSERT_EQ(vec.capacity() % 64, 0u);
+	ASSERT_TRUE(vec[0].has_value());
+	ASSERT_EQ(*vec[0], 1);
+	ASSERT_FALSE(vec[1].has_value());
+	ASSERT_EQ(vec.at(3).value(), 4);
+	ASSERT_FALSE(vec.at(4).has_value());
+	ASSERT_THROW(vec.at(5), std::out_of_range);
+	ASSERT_EQ(vec.count_valid(), 3u);
+	ASSERT_EQ(vec.null_count(), 2u);
+}
+
+TEST(NullableVectorTest, SetAndPopBack)
+{
+	bmstu::nullable_vector<int32_t> vec{1, 2, 3};
+	vec.set(1, bmstu::nullopt);
+	ASSERT_FALSE(vec.is_valid(1));
+	ASSERT_EQ(vec.sum(), 4);
+	vec.set(1, 10);
+	ASSERT_EQ(vec.sum(), 14);
+	vec.pop_back();
+	ASSERT_EQ(vec.size(), 2u);
+	vec.push_back(bmstu::nullopt);
+	// the popped slot must not come back as valid
+	ASSERT_FALSE(vec[2].has_value());
+	ASSERT_EQ(vec.count_valid(), 2u);
+}
+
+TEST(NullableVectorTest, ManyWords)
+{
+	bmstu::nullable_vector<int32_t> vec;
+	int64_t expected_sum = 0;
+	size_t expected_valid = 0;
+	for (int32_t i = 0; i < 1000; ++i)
+	{
+		if (i % 3 == 0)
+		{
+			vec.push_back(bmstu::nullopt);
+		}
+		else
+		{
+			const int32_t value = (i % 2 == 0 ? 1 : -1) * i * 1000003;
+			vec.push_back(value);
+			expected_sum += value;
+			++expected_valid;
+		}
+	}
+	ASSERT_EQ(vec.size(), 1000u);
+	ASSERT_EQ(vec.count_valid(), expected_valid);
+	ASSERT_EQ(vec.sum(), expected_sum);
+	for (size_t i = 0; i < vec.size(); ++i)
+	{
+		ASSERT_EQ(vec.is_valid(i), i % 3 != 0);
+	}
+}
+
+TEST(NullableVectorTest, SumDoesNotOverflow)
+{
+	bmstu::nullable_vector<int32_t> vec;
+	for (int i = 0; i < 100; ++i)
+	{
+		vec.push_back(INT32_MAX);
+		vec.push_back(bmstu::nullopt);
+	}
+	ASSERT_EQ(vec.sum(), int64_t(INT32_MAX) * 100);
+
+	bmstu::nullable_vector<uint8_t> bytes{255, 255, bmstu::nullopt, 255};
+	ASSERT_EQ(bytes.sum(), 765u);
+}
+
+TEST(NullableVectorTest, Double)
+{
+	bmstu::nullable_vector<double> vec;
+	for (int i = 0; i < 101; ++i)
+	{
+		if (i % 4 == 1)
+		{
+			vec.push_back(bmstu::nullopt);
+		}
+		else
+		{
+			vec.push_back(0.5 * i);
+		}
+	}
+	double expected = 0;
+	for (int i = 0; i < 101; ++i)
+	{
+		expected += i % 4 == 1 ? 0 : 0.5 * i;
+	}
+	ASSERT_DOUBLE_EQ(vec.sum(), expected);
+	ASSERT_EQ(vec.count_valid(), 76u);
+}
+
+TEST(NullableVectorTest, FillNulls)
+{
+	bmstu::nullable_vector<int32_t> vec;
+	for (int32_t i = 0; i < 200; ++i)
+	{
+		if (i % 5 == 0 || (i >= 64 && i < 128))
+		{
+			vec.push_back(bmstu::nullopt);
+		}
+		else
+		{
+			vec.push_back(i);
+		}
+	}
+	vec.fill_nulls(-7);
+	ASSERT_EQ(vec.count_valid(), 200u);
+	for (int32_t i = 0; i < 200; ++i)
+	{
+		const bool was_null = i % 5 == 0 || (i >= 64 && i < 128);
+		ASSERT_EQ(*vec[i], was_null ? -7 : i);
+	}
+	// bits past the end stay clear
+	vec.push_back(bmstu::nullopt);
+	ASSERT_FALSE(vec[200].has_value());
+
+	bmstu::nullable_vector<double> doubles{bmstu::nullopt, 1.5,
+										   bmstu::nullopt};
+	doubles.fill_nulls(0.25);
+	ASSERT_EQ(doubles.sum(), 2.0);
+}
+
+TEST(NullableVectorTest, CopyMoveClear)
+{
+	bmstu::nullable_vector<int64_t> vec{1, bmstu::nullopt, 3};
+	bmstu::nullable_vector<int64_t> copy(vec);
+	ASSERT_EQ(copy, vec);
+	copy.set(0, bmstu::nullopt);
+	ASSERT_FALSE(copy == vec);
+
+	bmstu::nullable_vector<int64_t> moved(std::move(copy));
+	ASSERT_EQ(moved.size(), 3u);
+	ASSERT_EQ(moved.count_valid(), 1u);
+	ASSERT_TRUE(copy.empty());
+
+	moved = vec;
+	ASSERT_EQ(moved, vec);
+	moved.clear();
+	ASSERT_TRUE(moved.empty());
+	moved.push_back(bmstu::nullopt);
+	ASSERT_EQ(moved.count_valid(), 0u);
+}
+
+namespace
+{
+template <typename Func>
+void time_it(const char* name, Func func)
+{
+	auto start = std::chrono::steady_clock::now();
+	int64_t checksum = func();
+	auto elapsed = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start);
+	std::cout << name << ": " << elapsed.count() << " ms (checksum "
+			  << checksum << ")" << std::endl;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(NullableVectorBench, DISABLED_CountAndSum)
+{
+	const size_t count = 1 << 24;
+	bmstu::simple_vector<bmstu::optional<int32_t>> rows;
+	bmstu::nullable_vector<int32_t> column;
+	for (size_t i = 0; i < count; ++i)
+	{
+		bmstu::optional<int32_t> value;
+		if ((i * 2654435761u) % 7 != 0)
+		{
+			value = static_cast<int32_t>(i % 1000) - 500;
+		}
+		rows.push_back(value);
+		column.push_back(value);
+	}
+	std::cout << "simple_vector<optional<int32_t>>: "
+			  << count * sizeof(bmstu::optional<int32_t>) << " bytes"
+			  << std::endl;
+	std::cout << "nullable_vector<int32_t>: "
+			  << count * sizeof(int32_t) + count / 8 << " bytes" << std::endl;
+
+	time_it("count_valid (optional rows)",
+			[&]
+			{
+				int64_t valid = 0;
+				for (const auto& opt : rows)
+				{
+					valid += opt.has_value();
+				}
+				return valid;
+			});
+	time_it("count_valid (bitmap)",
+			[&] { return static_cast<int64_t>(column.count_valid()); });
+	time_it("sum (optional rows)",
+			[&]
+			{
+				int64_t sum = 0;
+				for (const auto& opt : rows)
+				{
+					if (opt)
+					{
+						sum += *opt;
+					}
+				}
+				return sum;
+			});
+	time_it("sum (column)", [&] { return column.sum(); });
+	time_it("fill_nulls (column)",
+			[&]
+			{
+				column.fill_nulls(0);
+				return static_cast<int64_t>(column.count_valid());
+			});
+}
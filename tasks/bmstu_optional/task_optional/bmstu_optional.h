@@ -1,7 +1,10 @@
 #pragma once
 #include <cstdint>
 #include <exception>
+#include <functional>
+#include <memory>
 #include <type_traits>
+#include <utility>
 
 namespace bmstu
 {
@@ -16,78 +19,483 @@ class bad_optional_access : public std::exception
    public:
 	using exception::exception;
 
-	const char* what() const noexcept override { return "WRONG TEXT"; }
+	const char* what() const noexcept override { return "Bad optional access"; }
 };
 
+// Special members are defaulted (and therefore trivial) whenever the
+// matching operation on T is trivial, so optional<int> is trivially copyable
+// and is passed in registers. The value lives in a union rather than a byte
+// buffer so the whole type stays usable in constant expressions.
 template <typename T>
 class optional
 {
    public:
-	optional() = default;
+	using value_type = T;
 
-	optional(const T& value) {}
+	constexpr optional() noexcept {}
 
-	optional(T&& value) {}
+	constexpr optional(nullopt_t) noexcept {}
 
-	optional(const optional& other) {}
+	constexpr optional(const T& value) : value_(value), is_initialized_(true)
+	{
+	}
+
+	constexpr optional(T&& value)
+		: value_(std::move(value)), is_initialized_(true)
+	{
+	}
+
+	constexpr optional(const optional& other)
+		requires std::is_trivially_copy_constructible_v<T>
+	= default;
+
+	constexpr optional(const optional& other)
+		requires(std::is_copy_constructible_v<T> &&
+				 !std::is_trivially_copy_constructible_v<T>)
+	{
+		if (other.is_initialized_)
+		{
+			construct(other.value_);
+		}
+	}
+
+	constexpr optional(optional&& other) noexcept
+		requires std::is_trivially_move_constructible_v<T>
+	= default;
+
+	constexpr optional(optional&& other) noexcept(
+		std::is_nothrow_move_constructible_v<T>)
+		requires(std::is_move_constructible_v<T> &&
+				 !std::is_trivially_move_constructible_v<T>)
+	{
+		if (other.is_initialized_)
+		{
+			construct(std::move(other.value_));
+		}
+	}
+
+	constexpr optional& operator=(nullopt_t) noexcept
+	{
+		reset();
+		return *this;
+	}
+
+	constexpr optional& operator=(const T& value)
+	{
+		if (is_initialized_)
+		{
+			value_ = value;
+		}
+		else
+		{
+			construct(value);
+		}
+		return *this;
+	}
+
+	constexpr optional& operator=(T&& value)
+	{
+		if (is_initialized_)
+		{
+			value_ = std::move(value);
+		}
+		else
+		{
+			construct(std::move(value));
+		}
+		return *this;
+	}
+
+	constexpr optional& operator=(const optional& other)
+		requires(std::is_trivially_copy_constructible_v<T> &&
+				 std::is_trivially_copy_assignable_v<T> &&
+				 std::is_trivially_destructible_v<T>)
+	= default;
+
+	constexpr optional& operator=(const optional& other)
+	{
+		if (this == &other)
+		{
+			return *this;
+		}
+		if (!other.is_initialized_)
+		{
+			reset();
+		}
+		else if (is_initialized_)
+		{
+			value_ = other.value_;
+		}
+		else
+		{
+			construct(other.value_);
+		}
+		return *this;
+	}
+
+	constexpr optional& operator=(optional&& other) noexcept
+		requires(std::is_trivially_move_constructible_v<T> &&
+				 std::is_trivially_move_assignable_v<T> &&
+				 std::is_trivially_destructible_v<T>)
+	= default;
+
+	constexpr optional& operator=(optional&& other) noexcept(
+		std::is_nothrow_move_constructible_v<T> &&
+		std::is_nothrow_move_assignable_v<T>)
+	{
+		if (this == &other)
+		{
+			return *this;
+		}
+		if (!other.is_initialized_)
+		{
+			reset();
+		}
+		else if (is_initialized_)
+		{
+			value_ = std::move(other.value_);
+		}
+		else
+		{
+			construct(std::move(other.value_));
+		}
+		return *this;
+	}
+
+	constexpr T& operator*() & { return value_; }
+
+	constexpr const T& operator*() const& { return value_; }
 
-	optional(optional&& other) noexcept {}
+	constexpr T* operator->() { return std::addressof(value_); }
 
-	optional& operator=(const T& value) { return *this; }
+	constexpr const T* operator->() const { return std::addressof(value_); }
 
-	optional& operator=(T&& value) { return *this; }
+	constexpr T&& operator*() && { return std::move(value_); }
 
-	optional& operator=(const optional& value) { return *this; }
+	constexpr const T&& operator*() const&& { return std::move(value_); }
 
-	optional& operator=(optional&& value) { return *this; }
+	constexpr T& value() &
+	{
+		check();
+		return value_;
+	}
+
+	constexpr const T& value() const&
+	{
+		check();
+		return value_;
+	}
+
+	constexpr T&& value() &&
+	{
+		check();
+		return std::move(value_);
+	}
+
+	constexpr const T&& value() const&&
+	{
+		check();
+		return std::move(value_);
+	}
+
+	// Monadic operations. An rvalue optional hands its value to func (and to
+	// the result of value_or/or_else) by move, and transform constructs the
+	// new value in place from func's result, so a chain copies nothing.
+	template <typename F>
+	constexpr auto and_then(F&& func) &
+	{
+		return and_then_impl(*this, std::forward<F>(func));
+	}
+
+	template <typename F>
+	constexpr auto and_then(F&& func) const&
+	{
+		return and_then_impl(*this, std::forward<F>(func));
+	}
+
+	template <typename F>
+	constexpr auto and_then(F&& func) &&
+	{
+		return and_then_impl(std::move(*this), std::forward<F>(func));
+	}
+
+	template <typename F>
+	constexpr auto and_then(F&& func) const&&
+	{
+		return and_then_impl(std::move(*this), std::forward<F>(func));
+	}
+
+	template <typename F>
+	constexpr auto transform(F&& func) &
+	{
+		return transform_impl(*this, std::forward<F>(func));
+	}
 
-	T& operator*() &
+	template <typename F>
+	constexpr auto transform(F&& func) const&
 	{
-		T* ptr = nullptr;
-		return *ptr;
+		return transform_impl(*this, std::forward<F>(func));
 	}
 
-	const T& operator*() const&
+	template <typename F>
+	constexpr auto transform(F&& func) &&
 	{
-		T* ptr = nullptr;
-		return *ptr;
+		return transform_impl(std::move(*this), std::forward<F>(func));
 	}
 
-	T* operator->() { return nullptr; }
+	template <typename F>
+	constexpr auto transform(F&& func) const&&
+	{
+		return transform_impl(std::move(*this), std::forward<F>(func));
+	}
 
-	const T* operator->() const { return nullptr; }
+	template <typename F>
+	constexpr optional or_else(F&& func) const&
+	{
+		if (is_initialized_)
+		{
+			return *this;
+		}
+		return std::forward<F>(func)();
+	}
 
-	T&& operator*() &&
+	template <typename F>
+	constexpr optional or_else(F&& func) &&
 	{
-		T* ptr = nullptr;
-		return std::move(*ptr);
+		if (is_initialized_)
+		{
+			return std::move(*this);
+		}
+		return std::forward<F>(func)();
 	}
 
-	T& value() &
+	template <typename U>
+	constexpr T value_or(U&& default_value) const&
 	{
-		T* ptr = nullptr;
-		return *ptr;
+		if (is_initialized_)
+		{
+			return value_;
+		}
+		return static_cast<T>(std::forward<U>(default_value));
 	}
 
-	const T& value() const&
+	template <typename U>
+	constexpr T value_or(U&& default_value) &&
 	{
-		T* ptr = nullptr;
-		return *ptr;
+		if (is_initialized_)
+		{
+			return std::move(value_);
+		}
+		return static_cast<T>(std::forward<U>(default_value));
 	}
 
 	template <typename... Args>
-	void emplace(Args&&... args)
+	constexpr T& emplace(Args&&... args)
+	{
+		reset();
+		construct(std::forward<Args>(args)...);
+		return value_;
+	}
+
+	constexpr void reset() noexcept
 	{
+		if (is_initialized_)
+		{
+			if constexpr (!std::is_trivially_destructible_v<T>)
+			{
+				std::destroy_at(std::addressof(value_));
+			}
+			is_initialized_ = false;
+		}
 	}
 
-	void reset() {}
+	constexpr ~optional()
+		requires std::is_trivially_destructible_v<T>
+	= default;
+
+	constexpr ~optional() { reset(); }
 
-	~optional() {}
+	constexpr bool has_value() const noexcept { return is_initialized_; }
 
-	bool has_value() const { return false; };
+	constexpr explicit operator bool() const noexcept
+	{
+		return is_initialized_;
+	}
 
    private:
-	alignas(T) uint8_t data_[sizeof(T)];
+	template <typename U>
+	friend class optional;
+
+	struct invoke_tag
+	{
+	};
+
+	// Holds std::invoke(func, arg), with the result materialized in place
+	template <typename F, typename Arg>
+	constexpr optional(invoke_tag, F&& func, Arg&& arg)
+		: value_(std::invoke(std::forward<F>(func), std::forward<Arg>(arg))),
+		  is_initialized_(true)
+	{
+	}
+
+	template <typename Self, typename F>
+	static constexpr auto and_then_impl(Self&& self, F&& func)
+	{
+		using result = std::remove_cvref_t<std::invoke_result_t<
+			F, decltype((std::forward<Self>(self).value_))>>;
+		if (self.is_initialized_)
+		{
+			return std::invoke(std::forward<F>(func),
+							   std::forward<Self>(self).value_);
+		}
+		return result();
+	}
+
+	template <typename Self, typename F>
+	static constexpr auto transform_impl(Self&& self, F&& func)
+	{
+		using U = std::invoke_result_t<
+			F, decltype((std::forward<Self>(self).value_))>;
+		// a function returning an lvalue reference gives an optional<U&>
+		using result = optional<std::conditional_t<
+			std::is_lvalue_reference_v<U>, U, std::remove_cvref_t<U>>>;
+		if (self.is_initialized_)
+		{
+			return result(typename result::invoke_tag(),
+						  std::forward<F>(func),
+						  std::forward<Self>(self).value_);
+		}
+		return result();
+	}
+
+	template <typename... Args>
+	constexpr void construct(Args&&... args)
+	{
+		std::construct_at(std::addressof(value_), std::forward<Args>(args)...);
+		is_initialized_ = true;
+	}
+
+	constexpr void check() const
+	{
+		if (!is_initialized_)
+		{
+			throw bad_optional_access();
+		}
+	}
+
+	union
+	{
+		char null_state_ = 0;
+		T value_;
+	};
 	bool is_initialized_ = false;
 };
-}  // namespace bmstu
\ No newline at end of file
+
+// A nullable reference, one pointer in size, e.g. for returning a lookup
+// result without copying it out of the container. Like T& itself, it is bound
+// once at construction: assigning from T would be ambiguous between
+// rebinding and writing through, so there is no assignment at all. Write
+// through with *opt = value.
+template <typename T>
+class optional<T&>
+{
+   public:
+	using value_type = T&;
+
+	constexpr optional() noexcept = default;
+
+	constexpr optional(nullopt_t) noexcept {}
+
+	constexpr optional(T& value) noexcept : ptr_(std::addressof(value)) {}
+
+	// would dangle as soon as the full expression ends
+	optional(T&& value) = delete;
+
+	constexpr optional(const optional& other) noexcept = default;
+
+	optional& operator=(const optional& other) = delete;
+
+	constexpr T& operator*() const noexcept { return *ptr_; }
+
+	constexpr T* operator->() const noexcept { return ptr_; }
+
+	constexpr T& value() const
+	{
+		if (ptr_ == nullptr)
+		{
+			throw bad_optional_access();
+		}
+		return *ptr_;
+	}
+
+	constexpr bool has_value() const noexcept { return ptr_ != nullptr; }
+
+	constexpr explicit operator bool() const noexcept
+	{
+		return ptr_ != nullptr;
+	}
+
+	template <typename F>
+	constexpr auto and_then(F&& func) const
+	{
+		using result = std::remove_cvref_t<std::invoke_result_t<F, T&>>;
+		if (ptr_ != nullptr)
+		{
+			return std::invoke(std::forward<F>(func), *ptr_);
+		}
+		return result();
+	}
+
+	template <typename F>
+	constexpr auto transform(F&& func) const
+	{
+		using U = std::invoke_result_t<F, T&>;
+		using result = optional<std::conditional_t<
+			std::is_lvalue_reference_v<U>, U, std::remove_cvref_t<U>>>;
+		if (ptr_ != nullptr)
+		{
+			return result(typename result::invoke_tag(),
+						  std::forward<F>(func), *ptr_);
+		}
+		return result();
+	}
+
+	template <typename F>
+	constexpr optional or_else(F&& func) const
+	{
+		if (ptr_ != nullptr)
+		{
+			return *this;
+		}
+		return std::forward<F>(func)();
+	}
+
+	template <typename U>
+	constexpr std::remove_cv_t<T> value_or(U&& default_value) const
+	{
+		if (ptr_ != nullptr)
+		{
+			return *ptr_;
+		}
+		return static_cast<std::remove_cv_t<T>>(
+			std::forward<U>(default_value));
+	}
+
+   private:
+	template <typename U>
+	friend class optional;
+
+	struct invoke_tag
+	{
+	};
+
+	template <typename F, typename Arg>
+	constexpr optional(invoke_tag, F&& func, Arg&& arg)
+		: ptr_(std::addressof(
+			  std::invoke(std::forward<F>(func), std::forward<Arg>(arg))))
+	{
+	}
+
+	T* ptr_ = nullptr;
+};
+}  // namespace bmstu
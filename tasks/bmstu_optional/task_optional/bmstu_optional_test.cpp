@@ -4,6 +4,8 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -781,4 +783,310 @@ TEST(Optional, ExceptionWithTrackedObject)
 	}
 	ASSERT_EQ(Tracker::param_ctor, 1);
 	ASSERT_EQ(Tracker::dtor, 1);
-}
\ No newline at end of file
+}
+static_assert(std::is_trivially_copyable_v<bmstu::optional<int>>);
+static_assert(std::is_trivially_copyable_v<bmstu::optional<double>>);
+static_assert(std::is_trivially_destructible_v<bmstu::optional<int>>);
+static_assert(std::is_trivially_copy_constructible_v<bmstu::optional<int>>);
+static_assert(std::is_trivially_move_assignable_v<bmstu::optional<int>>);
+static_assert(!std::is_trivially_copyable_v<bmstu::optional<std::string>>);
+static_assert(!std::is_trivially_destructible_v<bmstu::optional<Tracker>>);
+static_assert(std::is_nothrow_move_constructible_v<bmstu::optional<Tracker>>);
+static_assert(sizeof(bmstu::optional<int>) == 2 * sizeof(int));
+
+namespace
+{
+constexpr int constexpr_roundtrip()
+{
+	bmstu::optional<int> a;
+	bmstu::optional<int> b(10);
+	a = b;
+	b.reset();
+	a = *a + 5;
+	bmstu::optional<int> c(std::move(a));
+	return b.has_value() ? -1 : c.value();
+}
+
+struct literal
+{
+	constexpr literal(int v) : value(v) {}
+	constexpr literal(const literal& other) : value(other.value + 1) {}
+	constexpr literal& operator=(const literal& other) = default;
+	constexpr ~literal() {}
+	int value;
+};
+
+constexpr int constexpr_non_trivial()
+{
+	bmstu::optional<literal> a(literal(1));
+	bmstu::optional<literal> b(a);
+	a.reset();
+	b.emplace(40);
+	bmstu::optional<literal> c;
+	c = b;
+	return a.has_value() ? -1 : c->value;
+}
+}  // namespace
+
+TEST(Optional, Constexpr)
+{
+	constexpr bmstu::optional<int> empty;
+	constexpr bmstu::optional<int> engaged(42);
+	static_assert(!empty.has_value());
+	static_assert(engaged.has_value() && *engaged == 42);
+	static_assert(engaged.value() == 42);
+	static_assert(constexpr_roundtrip() == 15);
+	static_assert(constexpr_non_trivial() == 41);
+	ASSERT_EQ(constexpr_roundtrip(), 15);
+}
+
+TEST(Optional, TrivialCopyKeepsState)
+{
+	bmstu::optional<int> a(7);
+	bmstu::optional<int> b;
+	std::memcpy(&b, &a, sizeof(a));
+	ASSERT_TRUE(b.has_value());
+	ASSERT_EQ(*b, 7);
+	b = bmstu::nullopt;
+	ASSERT_FALSE(b.has_value());
+}
+
+static_assert(sizeof(bmstu::optional<int&>) == sizeof(int*));
+static_assert(sizeof(bmstu::optional<const Tracker&>) == sizeof(Tracker*));
+static_assert(std::is_trivially_copyable_v<bmstu::optional<Tracker&>>);
+static_assert(!std::is_copy_assignable_v<bmstu::optional<int&>>);
+static_assert(!std::is_assignable_v<bmstu::optional<int&>&, int&>);
+static_assert(!std::is_constructible_v<bmstu::optional<const int&>, int>);
+
+namespace
+{
+// Stands in for a container lookup such as map::find, which gives V*
+bmstu::optional<Tracker&> find_tracker(std::vector<Tracker>& items, int value)
+{
+	for (auto& item : items)
+	{
+		if (item.value == value)
+		{
+			return item;
+		}
+	}
+	return bmstu::nullopt;
+}
+}  // namespace
+
+TEST(Optional, ReferenceLookupDoesNotCopy)
+{
+	std::vector<Tracker> items;
+	items.reserve(3);
+	items.emplace_back(1);
+	items.emplace_back(2);
+	items.emplace_back(3);
+	Tracker::reset();
+
+	auto found = find_tracker(items, 2);
+	ASSERT_TRUE(found.has_value());
+	ASSERT_EQ(&*found, &items[1]);
+	found->value = 20;
+	ASSERT_EQ(items[1].value, 20);
+	ASSERT_FALSE(find_tracker(items, 5));
+	ASSERT_THROW(find_tracker(items, 5).value(), bmstu::bad_optional_access);
+
+	auto copy = found;
+	ASSERT_EQ(&copy.value(), &items[1]);
+	ASSERT_EQ(Tracker::copy_ctor, 0);
+	ASSERT_EQ(Tracker::move_ctor, 0);
+	ASSERT_EQ(Tracker::copy_assign, 0);
+}
+
+TEST(Optional, ReferenceMonadic)
+{
+	std::vector<Tracker> items;
+	items.reserve(2);
+	items.emplace_back(1);
+	items.emplace_back(2);
+	Tracker::reset();
+
+	// an lvalue-returning transform stays a reference
+	bmstu::optional<int&> field =
+		find_tracker(items, 2).transform([](Tracker& t) -> int&
+										 { return t.value; });
+	ASSERT_EQ(&*field, &items[1].value);
+	ASSERT_EQ(find_tracker(items, 2).transform([](const Tracker& t)
+											   { return t.value * 10; })
+				  .value_or(0),
+			  20);
+	ASSERT_EQ(find_tracker(items, 9)
+				  .or_else([&] { return find_tracker(items, 1); })
+				  ->value,
+			  1);
+	ASSERT_EQ(find_tracker(items, 1)
+				  .and_then([&](Tracker& t)
+							{ return find_tracker(items, t.value + 1); })
+				  ->value,
+			  2);
+	Tracker fallback(7);
+	Tracker::reset();
+	ASSERT_EQ(find_tracker(items, 9).value_or(fallback).value, 7);
+	ASSERT_EQ(Tracker::copy_ctor, 1);
+	ASSERT_EQ(Tracker::move_ctor, 0);
+}
+
+TEST(Optional, TransformLvalueDoesNotCopy)
+{
+	bmstu::optional<Tracker> opt(Tracker(5));
+	Tracker::reset();
+	auto doubled = opt.transform([](const Tracker& t) { return t.value * 2; });
+	ASSERT_EQ(*doubled, 10);
+	ASSERT_TRUE(opt.has_value());
+	ASSERT_EQ(Tracker::copy_ctor, 0);
+	ASSERT_EQ(Tracker::move_ctor, 0);
+
+	bmstu::optional<Tracker> empty;
+	ASSERT_FALSE(empty.transform([](const Tracker& t) { return t.value; }));
+}
+
+TEST(Optional, TransformRvalueMoves)
+{
+	bmstu::optional<Tracker> opt(Tracker(5));
+	Tracker::reset();
+	// the result is built in place from the returned prvalue
+	auto moved = std::move(opt).transform([](Tracker&& t)
+										  { return Tracker(std::move(t)); });
+	ASSERT_EQ(moved->value, 5);
+	ASSERT_EQ(Tracker::move_ctor, 1);
+	ASSERT_EQ(Tracker::copy_ctor, 0);
+
+	Tracker::reset();
+	auto made = bmstu::optional<int>(3).transform([](int v)
+												  { return Tracker(v); });
+	ASSERT_EQ(made->value, 3);
+	ASSERT_EQ(Tracker::param_ctor, 1);
+	ASSERT_EQ(Tracker::move_ctor, 0);
+}
+
+TEST(Optional, AndThenChain)
+{
+	auto parse = [](const std::string& str) -> bmstu::optional<int>
+	{
+		if (str.empty() || str.find_first_not_of("0123456789") != str.npos)
+		{
+			return bmstu::nullopt;
+		}
+		return std::stoi(str);
+	};
+	auto half = [](int v) -> bmstu::optional<int>
+	{
+		if (v % 2 != 0)
+		{
+			return bmstu::nullopt;
+		}
+		return v / 2;
+	};
+	bmstu::optional<std::string> input(std::string("42"));
+	ASSERT_EQ(input.and_then(parse).and_then(half).value_or(-1), 21);
+	ASSERT_EQ(bmstu::optional<std::string>(std::string("7"))
+				  .and_then(parse)
+				  .and_then(half)
+				  .value_or(-1),
+			  -1);
+	ASSERT_EQ(bmstu::optional<std::string>().and_then(parse).value_or(-1), -1);
+
+	Z::reset();
+	bmstu::optional<Z> z{Z()};
+	Z::reset();
+	std::move(z).and_then(
+		[](Z&& value)
+		{
+			std::move(value).update();
+			return bmstu::optional<int>(1);
+		});
+	z.and_then(
+		[](Z& value)
+		{
+			value.update();
+			return bmstu::optional<int>(1);
+		});
+	ASSERT_EQ(Z::rvalue_call_count, 1u);
+	ASSERT_EQ(Z::lvalue_call_count, 1u);
+	ASSERT_EQ(Z::copy_ctor, 0u);
+	ASSERT_EQ(Z::move_ctor, 0u);
+}
+
+TEST(Optional, OrElseAndValueOrMove)
+{
+	bmstu::optional<Tracker> opt(Tracker(1));
+	Tracker::reset();
+	Tracker taken = std::move(opt).value_or(Tracker(0));
+	ASSERT_EQ(taken.value, 1);
+	ASSERT_EQ(Tracker::move_ctor, 1);
+	ASSERT_EQ(Tracker::copy_ctor, 0);
+
+	Tracker::reset();
+	bmstu::optional<Tracker> empty;
+	Tracker fallback = empty.value_or(9);
+	ASSERT_EQ(fallback.value, 9);
+	ASSERT_EQ(Tracker::param_ctor, 1);
+	ASSERT_EQ(Tracker::copy_ctor + Tracker::move_ctor, 0);
+
+	Tracker::reset();
+	auto kept = bmstu::optional<Tracker>(Tracker(4)).or_else(
+		[] { return bmstu::optional<Tracker>(Tracker(8)); });
+	ASSERT_EQ(kept->value, 4);
+	ASSERT_EQ(Tracker::copy_ctor, 0);
+
+	auto replaced = bmstu::optional<Tracker>().or_else(
+		[] { return bmstu::optional<Tracker>(Tracker(8)); });
+	ASSERT_EQ(replaced->value, 8);
+	ASSERT_EQ(Tracker::copy_ctor, 0);
+}
+
+namespace
+{
+// Same layout as optional<int> but with user-provided special members, as
+// the class had before they became conditionally trivial
+struct non_trivial_optional
+{
+	non_trivial_optional(int v) : value(v), engaged(true) {}
+	non_trivial_optional(const non_trivial_optional& other)
+		: value(other.value), engaged(other.engaged)
+	{
+	}
+	~non_trivial_optional() {}
+	int value;
+	bool engaged;
+};
+
+[[gnu::noipa]] int take_optional(bmstu::optional<int> opt)
+{
+	return opt.has_value() ? *opt : 0;
+}
+
+[[gnu::noipa]] int take_non_trivial(non_trivial_optional opt)
+{
+	return opt.engaged ? opt.value : 0;
+}
+
+template <typename Func>
+void time_calls(const char* name, Func func)
+{
+	auto start = std::chrono::steady_clock::now();
+	long long sum = 0;
+	for (int i = 0; i < 50'000'000; ++i)
+	{
+		sum += func(i);
+	}
+	auto elapsed = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start);
+	std::cout << name << ": " << elapsed.count() << " ms (checksum " << sum
+			  << ")" << std::endl;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(OptionalBench, DISABLED_PassByValue)
+{
+	time_calls("optional<int> (trivially copyable)",
+			   [](int i) { return take_optional(bmstu::optional<int>(i)); });
+	time_calls("user-provided copy/dtor",
+			   [](int i) { return take_non_trivial(non_trivial_optional(i)); });
+}
@@ -0,0 +1,73 @@
+// The SSO string has its own TU: its bmstu::string clashes with the one
+// from bmstu_string.h that archive_test.cpp uses
+#include "bmstu_archive.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <sstream>
+#include "bmstu_map.h"
+#include "bmstu_simple_vector.h"
+#include "bmstu_sso_string.h"
+
+namespace
+{
+template <typename T>
+bool same(const bmstu::basic_string<T>& lhs, const bmstu::basic_string<T>& rhs)
+{
+	return std::equal(lhs.c_str(), lhs.c_str() + lhs.size(), rhs.c_str(),
+					  rhs.c_str() + rhs.size());
+}
+}  // namespace
+
+TEST(ArchiveSsoStringTest, ShortAndLong)
+{
+	const bmstu::string short_str("short");
+	const bmstu::string long_str("long enough to live on the heap, not inline");
+	const bmstu::wstring wide(L"wide");
+	std::stringstream stream;
+	{
+		bmstu::archive_writer out(stream);
+		out << short_str << long_str << bmstu::string() << wide;
+	}
+	bmstu::archive_reader in(stream);
+	// each target starts out the other way round: long then short, etc.
+	bmstu::string short_copy("a string that starts out on the heap");
+	bmstu::string long_copy("tiny");
+	bmstu::string empty_copy("x");
+	bmstu::wstring wide_copy;
+	in >> short_copy >> long_copy >> empty_copy >> wide_copy;
+	ASSERT_TRUE(same(short_copy, short_str));
+	ASSERT_TRUE(same(long_copy, long_str));
+	ASSERT_TRUE(empty_copy.empty());
+	ASSERT_TRUE(same(wide_copy, wide));
+	ASSERT_EQ(long_copy.c_str()[long_copy.size()], '\0');
+}
+
+TEST(ArchiveSsoStringTest, InsideContainers)
+{
+	bmstu::simple_vector<bmstu::string> words;
+	for (int i = 0; i < 100; ++i)
+	{
+		words.push_back(bmstu::string(static_cast<size_t>(i), 'a' + i % 26));
+	}
+	bmstu::map<int, bmstu::string> names;
+	names[2] = "two";
+	names[1] = "one, but long enough not to fit inline";
+	std::stringstream stream;
+	{
+		bmstu::archive_writer out(stream);
+		out << words << names;
+	}
+	bmstu::archive_reader in(stream);
+	bmstu::simple_vector<bmstu::string> words_copy;
+	bmstu::map<int, bmstu::string> names_copy;
+	in >> words_copy >> names_copy;
+	ASSERT_EQ(words_copy.size(), words.size());
+	for (size_t i = 0; i < words.size(); ++i)
+	{
+		ASSERT_TRUE(same(words_copy[i], words[i]));
+	}
+	ASSERT_EQ(names_copy.size(), 2u);
+	ASSERT_TRUE(same(names_copy.at(1), names.at(1)));
+	ASSERT_TRUE(same(names_copy.at(2), names.at(2)));
+}
@@ -0,0 +1,515 @@
+#include "bmstu_archive.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include "bmstu_list.h"
+#include "bmstu_map.h"
+#include "bmstu_optional.h"
+#include "bmstu_simple_vector.h"
+#include "bmstu_stack.h"
+#include "bmstu_string.h"
+
+namespace
+{
+struct Point
+{
+	int32_t x;
+	int32_t y;
+	double weight;
+
+	bool operator==(const Point& other) const = default;
+};
+
+uint64_t next_random(uint64_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+// Element-wise equality for everything the archive handles, since the
+// strings, map and stack have no operator==
+template <typename T>
+bool same(const T& lhs, const T& rhs);
+template <typename T>
+bool same(const bmstu::simple_basic_string<T>& lhs,
+		  const bmstu::simple_basic_string<T>& rhs);
+template <typename T, typename G, typename A>
+bool same(const bmstu::simple_vector<T, G, A>& lhs,
+		  const bmstu::simple_vector<T, G, A>& rhs);
+template <typename T>
+bool same(const bmstu::list<T>& lhs, const bmstu::list<T>& rhs);
+template <typename K, typename V>
+bool same(const bmstu::map<K, V>& lhs, const bmstu::map<K, V>& rhs);
+template <typename T>
+bool same(const bmstu::stack<T>& lhs, const bmstu::stack<T>& rhs);
+template <typename T>
+bool same(const bmstu::optional<T>& lhs, const bmstu::optional<T>& rhs);
+
+template <typename T>
+bool same(const T& lhs, const T& rhs)
+{
+	return lhs == rhs;
+}
+
+template <typename T>
+bool same(const bmstu::simple_basic_string<T>& lhs,
+		  const bmstu::simple_basic_string<T>& rhs)
+{
+	return std::equal(lhs.c_str(), lhs.c_str() + lhs.size(), rhs.c_str(),
+					  rhs.c_str() + rhs.size());
+}
+
+template <typename Range>
+bool same_range(const Range& lhs, const Range& rhs)
+{
+	return lhs.size() == rhs.size() &&
+		   std::equal(lhs.begin(), lhs.end(), rhs.begin(),
+					  [](const auto& a, const auto& b) { return same(a, b); });
+}
+
+template <typename T, typename G, typename A>
+bool same(const bmstu::simple_vector<T, G, A>& lhs,
+		  const bmstu::simple_vector<T, G, A>& rhs)
+{
+	return same_range(lhs, rhs);
+}
+
+template <typename T>
+bool same(const bmstu::list<T>& lhs, const bmstu::list<T>& rhs)
+{
+	return same_range(lhs, rhs);
+}
+
+template <typename K, typename V>
+bool same(const bmstu::map<K, V>& lhs, const bmstu::map<K, V>& rhs)
+{
+	return lhs.size() == rhs.size() &&
+		   std::equal(lhs.begin(), lhs.end(), rhs.begin(),
+					  [](const auto& a, const auto& b)
+					  {
+						  return a.first == b.first &&
+								 same(a.second, b.second);
+					  });
+}
+
+template <typename T>
+bool same(const bmstu::stack<T>& lhs, const bmstu::stack<T>& rhs)
+{
+	return lhs.size() == rhs.size() &&
+		   std::equal(lhs.data(), lhs.data() + lhs.size(), rhs.data(),
+					  [](const T& a, const T& b) { return same(a, b); });
+}
+
+template <typename T>
+bool same(const bmstu::optional<T>& lhs, const bmstu::optional<T>& rhs)
+{
+	return lhs.has_value() == rhs.has_value() &&
+		   (!lhs.has_value() || same(*lhs, *rhs));
+}
+
+// Writes value to an archive and reads it back into a fresh T
+template <typename T>
+T round_trip(const T& value)
+{
+	std::stringstream stream;
+	{
+		bmstu::archive_writer out(stream);
+		out << value;
+	}
+	bmstu::archive_reader in(stream);
+	return in.read<T>();
+}
+
+// A stringbuf that can't seek, like a pipe's
+class unseekable_buf : public std::stringbuf
+{
+   public:
+	using std::stringbuf::stringbuf;
+
+   protected:
+	pos_type seekoff(off_type, std::ios_base::seekdir,
+					 std::ios_base::openmode) override
+	{
+		return pos_type(-1);
+	}
+
+	pos_type seekpos(pos_type, std::ios_base::openmode) override
+	{
+		return pos_type(-1);
+	}
+};
+
+// An archive of one container whose element count says size, followed by
+// a few bytes of elements; T must fail to load from it, whether the
+// stream can seek or not
+template <typename T>
+void expect_corrupt_size(uint64_t size)
+{
+	std::stringstream stream;
+	{
+		bmstu::archive_writer out(stream);
+		out << size << bmstu::simple_vector<int>(4, 1);
+	}
+	const std::string bytes = stream.str();
+	T value;
+	std::stringstream seekable(bytes);
+	bmstu::archive_reader from_seekable(seekable);
+	ASSERT_THROW(from_seekable >> value, bmstu::archive_error);
+	unseekable_buf buf(bytes);
+	std::istream unseekable(&buf);
+	bmstu::archive_reader from_unseekable(unseekable);
+	ASSERT_THROW(from_unseekable >> value, bmstu::archive_error);
+}
+}  // namespace
+
+TEST(ArchiveTest, RoundTripContainers)
+{
+	bmstu::simple_vector<int> ints(1000);
+	std::iota(ints.begin(), ints.end(), -500);
+	ASSERT_EQ(round_trip(ints), ints);
+	bmstu::simple_vector<Point> points{{1, 2, 0.5}, {-3, 4, 1.5}};
+	ASSERT_EQ(round_trip(points), points);
+	ASSERT_EQ(round_trip(bmstu::simple_vector<double>()).size(), 0u);
+
+	const bmstu::string hello("hello, archive");
+	ASSERT_TRUE(same(round_trip(hello), hello));
+	ASSERT_TRUE(same(round_trip(bmstu::string()), bmstu::string()));
+	const bmstu::u32string wide{U'α', U'β', U'γ'};
+	ASSERT_TRUE(same(round_trip(wide), wide));
+
+	const bmstu::list<bmstu::string> words{"one", "two", "", "three"};
+	ASSERT_TRUE(same(round_trip(words), words));
+
+	bmstu::map<int, bmstu::simple_vector<double>> series;
+	series[3] = {1.0, 2.0};
+	series[-1] = {};
+	series[7] = {0.25};
+	// map can't be moved, so no round_trip()
+	std::stringstream stream;
+	{
+		bmstu::archive_writer out(stream);
+		out << series;
+	}
+	bmstu::archive_reader in(stream);
+	bmstu::map<int, bmstu::simple_vector<double>> series_copy;
+	in >> series_copy;
+	ASSERT_TRUE(same(series_copy, series));
+	ASSERT_EQ(series_copy.begin()->first, -1);
+
+	bmstu::stack<bmstu::string> names;
+	names.push("bottom");
+	names.push("top");
+	auto names_copy = round_trip(names);
+	ASSERT_TRUE(same(names_copy, names));
+	ASSERT_TRUE(same(names_copy.top(), bmstu::string("top")));
+
+	const bmstu::optional<bmstu::string> some(bmstu::string("value"));
+	ASSERT_TRUE(same(round_trip(some), some));
+	const bmstu::optional<int> none;
+	ASSERT_FALSE(round_trip(none).has_value());
+	const bmstu::simple_vector<bmstu::optional<int>> sparse{
+		bmstu::optional<int>(1), bmstu::optional<int>(),
+		bmstu::optional<int>(3)};
+	ASSERT_TRUE(same(round_trip(sparse), sparse));
+}
+
+TEST(ArchiveTest, StreamsValuesInOrder)
+{
+	// bigger than the 64 KB buffer, so it bypasses it both ways
+	bmstu::simple_vector<uint64_t> big(100'000);
+	std::iota(big.begin(), big.end(), 0);
+	std::stringstream stream;
+	{
+		bmstu::archive_writer out(stream);
+		out << 42 << big << bmstu::string("tail") << 2.5;
+	}
+	bmstu::archive_reader in(stream);
+	ASSERT_EQ(in.version(), bmstu::archive_version);
+	int answer = 0;
+	bmstu::simple_vector<uint64_t> big_copy{7, 8, 9};
+	bmstu::string tail;
+	double last = 0;
+	in >> answer >> big_copy >> tail;
+	ASSERT_EQ(in.read<double>(), 2.5);
+	ASSERT_EQ(answer, 42);
+	ASSERT_EQ(big_copy, big);
+	ASSERT_TRUE(same(tail, bmstu::string("tail")));
+	ASSERT_THROW(in >> last, bmstu::archive_error);
+
+	// load replaces what the container held
+	bmstu::list<int> values{1, 2, 3};
+	bmstu::map<int, int> pairs;
+	pairs[5] = 5;
+	std::stringstream again;
+	{
+		bmstu::archive_writer out(again);
+		out << bmstu::list<int>{9} << bmstu::map<int, int>();
+	}
+	bmstu::archive_reader in_again(again);
+	in_again >> values >> pairs;
+	ASSERT_EQ(values, (bmstu::list<int>{9}));
+	ASSERT_TRUE(pairs.empty());
+}
+
+TEST(ArchiveTest, Errors)
+{
+	std::stringstream empty;
+	ASSERT_THROW(bmstu::archive_reader{empty}, bmstu::archive_error);
+
+	std::stringstream text("not an archive at all");
+	ASSERT_THROW(bmstu::archive_reader{text}, bmstu::archive_error);
+
+	std::stringstream newer;
+	const uint32_t header[] = {0x52414D42, bmstu::archive_version + 1};
+	newer.write(reinterpret_cast<const char*>(header), sizeof(header));
+	ASSERT_THROW(bmstu::archive_reader{newer}, bmstu::archive_error);
+
+	std::stringstream truncated;
+	{
+		bmstu::archive_writer out(truncated);
+		out << bmstu::simple_vector<int>(10);
+	}
+	std::string bytes = truncated.str();
+	bytes.resize(bytes.size() - 1);
+	std::stringstream cut(bytes);
+	bmstu::archive_reader in(cut);
+	bmstu::simple_vector<int> values;
+	ASSERT_THROW(in >> values, bmstu::archive_error);
+
+	for (const uint64_t size : {uint64_t{1} << 28, uint64_t{1} << 40})
+	{
+		expect_corrupt_size<bmstu::simple_vector<int>>(size);
+		expect_corrupt_size<bmstu::simple_vector<bmstu::optional<int>>>(size);
+		expect_corrupt_size<bmstu::stack<int>>(size);
+		expect_corrupt_size<bmstu::string>(size);
+	}
+
+	std::ofstream closed;
+	bmstu::archive_writer out(closed);
+	out << 1;
+	ASSERT_THROW(out.flush(), bmstu::archive_error);
+}
+
+TEST(ArchiveTest, UnseekableStream)
+{
+	// big enough that storage has to grow as the data arrives
+	bmstu::simple_vector<uint64_t> big(100'000);
+	std::iota(big.begin(), big.end(), 0);
+	bmstu::simple_vector<bmstu::optional<int>> sparse(50'000);
+	for (size_t i = 0; i < sparse.size(); i += 3)
+	{
+		sparse[i] = static_cast<int>(i);
+	}
+	bmstu::stack<int> pushed;
+	pushed.reserve(70'000);
+	for (int i = 0; i < 70'000; ++i)
+	{
+		pushed.push(i);
+	}
+	bmstu::string text(200'000);
+	text[123'456] = 'y';
+	std::stringstream stream;
+	{
+		bmstu::archive_writer out(stream);
+		out << big << sparse << pushed << text;
+	}
+	unseekable_buf buf(stream.str());
+	std::istream unseekable(&buf);
+	bmstu::archive_reader in(unseekable);
+	bmstu::simple_vector<uint64_t> big_copy;
+	bmstu::simple_vector<bmstu::optional<int>> sparse_copy;
+	bmstu::stack<int> pushed_copy;
+	bmstu::string text_copy;
+	in >> big_copy >> sparse_copy >> pushed_copy >> text_copy;
+	ASSERT_EQ(big_copy, big);
+	ASSERT_TRUE(same(sparse_copy, sparse));
+	ASSERT_TRUE(same(pushed_copy, pushed));
+	ASSERT_TRUE(same(text_copy, text));
+}
+
+TEST(ArchiveTest, RandomRoundTrips)
+{
+	uint64_t state = 88172645463325252ull;
+	const auto random_string = [&]
+	{
+		bmstu::string str;
+		for (uint64_t n = next_random(state) % 20; n > 0; --n)
+		{
+			str += static_cast<char>('a' + next_random(state) % 26);
+		}
+		return str;
+	};
+	for (int round = 0; round < 200; ++round)
+	{
+		bmstu::simple_vector<int64_t> numbers;
+		for (uint64_t n = next_random(state) % 50'000; n > 0; --n)
+		{
+			numbers.push_back(static_cast<int64_t>(next_random(state)));
+		}
+		bmstu::map<int64_t, bmstu::optional<bmstu::list<bmstu::string>>> index;
+		for (uint64_t n = next_random(state) % 50; n > 0; --n)
+		{
+			auto& entry = index[static_cast<int64_t>(next_random(state))];
+			if (next_random(state) % 3 != 0)
+			{
+				auto& words = entry.emplace();
+				for (uint64_t k = next_random(state) % 5; k > 0; --k)
+				{
+					words.push_back(random_string());
+				}
+			}
+		}
+		bmstu::simple_vector<bmstu::stack<bmstu::string>> stacks(
+			next_random(state) % 8);
+		for (bmstu::stack<bmstu::string>& stack : stacks)
+		{
+			for (uint64_t n = next_random(state) % 30; n > 0; --n)
+			{
+				stack.push(random_string());
+			}
+		}
+
+		std::stringstream stream;
+		{
+			bmstu::archive_writer out(stream);
+			out << numbers << index << stacks;
+		}
+		bmstu::archive_reader in(stream);
+		decltype(numbers) numbers_copy;
+		decltype(index) index_copy;
+		decltype(stacks) stacks_copy;
+		in >> numbers_copy >> index_copy >> stacks_copy;
+		ASSERT_TRUE(same(numbers_copy, numbers));
+		ASSERT_TRUE(same(index_copy, index));
+		ASSERT_TRUE(same(stacks_copy, stacks));
+	}
+}
+
+namespace
+{
+// A file in the temp directory, removed on scope exit
+struct temp_file
+{
+	explicit temp_file(const std::string& name)
+		: path(std::filesystem::temp_directory_path() /
+			   (name + "." + std::to_string(::getpid())))
+	{
+	}
+
+	~temp_file()
+	{
+		std::error_code ignored;
+		std::filesystem::remove(path, ignored);
+	}
+
+	std::filesystem::path path;
+};
+
+template <typename Func>
+void throughput(const char* name, size_t bytes, Func func)
+{
+	auto start = std::chrono::steady_clock::now();
+	func();
+	const std::chrono::duration<double> elapsed =
+		std::chrono::steady_clock::now() - start;
+	std::cout << name << ": " << bytes / elapsed.count() / 1e9 << " GB/s ("
+			  << elapsed.count() * 1000 << " ms)" << std::endl;
+}
+
+// Times writing value to the file and reading it back; GB/s are counted
+// in archive bytes
+template <typename T>
+void write_and_read(const char* name, const T& value, const temp_file& file)
+{
+	std::cout << name << std::endl;
+	auto start = std::chrono::steady_clock::now();
+	{
+		std::ofstream os(file.path, std::ios::binary);
+		bmstu::archive_writer out(os);
+		out << value;
+		out.flush();
+	}
+	const std::chrono::duration<double> elapsed =
+		std::chrono::steady_clock::now() - start;
+	const size_t bytes = std::filesystem::file_size(file.path);
+	std::cout << "  write: " << bytes / elapsed.count() / 1e9 << " GB/s ("
+			  << elapsed.count() * 1000 << " ms)" << std::endl;
+	T copy;
+	throughput("  read", bytes,
+			   [&]
+			   {
+				   std::ifstream is(file.path, std::ios::binary);
+				   bmstu::archive_reader in(is);
+				   in >> copy;
+			   });
+	ASSERT_TRUE(same(copy, value));
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(ArchiveBench, DISABLED_Throughput)
+{
+	const temp_file file("archive_bench");
+	uint64_t state = 5;
+	{
+		bmstu::simple_vector<double> doubles;
+		doubles.resize_for_overwrite((size_t{256} << 20) / sizeof(double));
+		for (double& value : doubles)
+		{
+			value = static_cast<double>(next_random(state)) / 3.0;
+		}
+		write_and_read("simple_vector<double>, 256 MB", doubles, file);
+		// what checkpoints did before: text through operator<<
+		throughput("  operator<< text write", doubles.size() * sizeof(double),
+				   [&]
+				   {
+					   std::ofstream os(file.path);
+					   os << doubles;
+				   });
+	}
+	{
+		bmstu::stack<int64_t> stack;
+		stack.reserve(size_t{16} << 20);
+		for (size_t i = 0; i < size_t{16} << 20; ++i)
+		{
+			stack.push(static_cast<int64_t>(next_random(state)));
+		}
+		write_and_read("stack<int64_t>, 16M", stack, file);
+	}
+	{
+		bmstu::simple_vector<bmstu::string> words(4'000'000);
+		for (bmstu::string& word : words)
+		{
+			word = bmstu::string(next_random(state) % 16);
+		}
+		write_and_read("simple_vector<string>, 4M short", words, file);
+	}
+	{
+		bmstu::list<int64_t> values;
+		for (size_t i = 0; i < 4'000'000; ++i)
+		{
+			values.push_back(static_cast<int64_t>(next_random(state)));
+		}
+		write_and_read("list<int64_t>, 4M", values, file);
+	}
+	{
+		bmstu::map<uint32_t, double> pairs;
+		for (uint32_t i = 0; i < 1'000'000; ++i)
+		{
+			pairs.insert(static_cast<uint32_t>(next_random(state)), 1.0);
+		}
+		write_and_read("map<uint32_t, double>, 1M", pairs, file);
+	}
+}
@@ -0,0 +1,582 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "array_ptr.h"
+#include "bmstu_list.h"
+#include "bmstu_map.h"
+#include "bmstu_optional.h"
+#include "bmstu_simple_vector.h"
+#include "bmstu_stack.h"
+
+// Versioned binary archives for the bmstu containers.
+//
+// archive_writer streams values to a std::ostream and archive_reader reads
+// them back in the same order:
+//
+//   archive_writer out(file);
+//   out << vec << names;
+//   ...
+//   archive_reader in(file);
+//   in >> vec >> names;
+//
+// An archive starts with a magic number and the format version. Values
+// follow with no framing: a trivially copyable value is its bytes, a
+// container is its element count as uint64_t and then its elements, an
+// optional is a flag byte and then the value if there is one. All of it is
+// in native byte order, so an archive is meant to be read on the kind of
+// machine that wrote it; the other byte order fails the magic check.
+//
+// Trivially copyable elements of simple_vector and of the strings move as
+// one block between the stream and the element storage. Anything else goes
+// through a 64 KB buffer value by value.
+//
+// Element counts read back are not trusted: a container is sized up front
+// only once the stream shows it holds that much data, otherwise storage
+// grows as the elements arrive. A corrupt count then ends in archive_error
+// instead of a huge allocation.
+//
+// Other types plug in through save(archive_writer&, const X&) and
+// load(archive_reader&, X&) overloads in the type's namespace.
+namespace bmstu
+{
+// Both string headers define bmstu::string, so neither is included here;
+// the caller includes the one it uses
+template <typename T>
+class simple_basic_string;
+
+template <typename T>
+class basic_string;
+
+class archive_error : public std::runtime_error
+{
+   public:
+	using runtime_error::runtime_error;
+};
+
+// Written by archive_writer; archive_reader takes this version and older
+constexpr uint32_t archive_version = 1;
+
+namespace
+{
+// "BMAR" when read as little-endian
+constexpr uint32_t archive_magic = 0x52414D42;
+
+constexpr size_t archive_buffer_size = size_t{1} << 16;
+
+constexpr size_t archive_size_unknown = std::numeric_limits<size_t>::max();
+
+template <typename T>
+struct is_optional : std::false_type
+{
+};
+
+template <typename T>
+struct is_optional<optional<T>> : std::true_type
+{
+};
+}  // namespace
+
+// Values stored as their bytes. optional is left out even when it is
+// trivially copyable, so that an empty one doesn't store garbage.
+template <typename T>
+concept bitwise_serializable =
+	std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> &&
+	!std::is_member_pointer_v<T> && !is_optional<std::remove_cv_t<T>>::value;
+
+class archive_writer
+{
+   public:
+	// Writes the archive header
+	explicit archive_writer(std::ostream& os)
+		: os_(os), buffer_(archive_buffer_size)
+	{
+		const uint32_t header[] = {archive_magic, archive_version};
+		write_bytes(header, sizeof(header));
+	}
+
+	archive_writer(const archive_writer& other) = delete;
+
+	archive_writer& operator=(const archive_writer& other) = delete;
+
+	// Errors can't be reported from here; flush() first to see them
+	~archive_writer()
+	{
+		try
+		{
+			write_buffer();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	template <typename T>
+	archive_writer& operator<<(const T& value)
+	{
+		save(*this, value);
+		return *this;
+	}
+
+	// Blocks at least as big as the buffer go to the stream directly
+	void write_bytes(const void* data, size_t n)
+	{
+		if (n > archive_buffer_size - used_)
+		{
+			write_buffer();
+			if (n >= archive_buffer_size)
+			{
+				write_stream(data, n);
+				return;
+			}
+		}
+		if (n > 0)
+		{
+			std::memcpy(buffer_.get() + used_, data, n);
+			used_ += n;
+		}
+	}
+
+	// Hands everything written so far to the stream and flushes it
+	void flush()
+	{
+		write_buffer();
+		if (!os_.flush())
+		{
+			throw archive_error("Failed to write archive");
+		}
+	}
+
+   private:
+	void write_buffer()
+	{
+		const size_t used = std::exchange(used_, 0);
+		if (used > 0)
+		{
+			write_stream(buffer_.get(), used);
+		}
+	}
+
+	void write_stream(const void* data, size_t n)
+	{
+		if (!os_.write(static_cast<const char*>(data),
+					   static_cast<std::streamsize>(n)))
+		{
+			throw archive_error("Failed to write archive");
+		}
+	}
+
+	std::ostream& os_;
+	array_ptr<char> buffer_;
+	size_t used_ = 0;
+};
+
+// Reads ahead of what has been asked for, so the stream is left somewhere
+// past the last value read
+class archive_reader
+{
+   public:
+	// Reads and checks the archive header
+	explicit archive_reader(std::istream& is)
+		: is_(is), buffer_(archive_buffer_size)
+	{
+		uint32_t header[2];
+		read_bytes(header, sizeof(header));
+		if (header[0] != archive_magic)
+		{
+			throw archive_error("Not a bmstu archive");
+		}
+		if (header[1] == 0 || header[1] > archive_version)
+		{
+			throw archive_error("Unsupported archive version");
+		}
+		version_ = header[1];
+	}
+
+	archive_reader(const archive_reader& other) = delete;
+
+	archive_reader& operator=(const archive_reader& other) = delete;
+
+	template <typename T>
+	archive_reader& operator>>(T& value)
+	{
+		load(*this, value);
+		return *this;
+	}
+
+	template <typename T>
+	T read()
+	{
+		T value;
+		load(*this, value);
+		return value;
+	}
+
+	// Blocks at least as big as the buffer come from the stream directly
+	void read_bytes(void* data, size_t n)
+	{
+		char* to = static_cast<char*>(data);
+		const size_t buffered = std::min(n, end_ - pos_);
+		if (buffered > 0)
+		{
+			std::memcpy(to, buffer_.get() + pos_, buffered);
+			pos_ += buffered;
+			to += buffered;
+			n -= buffered;
+		}
+		if (n == 0)
+		{
+			return;
+		}
+		if (n >= archive_buffer_size)
+		{
+			read_stream(to, n);
+			return;
+		}
+		is_.read(buffer_.get(), static_cast<std::streamsize>(
+									archive_buffer_size));
+		pos_ = 0;
+		end_ = static_cast<size_t>(is_.gcount());
+		if (end_ < n)
+		{
+			throw archive_error("Unexpected end of archive");
+		}
+		std::memcpy(to, buffer_.get(), n);
+		pos_ = n;
+	}
+
+	// Format version of the archive being read
+	uint32_t version() const noexcept { return version_; }
+
+	// Bytes left to read, or archive_size_unknown if the stream can't tell
+	// without reading them (it can't seek and hasn't hit its end)
+	size_t bytes_left()
+	{
+		const size_t buffered = end_ - pos_;
+		if (is_.eof())
+		{
+			return buffered;
+		}
+		const std::streampos here = is_.tellg();
+		if (here == std::streampos(-1))
+		{
+			return archive_size_unknown;
+		}
+		is_.seekg(0, std::ios::end);
+		const std::streampos end = is_.tellg();
+		if (!is_.seekg(here) || end == std::streampos(-1))
+		{
+			throw archive_error("Failed to read archive");
+		}
+		return buffered + static_cast<size_t>(end - here);
+	}
+
+   private:
+	void read_stream(char* data, size_t n)
+	{
+		is_.read(data, static_cast<std::streamsize>(n));
+		if (static_cast<size_t>(is_.gcount()) != n)
+		{
+			throw archive_error("Unexpected end of archive");
+		}
+	}
+
+	std::istream& is_;
+	array_ptr<char> buffer_;
+	size_t pos_ = 0;
+	size_t end_ = 0;
+	uint32_t version_ = 0;
+};
+
+template <typename T>
+	requires bitwise_serializable<T>
+void save(archive_writer& ar, const T& value)
+{
+	ar.write_bytes(std::addressof(value), sizeof(T));
+}
+
+template <typename T>
+	requires bitwise_serializable<T>
+void load(archive_reader& ar, T& value)
+{
+	ar.read_bytes(std::addressof(value), sizeof(T));
+}
+
+namespace
+{
+inline void save_size(archive_writer& ar, size_t size)
+{
+	save(ar, static_cast<uint64_t>(size));
+}
+
+inline size_t load_size(archive_reader& ar)
+{
+	const uint64_t size = ar.read<uint64_t>();
+	if (size > std::numeric_limits<size_t>::max())
+	{
+		throw archive_error("Archived size does not fit in size_t");
+	}
+	return static_cast<size_t>(size);
+}
+
+// How many of the left elements of T to make room for next, with loaded
+// already in. All of them if that's under a buffer's worth or the stream
+// has room for them; otherwise as many as are loaded, so that storage
+// grows with the data read.
+template <typename T>
+size_t next_batch(archive_reader& ar, size_t loaded, size_t left)
+{
+	const size_t step =
+		std::max({loaded, archive_buffer_size / sizeof(T), size_t{1}});
+	if (left <= step)
+	{
+		return left;
+	}
+	const size_t bytes = ar.bytes_left();
+	if (bytes == archive_size_unknown)
+	{
+		return step;
+	}
+	if constexpr (bitwise_serializable<T>)
+	{
+		if (left > bytes / sizeof(T))
+		{
+			throw archive_error("Unexpected end of archive");
+		}
+		return left;
+	}
+	else
+	{
+		// everything saved here takes at least a byte, but a save()
+		// overload might not, so this only caps the batch
+		return std::min(left, std::max(step, bytes));
+	}
+}
+
+// Runs grow(), which allocates for archived elements; running out of
+// memory there means a count too big to load
+template <typename Grow>
+void make_room(Grow grow)
+{
+	try
+	{
+		grow();
+	}
+	catch (const std::bad_alloc&)
+	{
+		throw archive_error("Archived size is too large");
+	}
+	catch (const std::length_error&)
+	{
+		throw archive_error("Archived size is too large");
+	}
+}
+
+template <typename T, typename Growth, typename Allocator>
+void load_elements(archive_reader& ar,
+				   simple_vector<T, Growth, Allocator>& vec,
+				   size_t size)
+{
+	vec.clear();
+	while (vec.size() < size)
+	{
+		const size_t loaded = vec.size();
+		const size_t batch = next_batch<T>(ar, loaded, size - loaded);
+		if constexpr (bitwise_serializable<T>)
+		{
+			make_room([&] { vec.resize_for_overwrite(loaded + batch); });
+			ar.read_bytes(vec.data() + loaded, batch * sizeof(T));
+		}
+		else
+		{
+			make_room([&] { vec.resize(loaded + batch); });
+			for (size_t i = loaded; i < loaded + batch; ++i)
+			{
+				load(ar, vec[i]);
+			}
+		}
+	}
+}
+
+// The strings can't grow as data arrives, so a long one the stream can't
+// vouch for is read into a simple_vector first
+template <typename T, typename String>
+void load_string(archive_reader& ar, String& str)
+{
+	const size_t size = load_size(ar);
+	if (next_batch<T>(ar, 0, size) == size)
+	{
+		make_room([&] { str = String(size); });
+		ar.read_bytes(&str[0], size * sizeof(T));
+		return;
+	}
+	simple_vector<T> chars;
+	load_elements(ar, chars, size);
+	make_room([&] { str = String(size); });
+	std::copy_n(chars.data(), size, &str[0]);
+}
+
+template <typename T>
+void save_elements(archive_writer& ar, const T* data, size_t n)
+{
+	if constexpr (bitwise_serializable<T>)
+	{
+		ar.write_bytes(data, n * sizeof(T));
+	}
+	else
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			save(ar, data[i]);
+		}
+	}
+}
+}  // namespace
+
+template <typename T>
+void save(archive_writer& ar, const optional<T>& value)
+{
+	save(ar, static_cast<uint8_t>(value.has_value()));
+	if (value.has_value())
+	{
+		save(ar, *value);
+	}
+}
+
+template <typename T>
+void load(archive_reader& ar, optional<T>& value)
+{
+	if (ar.read<uint8_t>() != 0)
+	{
+		load(ar, value.emplace());
+	}
+	else
+	{
+		value.reset();
+	}
+}
+
+template <typename T, typename Growth, typename Allocator>
+void save(archive_writer& ar, const simple_vector<T, Growth, Allocator>& vec)
+{
+	save_size(ar, vec.size());
+	save_elements(ar, vec.data(), vec.size());
+}
+
+template <typename T, typename Growth, typename Allocator>
+void load(archive_reader& ar, simple_vector<T, Growth, Allocator>& vec)
+{
+	load_elements(ar, vec, load_size(ar));
+}
+
+template <typename T>
+void save(archive_writer& ar, const list<T>& values)
+{
+	save_size(ar, values.size());
+	for (const T& value : values)
+	{
+		save(ar, value);
+	}
+}
+
+template <typename T>
+void load(archive_reader& ar, list<T>& values)
+{
+	const size_t size = load_size(ar);
+	values.clear();
+	for (size_t i = 0; i < size; ++i)
+	{
+		T value;
+		load(ar, value);
+		values.push_back(std::move(value));
+	}
+}
+
+// Pairs in key order
+template <typename K, typename V>
+void save(archive_writer& ar, const map<K, V>& values)
+{
+	save_size(ar, values.size());
+	for (const auto& [key, value] : values)
+	{
+		save(ar, key);
+		save(ar, value);
+	}
+}
+
+template <typename K, typename V>
+void load(archive_reader& ar, map<K, V>& values)
+{
+	const size_t size = load_size(ar);
+	values.clear();
+	for (size_t i = 0; i < size; ++i)
+	{
+		K key;
+		V value;
+		load(ar, key);
+		load(ar, value);
+		values.insert(key, value);
+	}
+}
+
+// Elements from the bottom up
+template <typename T>
+void save(archive_writer& ar, const stack<T>& values)
+{
+	save_size(ar, values.size());
+	save_elements(ar, values.data(), values.size());
+}
+
+template <typename T>
+void load(archive_reader& ar, stack<T>& values)
+{
+	const size_t size = load_size(ar);
+	values.clear();
+	for (size_t loaded = 0; loaded < size;)
+	{
+		const size_t batch = next_batch<T>(ar, loaded, size - loaded);
+		make_room([&] { values.reserve(loaded + batch); });
+		for (const size_t end = loaded + batch; loaded < end; ++loaded)
+		{
+			T value;
+			load(ar, value);
+			values.push(std::move(value));
+		}
+	}
+}
+
+template <typename T>
+void save(archive_writer& ar, const simple_basic_string<T>& str)
+{
+	save_size(ar, str.size());
+	save_elements(ar, str.c_str(), str.size());
+}
+
+template <typename T>
+void load(archive_reader& ar, simple_basic_string<T>& str)
+{
+	load_string<T>(ar, str);
+}
+
+template <typename T>
+void save(archive_writer& ar, const basic_string<T>& str)
+{
+	save_size(ar, str.size());
+	save_elements(ar, str.c_str(), str.size());
+}
+
+template <typename T>
+void load(archive_reader& ar, basic_string<T>& str)
+{
+	load_string<T>(ar, str);
+}
+}  // namespace bmstu
@@ -0,0 +1,265 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "array_ptr.h"
+
+namespace bmstu
+{
+// Grow-only vector that many threads may push_back into at once. A push
+// takes its index with one fetch_add and never waits for other pushes:
+// storage comes in segments of first_segment, 2 * first_segment, ...
+// elements, like segmented_vector, so an element never moves once built.
+//
+// An element is published when it and every element before it are built.
+// size() is the published count, and indexes below it can be read from
+// any thread while pushes go on. Destruction and clear() must not race
+// with anything.
+template <typename T>
+class concurrent_vector
+{
+	static constexpr size_t first_segment = 16;
+	static constexpr int first_shift = std::countr_zero(first_segment);
+	static constexpr size_t max_segments = 64 - first_shift;
+
+	// Separate cache lines for the counters, so pushes bumping reserved_
+	// don't invalidate the line readers poll
+	static constexpr size_t cache_line = 64;
+
+	struct segment
+	{
+		explicit segment(size_t size)
+			: values(size), ready(std::make_unique<std::atomic<bool>[]>(size))
+		{
+		}
+
+		array_ptr<T> values;
+		std::unique_ptr<std::atomic<bool>[]> ready;
+	};
+
+   public:
+	// Published elements at one moment: later pushes don't change it, and
+	// its elements stay put while the vector lives
+	class snapshot
+	{
+	   public:
+		class iterator
+		{
+		   public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using pointer = const T*;
+			using reference = const T&;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() = default;
+
+			iterator(const concurrent_vector* owner, size_t index)
+				: owner_(owner), index_(index)
+			{
+			}
+
+			reference operator*() const { return (*owner_)[index_]; }
+
+			pointer operator->() const { return &(*owner_)[index_]; }
+
+			iterator& operator++()
+			{
+				++index_;
+				return *this;
+			}
+
+			iterator operator++(int)
+			{
+				iterator copy(*this);
+				++index_;
+				return copy;
+			}
+
+			friend bool operator==(const iterator& lhs, const iterator& rhs)
+			{
+				return lhs.index_ == rhs.index_;
+			}
+
+		   private:
+			const concurrent_vector* owner_ = nullptr;
+			size_t index_ = 0;
+		};
+
+		snapshot(const concurrent_vector& owner, size_t size)
+			: owner_(&owner), size_(size)
+		{
+		}
+
+		iterator begin() const noexcept { return iterator(owner_, 0); }
+
+		iterator end() const noexcept { return iterator(owner_, size_); }
+
+		size_t size() const noexcept { return size_; }
+
+		bool empty() const noexcept { return size_ == 0; }
+
+		const T& operator[](size_t index) const { return (*owner_)[index]; }
+
+	   private:
+		const concurrent_vector* owner_;
+		size_t size_;
+	};
+
+	concurrent_vector() noexcept = default;
+
+	concurrent_vector(const concurrent_vector& other) = delete;
+
+	concurrent_vector& operator=(const concurrent_vector& other) = delete;
+
+	~concurrent_vector()
+	{
+		clear();
+		for (std::atomic<segment*>& slot : segments_)
+		{
+			delete slot.load(std::memory_order_relaxed);
+		}
+	}
+
+	// Lock-free: a throwing constructor runs before an index is taken, so
+	// a taken index always ends up published. Failing to allocate a segment
+	// after that terminates.
+	template <typename... Args>
+	T& emplace_back(Args&&... args)
+	{
+		if constexpr (std::is_nothrow_constructible_v<T, Args...>)
+		{
+			return place(std::forward<Args>(args)...);
+		}
+		else
+		{
+			static_assert(std::is_nothrow_move_constructible_v<T>,
+						  "concurrent_vector needs a noexcept move");
+			T value(std::forward<Args>(args)...);
+			return place(std::move(value));
+		}
+	}
+
+	T& push_back(const T& value) { return emplace_back(value); }
+
+	T& push_back(T&& value) { return emplace_back(std::move(value)); }
+
+	// Safe for index < size() while other threads push
+	const T& operator[](size_t index) const noexcept
+	{
+		const auto [chunk, offset] = locate(index);
+		return segments_[chunk].load(std::memory_order_acquire)->values[offset];
+	}
+
+	T& operator[](size_t index) noexcept
+	{
+		const auto [chunk, offset] = locate(index);
+		return segments_[chunk].load(std::memory_order_acquire)->values[offset];
+	}
+
+	const T& at(size_t index) const
+	{
+		if (index >= size())
+		{
+			throw std::out_of_range("Index out of range");
+		}
+		return (*this)[index];
+	}
+
+	// Published elements. Walks past elements built since the last call and
+	// moves the shared count forward, so each element is checked about once.
+	size_t size() const noexcept
+	{
+		size_t published = published_.load(std::memory_order_acquire);
+		size_t next = published;
+		while (is_ready(next))
+		{
+			++next;
+		}
+		while (published < next &&
+			   !published_.compare_exchange_weak(published, next,
+												 std::memory_order_release,
+												 std::memory_order_acquire))
+		{
+		}
+		return std::max(published, next);
+	}
+
+	bool empty() const noexcept { return size() == 0; }
+
+	snapshot elements() const noexcept { return snapshot(*this, size()); }
+
+	// Keeps the segments; no push or read may run at the same time
+	void clear() noexcept
+	{
+		const size_t count = reserved_.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const auto [chunk, offset] = locate(i);
+			segment* seg = segments_[chunk].load(std::memory_order_relaxed);
+			std::destroy_at(seg->values.get() + offset);
+			seg->ready[offset].store(false, std::memory_order_relaxed);
+		}
+		reserved_.store(0, std::memory_order_relaxed);
+		published_.store(0, std::memory_order_relaxed);
+	}
+
+   private:
+	// Same split as segmented_vector: segment k starts at
+	// first_segment * (2^k - 1)
+	static std::pair<size_t, size_t> locate(size_t index) noexcept
+	{
+		const size_t pos = index + first_segment;
+		const size_t chunk = std::bit_width(pos) - 1 - first_shift;
+		return {chunk, pos - (first_segment << chunk)};
+	}
+
+	template <typename... Args>
+	T& place(Args&&... args) noexcept
+	{
+		const size_t index = reserved_.fetch_add(1, std::memory_order_relaxed);
+		const auto [chunk, offset] = locate(index);
+		segment* seg = segment_for(chunk);
+		T* slot = std::construct_at(seg->values.get() + offset,
+									std::forward<Args>(args)...);
+		seg->ready[offset].store(true, std::memory_order_release);
+		return *slot;
+	}
+
+	// Threads that find the segment missing each allocate one, the first
+	// to install it wins and the others free theirs
+	segment* segment_for(size_t chunk) noexcept
+	{
+		segment* seg = segments_[chunk].load(std::memory_order_acquire);
+		if (seg == nullptr)
+		{
+			auto fresh = std::make_unique<segment>(first_segment << chunk);
+			if (segments_[chunk].compare_exchange_strong(
+					seg, fresh.get(), std::memory_order_acq_rel,
+					std::memory_order_acquire))
+			{
+				seg = fresh.release();
+			}
+		}
+		return seg;
+	}
+
+	bool is_ready(size_t index) const noexcept
+	{
+		const auto [chunk, offset] = locate(index);
+		const segment* seg = segments_[chunk].load(std::memory_order_acquire);
+		return seg != nullptr &&
+			   seg->ready[offset].load(std::memory_order_acquire);
+	}
+
+	std::atomic<segment*> segments_[max_segments] = {};
+	alignas(cache_line) std::atomic<size_t> reserved_ = 0;
+	alignas(cache_line) mutable std::atomic<size_t> published_ = 0;
+};
+}  // namespace bmstu
@@ -0,0 +1,173 @@
+#include "bmstu_concurrent_vector.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bmstu_simple_vector.h"
+
+TEST(ConcurrentVectorTest, SingleThread)
+{
+	bmstu::concurrent_vector<std::string> v;
+	ASSERT_TRUE(v.empty());
+	for (int i = 0; i < 100; ++i)
+	{
+		v.push_back(std::to_string(i));
+	}
+	ASSERT_EQ(v.size(), 100u);
+	ASSERT_EQ(v[42], "42");
+	ASSERT_EQ(v.at(99), "99");
+	ASSERT_THROW(v.at(100), std::out_of_range);
+
+	auto snapshot = v.elements();
+	v.emplace_back(3, 'x');
+	ASSERT_EQ(snapshot.size(), 100u);
+	ASSERT_EQ(v.size(), 101u);
+	int count = 0;
+	for (const std::string& value : snapshot)
+	{
+		ASSERT_EQ(value, std::to_string(count++));
+	}
+	ASSERT_EQ(count, 100);
+
+	v.clear();
+	ASSERT_TRUE(v.empty());
+	v.push_back("again");
+	ASSERT_EQ(v.at(0), "again");
+}
+
+TEST(ConcurrentVectorTest, StableAddresses)
+{
+	bmstu::concurrent_vector<int> v;
+	const int* first = &v.push_back(1);
+	for (int i = 0; i < 10'000; ++i)
+	{
+		v.push_back(i);
+	}
+	ASSERT_EQ(&v[0], first);
+	ASSERT_EQ(*first, 1);
+}
+
+TEST(ConcurrentVectorTest, ThrowingConstructorTakesNoIndex)
+{
+	bmstu::concurrent_vector<std::string> v;
+	v.push_back("a");
+	ASSERT_THROW(v.emplace_back(std::string::npos, 'x'), std::length_error);
+	v.push_back("b");
+	ASSERT_EQ(v.size(), 2u);
+	ASSERT_EQ(v[1], "b");
+}
+
+// Producers push (thread, sequence) pairs while a reader walks snapshots.
+// Build with -fsanitize=thread to check the memory ordering.
+TEST(ConcurrentVectorTest, ConcurrentPushAndRead)
+{
+	constexpr size_t producers = 4;
+	constexpr size_t per_producer = 20'000;
+	bmstu::concurrent_vector<size_t> v;
+	std::atomic<size_t> finished = 0;
+	std::atomic<bool> reader_failed = false;
+
+	std::thread reader(
+		[&]
+		{
+			while (finished.load() < producers)
+			{
+				std::vector<size_t> last(producers, 0);
+				for (size_t value : v.elements())
+				{
+					// each producer's values appear in the order it pushed
+					const size_t thread = value / per_producer;
+					const size_t sequence = value % per_producer + 1;
+					if (thread >= producers || sequence <= last[thread])
+					{
+						reader_failed = true;
+					}
+					last[thread] = sequence;
+				}
+			}
+		});
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < producers; ++t)
+	{
+		threads.emplace_back(
+			[&, t]
+			{
+				for (size_t i = 0; i < per_producer; ++i)
+				{
+					v.push_back(t * per_producer + i);
+				}
+				++finished;
+			});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	reader.join();
+
+	ASSERT_FALSE(reader_failed.load());
+	ASSERT_EQ(v.size(), producers * per_producer);
+	std::vector<bool> seen(producers * per_producer, false);
+	for (size_t value : v.elements())
+	{
+		ASSERT_FALSE(seen[value]);
+		seen[value] = true;
+	}
+}
+
+namespace
+{
+template <typename Push>
+void time_threads(const char* name, size_t thread_count, Push push)
+{
+	constexpr size_t total = 8'000'000;
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < thread_count; ++t)
+	{
+		threads.emplace_back(
+			[&]
+			{
+				for (size_t i = 0; i < total / thread_count; ++i)
+				{
+					push(i);
+				}
+			});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	auto elapsed = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start);
+	std::cout << name << ", " << thread_count
+			  << " threads: " << elapsed.count() << " ms" << std::endl;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(ConcurrentVectorBench, DISABLED_PushScaling)
+{
+	std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+			  << std::endl;
+	for (size_t thread_count : {1, 2, 4, 8})
+	{
+		bmstu::concurrent_vector<size_t> lock_free;
+		time_threads("concurrent_vector, 8M push_back", thread_count,
+					 [&](size_t i) { lock_free.push_back(i); });
+		bmstu::simple_vector<size_t> locked;
+		std::mutex mutex;
+		time_threads("mutex + simple_vector, 8M push_back", thread_count,
+					 [&](size_t i)
+					 {
+						 std::lock_guard lock(mutex);
+						 locked.push_back(i);
+					 });
+	}
+}
@@ -0,0 +1,529 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include "array_ptr.h"
+#include "bmstu_popcount.h"
+#include "bmstu_simple_vector.h"
+
+namespace bmstu
+{
+// Resizable bit array: 64 flags per uint64_t word instead of a byte each.
+// Set operations go a word at a time, and searches skip zero words and
+// take the lowest set bit with countr_zero (tzcnt). Bits past size() in
+// the last word are always zero, so counting and comparing can use whole
+// words.
+class dynamic_bitset
+{
+	static constexpr size_t word_bits = 64;
+
+   public:
+	static constexpr size_t npos = static_cast<size_t>(-1);
+
+	// Stands for one bit: reads and writes go to the word it lives in
+	class reference
+	{
+	   public:
+		reference(uint64_t* word, uint64_t mask) noexcept
+			: word_(word), mask_(mask)
+		{
+		}
+
+		reference(const reference& other) = default;
+
+		reference& operator=(bool value) noexcept
+		{
+			if (value)
+			{
+				*word_ |= mask_;
+			}
+			else
+			{
+				*word_ &= ~mask_;
+			}
+			return *this;
+		}
+
+		reference& operator=(const reference& other) noexcept
+		{
+			return *this = static_cast<bool>(other);
+		}
+
+		operator bool() const noexcept { return (*word_ & mask_) != 0; }
+
+		bool operator~() const noexcept { return !static_cast<bool>(*this); }
+
+		reference& flip() noexcept
+		{
+			*word_ ^= mask_;
+			return *this;
+		}
+
+	   private:
+		uint64_t* word_;
+		uint64_t mask_;
+	};
+
+	// Positions of the set bits in increasing order. Keeps a copy of the
+	// current word and clears its lowest bit on every step.
+	class set_bit_iterator
+	{
+	   public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = size_t;
+		using reference = size_t;
+		using difference_type = std::ptrdiff_t;
+
+		set_bit_iterator() = default;
+
+		set_bit_iterator(const uint64_t* words, size_t word_count,
+						 size_t word_index) noexcept
+			: words_(words), word_count_(word_count), word_index_(word_index)
+		{
+			if (word_index_ < word_count_)
+			{
+				bits_ = words_[word_index_];
+				skip_zero_words();
+			}
+		}
+
+		size_t operator*() const noexcept
+		{
+			return word_index_ * word_bits + std::countr_zero(bits_);
+		}
+
+		set_bit_iterator& operator++() noexcept
+		{
+			bits_ &= bits_ - 1;
+			skip_zero_words();
+			return *this;
+		}
+
+		set_bit_iterator operator++(int) noexcept
+		{
+			set_bit_iterator copy(*this);
+			++*this;
+			return copy;
+		}
+
+		friend bool operator==(const set_bit_iterator& lhs,
+							   const set_bit_iterator& rhs)
+		{
+			return lhs.word_index_ == rhs.word_index_ &&
+				   lhs.bits_ == rhs.bits_;
+		}
+
+	   private:
+		void skip_zero_words() noexcept
+		{
+			while (bits_ == 0 && ++word_index_ < word_count_)
+			{
+				bits_ = words_[word_index_];
+			}
+		}
+
+		const uint64_t* words_ = nullptr;
+		size_t word_count_ = 0;
+		size_t word_index_ = 0;
+		uint64_t bits_ = 0;
+	};
+
+	class set_bit_range
+	{
+	   public:
+		set_bit_range(const uint64_t* words, size_t word_count) noexcept
+			: words_(words), word_count_(word_count)
+		{
+		}
+
+		set_bit_iterator begin() const noexcept
+		{
+			return set_bit_iterator(words_, word_count_, 0);
+		}
+
+		set_bit_iterator end() const noexcept
+		{
+			return set_bit_iterator(words_, word_count_, word_count_);
+		}
+
+	   private:
+		const uint64_t* words_;
+		size_t word_count_;
+	};
+
+	dynamic_bitset() noexcept = default;
+
+	explicit dynamic_bitset(size_t size, bool value = false)
+	{
+		resize(size, value);
+	}
+
+	dynamic_bitset(std::initializer_list<bool> init)
+	{
+		reserve(init.size());
+		for (bool value : init)
+		{
+			push_back(value);
+		}
+	}
+
+	dynamic_bitset(const dynamic_bitset& other)
+		: words_(word_count(other.size_)),
+		  size_(other.size_),
+		  word_capacity_(word_count(other.size_))
+	{
+		std::copy_n(other.words_.get(), word_capacity_, words_.get());
+	}
+
+	dynamic_bitset(dynamic_bitset&& other) noexcept { swap(other); }
+
+	dynamic_bitset& operator=(const dynamic_bitset& other)
+	{
+		if (this != &other)
+		{
+			dynamic_bitset copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	dynamic_bitset& operator=(dynamic_bitset&& other) noexcept
+	{
+		if (this != &other)
+		{
+			dynamic_bitset moved(std::move(other));
+			swap(moved);
+		}
+		return *this;
+	}
+
+	void swap(dynamic_bitset& other) noexcept
+	{
+		words_.swap(other.words_);
+		std::swap(size_, other.size_);
+		std::swap(word_capacity_, other.word_capacity_);
+	}
+
+	friend void swap(dynamic_bitset& lhs, dynamic_bitset& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+	size_t size() const noexcept { return size_; }
+
+	size_t capacity() const noexcept { return word_capacity_ * word_bits; }
+
+	bool empty() const noexcept { return size_ == 0; }
+
+	// The packed words, bit i is bit i % 64 of word i / 64
+	const uint64_t* data() const noexcept { return words_.get(); }
+
+	size_t word_size() const noexcept { return word_count(size_); }
+
+	reference operator[](size_t index) noexcept
+	{
+		return reference(words_.get() + index / word_bits, mask(index));
+	}
+
+	bool operator[](size_t index) const noexcept
+	{
+		return (words_[index / word_bits] & mask(index)) != 0;
+	}
+
+	bool test(size_t index) const
+	{
+		check_index(index);
+		return (*this)[index];
+	}
+
+	dynamic_bitset& set(size_t index, bool value = true)
+	{
+		check_index(index);
+		(*this)[index] = value;
+		return *this;
+	}
+
+	dynamic_bitset& reset(size_t index) { return set(index, false); }
+
+	dynamic_bitset& flip(size_t index)
+	{
+		check_index(index);
+		(*this)[index].flip();
+		return *this;
+	}
+
+	dynamic_bitset& set() noexcept
+	{
+		std::fill_n(words_.get(), word_size(), ~uint64_t{0});
+		clear_tail();
+		return *this;
+	}
+
+	dynamic_bitset& reset() noexcept
+	{
+		std::fill_n(words_.get(), word_size(), uint64_t{0});
+		return *this;
+	}
+
+	dynamic_bitset& flip() noexcept
+	{
+		uint64_t* words = words_.get();
+		for (size_t i = 0, n = word_size(); i < n; ++i)
+		{
+			words[i] = ~words[i];
+		}
+		clear_tail();
+		return *this;
+	}
+
+	void reserve(size_t bits)
+	{
+		if (word_count(bits) > word_capacity_)
+		{
+			reallocate(word_count(bits));
+		}
+	}
+
+	void resize(size_t new_size, bool value = false)
+	{
+		if (new_size > size_)
+		{
+			const size_t words = word_count(new_size);
+			if (words > word_capacity_)
+			{
+				reallocate(growth_x2::next_capacity(word_capacity_, words));
+			}
+			const uint64_t fill = value ? ~uint64_t{0} : 0;
+			const size_t used = word_size();
+			// the free bits of the last used word are zero
+			if (value && size_ % word_bits != 0)
+			{
+				words_[used - 1] |= ~uint64_t{0} << (size_ % word_bits);
+			}
+			std::fill(words_.get() + used, words_.get() + words, fill);
+		}
+		size_ = new_size;
+		clear_tail();
+	}
+
+	void push_back(bool value)
+	{
+		if (size_ % word_bits == 0)
+		{
+			if (word_size() == word_capacity_)
+			{
+				reallocate(
+					growth_x2::next_capacity(word_capacity_, word_size() + 1));
+			}
+			words_[word_size()] = 0;
+		}
+		++size_;
+		(*this)[size_ - 1] = value;
+	}
+
+	void pop_back() noexcept
+	{
+		if (size_ > 0)
+		{
+			(*this)[--size_] = false;
+		}
+	}
+
+	void clear() noexcept { size_ = 0; }
+
+	size_t count() const noexcept
+	{
+		return popcount_words(words_.get(), word_size());
+	}
+
+	bool any() const noexcept
+	{
+		return find_first() != npos;
+	}
+
+	bool none() const noexcept { return !any(); }
+
+	bool all() const noexcept { return count() == size_; }
+
+	// Position of the lowest set bit, or npos
+	size_t find_first() const noexcept { return find_from_word(0); }
+
+	// Position of the lowest set bit after pos, or npos
+	size_t find_next(size_t pos) const noexcept
+	{
+		const size_t next = pos + 1;
+		if (next >= size_)
+		{
+			return npos;
+		}
+		const uint64_t rest =
+			words_[next / word_bits] & (~uint64_t{0} << (next % word_bits));
+		if (rest != 0)
+		{
+			return next / word_bits * word_bits + std::countr_zero(rest);
+		}
+		return find_from_word(next / word_bits + 1);
+	}
+
+	set_bit_range set_bits() const noexcept
+	{
+		return set_bit_range(words_.get(), word_size());
+	}
+
+	dynamic_bitset& operator&=(const dynamic_bitset& other)
+	{
+		check_same_size(other);
+		uint64_t* words = words_.get();
+		const uint64_t* rhs = other.words_.get();
+		for (size_t i = 0, n = word_size(); i < n; ++i)
+		{
+			words[i] &= rhs[i];
+		}
+		return *this;
+	}
+
+	dynamic_bitset& operator|=(const dynamic_bitset& other)
+	{
+		check_same_size(other);
+		uint64_t* words = words_.get();
+		const uint64_t* rhs = other.words_.get();
+		for (size_t i = 0, n = word_size(); i < n; ++i)
+		{
+			words[i] |= rhs[i];
+		}
+		return *this;
+	}
+
+	dynamic_bitset& operator^=(const dynamic_bitset& other)
+	{
+		check_same_size(other);
+		uint64_t* words = words_.get();
+		const uint64_t* rhs = other.words_.get();
+		for (size_t i = 0, n = word_size(); i < n; ++i)
+		{
+			words[i] ^= rhs[i];
+		}
+		return *this;
+	}
+
+	friend dynamic_bitset operator&(dynamic_bitset lhs,
+									const dynamic_bitset& rhs)
+	{
+		lhs &= rhs;
+		return lhs;
+	}
+
+	friend dynamic_bitset operator|(dynamic_bitset lhs,
+									const dynamic_bitset& rhs)
+	{
+		lhs |= rhs;
+		return lhs;
+	}
+
+	friend dynamic_bitset operator^(dynamic_bitset lhs,
+									const dynamic_bitset& rhs)
+	{
+		lhs ^= rhs;
+		return lhs;
+	}
+
+	dynamic_bitset operator~() const
+	{
+		dynamic_bitset copy(*this);
+		copy.flip();
+		return copy;
+	}
+
+	friend bool operator==(const dynamic_bitset& lhs,
+						   const dynamic_bitset& rhs)
+	{
+		return lhs.size_ == rhs.size_ &&
+			   std::equal(lhs.words_.get(), lhs.words_.get() + lhs.word_size(),
+						  rhs.words_.get());
+	}
+
+	friend bool operator!=(const dynamic_bitset& lhs,
+						   const dynamic_bitset& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	// Bit 0 first, e.g. {1, 0, 0} prints as 100
+	friend std::ostream& operator<<(std::ostream& os,
+									const dynamic_bitset& bits)
+	{
+		for (size_t i = 0; i < bits.size_; ++i)
+		{
+			os << (bits[i] ? '1' : '0');
+		}
+		return os;
+	}
+
+   private:
+	static size_t word_count(size_t bits) noexcept
+	{
+		return (bits + word_bits - 1) / word_bits;
+	}
+
+	static uint64_t mask(size_t index) noexcept
+	{
+		return uint64_t{1} << (index % word_bits);
+	}
+
+	void check_index(size_t index) const
+	{
+		if (index >= size_)
+		{
+			throw std::out_of_range("Index out of range");
+		}
+	}
+
+	void check_same_size(const dynamic_bitset& other) const
+	{
+		if (size_ != other.size_)
+		{
+			throw std::invalid_argument("Bitsets differ in size");
+		}
+	}
+
+	// Zeroes the bits past size_ in the last word
+	void clear_tail() noexcept
+	{
+		if (size_ % word_bits != 0)
+		{
+			words_[size_ / word_bits] &= ~(~uint64_t{0} << (size_ % word_bits));
+		}
+	}
+
+	size_t find_from_word(size_t first_word) const noexcept
+	{
+		const uint64_t* words = words_.get();
+		for (size_t i = first_word, n = word_size(); i < n; ++i)
+		{
+			if (words[i] != 0)
+			{
+				return i * word_bits + std::countr_zero(words[i]);
+			}
+		}
+		return npos;
+	}
+
+	void reallocate(size_t new_word_capacity)
+	{
+		array_ptr<uint64_t> new_words(new_word_capacity);
+		std::copy_n(words_.get(), word_size(), new_words.get());
+		words_.swap(new_words);
+		word_capacity_ = new_word_capacity;
+	}
+
+	array_ptr<uint64_t> words_;
+	size_t size_ = 0;
+	size_t word_capacity_ = 0;
+};
+}  // namespace bmstu
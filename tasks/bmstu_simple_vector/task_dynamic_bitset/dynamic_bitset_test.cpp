@@ -0,0 +1,270 @@
+#include "bmstu_dynamic_bitset.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "bmstu_bench.h"
+#include "bmstu_simple_vector.h"
+
+TEST(DynamicBitsetTest, Init)
+{
+	bmstu::dynamic_bitset empty;
+	ASSERT_TRUE(empty.empty());
+	ASSERT_EQ(empty.count(), 0u);
+	ASSERT_EQ(empty.find_first(), bmstu::dynamic_bitset::npos);
+
+	bmstu::dynamic_bitset ones(130, true);
+	ASSERT_EQ(ones.size(), 130u);
+	ASSERT_EQ(ones.word_size(), 3u);
+	ASSERT_EQ(ones.count(), 130u);
+	ASSERT_TRUE(ones.all());
+	// bits past size() stay zero
+	ASSERT_EQ(ones.data()[2], 0b11u);
+
+	bmstu::dynamic_bitset bits{1, 0, 0, 1};
+	std::ostringstream os;
+	os << bits;
+	ASSERT_EQ(os.str(), "1001");
+}
+
+TEST(DynamicBitsetTest, ProxyReference)
+{
+	bmstu::dynamic_bitset bits(100);
+	bits[3] = true;
+	bits[70] = bits[3];
+	ASSERT_TRUE(bits[70]);
+	ASSERT_FALSE(~bits[70]);
+	bits[70].flip();
+	ASSERT_FALSE(bits.test(70));
+	bits.set(99).flip(0).reset(3);
+	ASSERT_EQ(bits.count(), 2u);
+	ASSERT_TRUE(bits.test(0));
+	ASSERT_THROW(bits.test(100), std::out_of_range);
+	ASSERT_THROW(bits.set(100), std::out_of_range);
+
+	const bmstu::dynamic_bitset& view = bits;
+	ASSERT_TRUE(view[99]);
+	ASSERT_FALSE(view[98]);
+}
+
+TEST(DynamicBitsetTest, PushBackResize)
+{
+	bmstu::dynamic_bitset bits;
+	std::vector<bool> expected;
+	for (int i = 0; i < 1000; ++i)
+	{
+		const bool value = i % 3 == 0 || i % 7 == 0;
+		bits.push_back(value);
+		expected.push_back(value);
+	}
+	for (int i = 0; i < 1000; ++i)
+	{
+		ASSERT_EQ(bits[i], expected[i]) << i;
+	}
+	ASSERT_EQ(bits.count(),
+			  static_cast<size_t>(
+				  std::count(expected.begin(), expected.end(), true)));
+
+	bits.resize(65);
+	bits.resize(200, true);
+	ASSERT_EQ(bits.size(), 200u);
+	ASSERT_TRUE(bits[64] == expected[64]);
+	for (size_t i = 65; i < 200; ++i)
+	{
+		ASSERT_TRUE(bits[i]);
+	}
+	bits.pop_back();
+	ASSERT_EQ(bits.size(), 199u);
+	bits.clear();
+	bits.push_back(false);
+	ASSERT_TRUE(bits.none());
+}
+
+TEST(DynamicBitsetTest, WordOperations)
+{
+	bmstu::dynamic_bitset a(150);
+	bmstu::dynamic_bitset b(150);
+	for (size_t i = 0; i < 150; ++i)
+	{
+		a[i] = i % 2 == 0;
+		b[i] = i % 3 == 0;
+	}
+	const bmstu::dynamic_bitset both = a & b;
+	const bmstu::dynamic_bitset either = a | b;
+	const bmstu::dynamic_bitset one = a ^ b;
+	const bmstu::dynamic_bitset odd = ~a;
+	for (size_t i = 0; i < 150; ++i)
+	{
+		ASSERT_EQ(both[i], i % 6 == 0);
+		ASSERT_EQ(either[i], i % 2 == 0 || i % 3 == 0);
+		ASSERT_EQ(one[i], (i % 2 == 0) != (i % 3 == 0));
+		ASSERT_EQ(odd[i], i % 2 == 1);
+	}
+	ASSERT_EQ(odd.count(), 75u);
+	ASSERT_EQ(~odd, a);
+	ASSERT_TRUE(a != b);
+	ASSERT_THROW(a &= bmstu::dynamic_bitset(10), std::invalid_argument);
+
+	bmstu::dynamic_bitset copy(a);
+	copy.flip().flip();
+	ASSERT_EQ(copy, a);
+	copy.set();
+	ASSERT_EQ(copy.count(), 150u);
+	copy.reset();
+	ASSERT_TRUE(copy.none());
+}
+
+TEST(DynamicBitsetTest, FindAndIterate)
+{
+	bmstu::dynamic_bitset bits(1000);
+	const std::vector<size_t> positions{0, 1, 63, 64, 65, 127, 500, 999};
+	for (size_t pos : positions)
+	{
+		bits[pos] = true;
+	}
+	std::vector<size_t> found;
+	for (size_t pos = bits.find_first(); pos != bmstu::dynamic_bitset::npos;
+		 pos = bits.find_next(pos))
+	{
+		found.push_back(pos);
+	}
+	ASSERT_EQ(found, positions);
+	found.clear();
+	for (size_t pos : bits.set_bits())
+	{
+		found.push_back(pos);
+	}
+	ASSERT_EQ(found, positions);
+	ASSERT_EQ(bits.find_next(999), bmstu::dynamic_bitset::npos);
+	ASSERT_EQ(bits.find_next(200), 500u);
+
+	bmstu::dynamic_bitset none(300);
+	ASSERT_EQ(none.set_bits().begin(), none.set_bits().end());
+	ASSERT_EQ(none.find_first(), bmstu::dynamic_bitset::npos);
+}
+
+TEST(DynamicBitsetTest, CountMatchesLoop)
+{
+	// long enough for the vector loop and a scalar tail
+	bmstu::dynamic_bitset bits(64 * 37 + 5);
+	uint64_t state = 88172645463325252ull;
+	size_t expected = 0;
+	for (size_t i = 0; i < bits.size(); ++i)
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		bits[i] = state % 3 == 0;
+		expected += state % 3 == 0;
+	}
+	ASSERT_EQ(bits.count(), expected);
+}
+
+TEST(DynamicBitsetTest, PopcountKernelsAgree)
+{
+	std::vector<uint64_t> words(41);
+	uint64_t state = 3;
+	for (uint64_t& word : words)
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		word = state;
+	}
+	words[0] = ~uint64_t{0};
+	words[1] = 0;
+	const size_t expected = bmstu::popcount_scalar(words.data(), words.size());
+	ASSERT_EQ(bmstu::popcount_words(words.data(), words.size()), expected);
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	if (__builtin_cpu_supports("popcnt"))
+	{
+		ASSERT_EQ(bmstu::popcount_popcnt(words.data(), words.size()),
+				  expected);
+	}
+	if (__builtin_cpu_supports("avx2"))
+	{
+		for (size_t n : {size_t{0}, size_t{3}, size_t{4}, words.size()})
+		{
+			ASSERT_EQ(bmstu::popcount_avx2(words.data(), n),
+					  bmstu::popcount_scalar(words.data(), n));
+		}
+	}
+#endif
+}
+
+namespace
+{
+using bmstu::bench::next_random;
+using bmstu::bench::time_it;
+
+// Every bit set with probability 1 / one_in
+bmstu::dynamic_bitset random_bits(size_t size, uint64_t one_in)
+{
+	bmstu::dynamic_bitset bits(size);
+	uint64_t state = 88172645463325252ull;
+	for (size_t i = 0; i < size; ++i)
+	{
+		if (next_random(state) % one_in == 0)
+		{
+			bits[i] = true;
+		}
+	}
+	return bits;
+}
+
+[[gnu::noipa]] long long sum_set_bits(const bmstu::dynamic_bitset& bits)
+{
+	long long sum = 0;
+	for (size_t pos : bits.set_bits())
+	{
+		sum += pos;
+	}
+	return sum;
+}
+
+[[gnu::noipa]] long long sum_set_bytes(const bmstu::simple_vector<bool>& v)
+{
+	long long sum = 0;
+	for (size_t i = 0; i < v.size(); ++i)
+	{
+		if (v[i])
+		{
+			sum += i;
+		}
+	}
+	return sum;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(DynamicBitsetBench, DISABLED_CountAndIterate1e9)
+{
+	constexpr size_t size = 1'000'000'000;
+	for (uint64_t one_in : {2, 100})
+	{
+		std::cout << "1 bit in " << one_in << " set" << std::endl;
+		const bmstu::dynamic_bitset bits = random_bits(size, one_in);
+		time_it("dynamic_bitset 10^9, count x 10",
+				[&] { return static_cast<long long>(bits.count()); }, 10);
+		time_it("dynamic_bitset 10^9, set bit iteration",
+				[&] { return sum_set_bits(bits); }, 1);
+
+		bmstu::simple_vector<bool> bytes(size);
+		for (size_t pos : bits.set_bits())
+		{
+			bytes[pos] = true;
+		}
+		time_it("simple_vector<bool> 10^9, std::count x 10",
+				[&] {
+					return static_cast<long long>(
+						std::count(bytes.begin(), bytes.end(), true));
+				},
+				10);
+		time_it("simple_vector<bool> 10^9, set byte iteration",
+				[&] { return sum_set_bytes(bytes); }, 1);
+	}
+}
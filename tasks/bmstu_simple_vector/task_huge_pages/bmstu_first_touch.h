@@ -0,0 +1,45 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include "array_ptr.h"
+#include "bmstu_simple_vector.h"
+#include "bmstu_thread_pool.h"
+
+namespace bmstu
+{
+// Grows vec to new_size with the new elements zeroed by the pool threads,
+// one slice each. Slices are cut at multiples of huge_page_size bytes, so
+// in a mapped buffer (see page_mode) each page is first touched, and so
+// placed on the NUMA node of, the thread whose slice holds it. Loops that
+// later split [0, size()) over the same pool in the same order then run
+// on local memory.
+//
+// T must be trivial: resize_for_overwrite writes nothing for it, so the
+// calling thread touches none of the new pages first.
+template <typename T, typename Growth, typename Allocator>
+	requires std::is_trivial_v<T>
+void resize_first_touch(simple_vector<T, Growth, Allocator>& vec,
+						size_t new_size,
+						thread_pool& pool = thread_pool::shared())
+{
+	const size_t old_size = vec.size();
+	vec.resize_for_overwrite(new_size);
+	if (new_size <= old_size)
+	{
+		return;
+	}
+	const size_t page = std::max<size_t>(1, huge_page_size / sizeof(T));
+	const size_t threads = pool.size();
+	const auto bound = [&](size_t i)
+	{
+		const size_t even = new_size * i / threads;
+		const size_t rounded = (even + page - 1) / page * page;
+		return std::clamp(rounded, old_size, new_size);
+	};
+	T* data = vec.data();
+	pool.run(threads,
+			 [&](size_t i)
+			 { std::fill(data + bound(i), data + bound(i + 1), T{}); });
+}
+}  // namespace bmstu
@@ -0,0 +1,174 @@
+#include "bmstu_first_touch.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include "array_ptr.h"
+#include "bmstu_bench.h"
+#include "bmstu_simple_vector.h"
+#include "bmstu_thread_pool.h"
+
+namespace
+{
+bool huge_aligned(const void* ptr)
+{
+	return reinterpret_cast<uintptr_t>(ptr) % bmstu::huge_page_size == 0;
+}
+}  // namespace
+
+TEST(HugePagesTest, MappedArrayPtr)
+{
+	bmstu::array_ptr<int> ptr(1000, bmstu::page_mode::transparent_huge);
+	ASSERT_TRUE(ptr);
+	ASSERT_TRUE(huge_aligned(ptr.get()));
+	ASSERT_EQ(ptr.mode(), bmstu::page_mode::transparent_huge);
+	for (int i = 0; i < 1000; ++i)
+	{
+		ptr[i] = i;
+	}
+	ASSERT_LE(ptr.huge_page_bytes(), bmstu::huge_page_size);
+
+	bmstu::array_ptr<int> moved(std::move(ptr));
+	ASSERT_FALSE(ptr);
+	ASSERT_EQ(moved[999], 999);
+	bmstu::array_ptr<int> heap(10);
+	heap.swap(moved);
+	ASSERT_EQ(heap.mode(), bmstu::page_mode::transparent_huge);
+	ASSERT_EQ(moved.mode(), bmstu::page_mode::standard);
+	ASSERT_EQ(moved.huge_page_bytes(), 0u);
+	moved = std::move(heap);
+	ASSERT_EQ(moved[500], 500);
+
+	bmstu::array_ptr<int> empty(0, bmstu::page_mode::explicit_huge);
+	ASSERT_FALSE(empty);
+	ASSERT_EQ(empty.mode(), bmstu::page_mode::explicit_huge);
+}
+
+TEST(HugePagesTest, ExplicitFallsBackToTransparent)
+{
+	// works whether or not the hugetlbfs pool has pages
+	constexpr size_t n = 3 * bmstu::huge_page_size / sizeof(double) + 1;
+	bmstu::array_ptr<double> ptr(n, bmstu::page_mode::explicit_huge);
+	ASSERT_TRUE(huge_aligned(ptr.get()));
+	for (size_t i = 0; i < n; ++i)
+	{
+		ptr[i] = static_cast<double>(i);
+	}
+	ASSERT_EQ(ptr[n - 1], static_cast<double>(n - 1));
+	ASSERT_LE(ptr.huge_page_bytes(), 4 * bmstu::huge_page_size);
+	ASSERT_EQ(ptr.huge_page_bytes() % bmstu::huge_page_size, 0u);
+}
+
+TEST(HugePagesTest, SimpleVectorKeepsMode)
+{
+	bmstu::simple_vector<int> vec{1, 2, 3};
+	vec.reserve(2, bmstu::page_mode::transparent_huge);
+	ASSERT_EQ(vec.capacity(), 3u);
+	ASSERT_TRUE(huge_aligned(vec.data()));
+	ASSERT_EQ(vec, (bmstu::simple_vector<int>{1, 2, 3}));
+	for (int i = 4; i <= 1'000'000; ++i)
+	{
+		vec.push_back(i);
+	}
+	ASSERT_TRUE(huge_aligned(vec.data()));
+	// one more than fits, so insert reallocates too
+	const size_t extra = vec.capacity() - vec.size() + 1;
+	vec.insert(vec.begin(), extra, -1);
+	ASSERT_TRUE(huge_aligned(vec.data()));
+	ASSERT_EQ(vec[extra - 1], -1);
+	ASSERT_EQ(vec[extra], 1);
+
+	const bmstu::simple_vector<int> copy(vec);
+	ASSERT_TRUE(huge_aligned(copy.data()));
+	ASSERT_EQ(copy, vec);
+
+	vec.reserve(0, bmstu::page_mode::standard);
+	ASSERT_EQ(vec, copy);
+	ASSERT_EQ(vec.huge_page_bytes(), 0u);
+}
+
+TEST(HugePagesTest, ResizeFirstTouch)
+{
+	bmstu::thread_pool pool(4);
+	bmstu::simple_vector<uint32_t> vec;
+	vec.reserve(10, bmstu::page_mode::transparent_huge);
+	constexpr size_t n = 5 * bmstu::huge_page_size / sizeof(uint32_t) + 7;
+	// leave old values in the memory the new elements take
+	vec.resize(n);
+	std::fill(vec.begin(), vec.end(), 7u);
+	vec.resize(n / 3);
+	bmstu::resize_first_touch(vec, n, pool);
+	ASSERT_EQ(vec.size(), n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		ASSERT_EQ(vec[i], i < n / 3 ? 7u : 0u);
+	}
+	bmstu::resize_first_touch(vec, 5, pool);
+	ASSERT_EQ(vec.size(), 5u);
+	ASSERT_EQ(vec[4], 7u);
+}
+
+namespace
+{
+using bmstu::bench::next_random;
+using bmstu::bench::time_it;
+
+// Independent loads: the core keeps many misses in flight
+[[gnu::noipa]] long long gather(const uint64_t* data, size_t n, size_t reads)
+{
+	uint64_t state = 88172645463325252ull;
+	long long sum = 0;
+	for (size_t i = 0; i < reads; ++i)
+	{
+		sum += static_cast<long long>(data[next_random(state) % n]);
+	}
+	return sum;
+}
+
+// Each load's address comes from the one before: every miss is exposed
+[[gnu::noipa]] long long chase(const uint64_t* data, size_t n, size_t steps)
+{
+	size_t index = 0;
+	for (size_t i = 0; i < steps; ++i)
+	{
+		index = data[index] % n;
+	}
+	return static_cast<long long>(index);
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(HugePagesBench, DISABLED_RandomAccess2GB)
+{
+	constexpr size_t n = (size_t{2} << 30) / sizeof(uint64_t);
+	bmstu::thread_pool& pool = bmstu::thread_pool::shared();
+	for (bmstu::page_mode mode :
+		 {bmstu::page_mode::standard, bmstu::page_mode::transparent_huge})
+	{
+		const bool huge = mode != bmstu::page_mode::standard;
+		bmstu::simple_vector<uint64_t> vec;
+		vec.reserve(n, mode);
+		time_it(huge ? "first touch 2 GB, huge pages"
+					 : "first touch 2 GB, 4 KB pages",
+				[&]
+				{
+					bmstu::resize_first_touch(vec, n, pool);
+					return 0;
+				});
+		std::cout << "huge page bytes: " << vec.huge_page_bytes() << " of "
+				  << n * sizeof(uint64_t) << std::endl;
+		uint64_t state = 3;
+		for (uint64_t& value : vec)
+		{
+			value = next_random(state);
+		}
+		time_it(huge ? "100M random reads, huge pages"
+					 : "100M random reads, 4 KB pages",
+				[&] { return gather(vec.data(), n, 100'000'000); });
+		time_it(huge ? "20M dependent reads, huge pages"
+					 : "20M dependent reads, 4 KB pages",
+				[&] { return chase(vec.data(), n, 20'000'000); });
+	}
+}
@@ -0,0 +1,271 @@
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <compare>
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include "bmstu_simple_vector.h"
+#include "bmstu_vector_compare.h"
+
+namespace bmstu
+{
+// How a mapped_array will be read, passed on to madvise
+enum class access_hint
+{
+	// default read-ahead around each fault
+	normal,
+	// large read-ahead, pages behind the reader may be dropped early
+	sequential,
+	// no read-ahead, each fault reads one page
+	random,
+	// start reading the whole file in now
+	will_need,
+};
+
+namespace
+{
+// Closes the descriptor on scope exit
+struct file_descriptor
+{
+	explicit file_descriptor(int fd) noexcept : fd(fd) {}
+
+	file_descriptor(const file_descriptor& other) = delete;
+
+	file_descriptor& operator=(const file_descriptor& other) = delete;
+
+	~file_descriptor()
+	{
+		if (fd >= 0)
+		{
+			::close(fd);
+		}
+	}
+
+	int fd;
+};
+
+[[noreturn]] inline void throw_file_error(const char* call,
+										  const std::filesystem::path& path)
+{
+	throw std::system_error(errno, std::generic_category(),
+							std::string(call) + " " + path.string());
+}
+}  // namespace
+
+// Read-only array of T over a file mapping. Opening costs one mmap whatever
+// the file size; pages are read from the page cache as they are first
+// touched. Reads like a const simple_vector<T>.
+//
+// The file holds the raw bytes of the elements, as written by save(), so
+// it only reads back in builds with the same layout of T and endianness.
+template <typename T>
+class mapped_array
+{
+	static_assert(std::is_trivially_copyable_v<T>,
+				  "mapped_array needs a trivially copyable T");
+
+   public:
+	using value_type = T;
+	using iterator = vector_iterator<const T>;
+	using const_iterator = iterator;
+
+	mapped_array() noexcept = default;
+
+	// Throws std::system_error if the file can't be opened or mapped, and
+	// std::invalid_argument if its size isn't a whole number of elements
+	explicit mapped_array(const std::filesystem::path& path,
+						  access_hint hint = access_hint::normal)
+	{
+		// the mapping keeps the file open on its own
+		const file_descriptor file(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+		if (file.fd < 0)
+		{
+			throw_file_error("open", path);
+		}
+		struct stat info;
+		if (::fstat(file.fd, &info) != 0)
+		{
+			throw_file_error("fstat", path);
+		}
+		const size_t bytes = static_cast<size_t>(info.st_size);
+		if (bytes % sizeof(T) != 0)
+		{
+			throw std::invalid_argument(
+				"File size is not a multiple of the element size");
+		}
+		if (bytes == 0)
+		{
+			return;
+		}
+		void* pages =
+			::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, file.fd, 0);
+		if (pages == MAP_FAILED)
+		{
+			throw_file_error("mmap", path);
+		}
+		data_ = static_cast<const T*>(pages);
+		size_ = bytes / sizeof(T);
+		advise(hint);
+	}
+
+	mapped_array(const mapped_array& other) = delete;
+
+	mapped_array& operator=(const mapped_array& other) = delete;
+
+	mapped_array(mapped_array&& other) noexcept
+		: data_(std::exchange(other.data_, nullptr)),
+		  size_(std::exchange(other.size_, 0))
+	{
+	}
+
+	mapped_array& operator=(mapped_array&& other) noexcept
+	{
+		if (this != &other)
+		{
+			unmap();
+			data_ = std::exchange(other.data_, nullptr);
+			size_ = std::exchange(other.size_, 0);
+		}
+		return *this;
+	}
+
+	~mapped_array() { unmap(); }
+
+	// Can be changed at any time, e.g. random after a sequential load
+	void advise(access_hint hint) const noexcept
+	{
+		if (size_ == 0)
+		{
+			return;
+		}
+		int advice = MADV_NORMAL;
+		switch (hint)
+		{
+			case access_hint::normal:
+				break;
+			case access_hint::sequential:
+				advice = MADV_SEQUENTIAL;
+				break;
+			case access_hint::random:
+				advice = MADV_RANDOM;
+				break;
+			case access_hint::will_need:
+				advice = MADV_WILLNEED;
+				break;
+		}
+		::madvise(const_cast<T*>(data_), size_ * sizeof(T), advice);
+	}
+
+	iterator begin() const noexcept { return iterator(data_); }
+
+	iterator end() const noexcept { return iterator(data_ + size_); }
+
+	iterator cbegin() const noexcept { return begin(); }
+
+	iterator cend() const noexcept { return end(); }
+
+	const T* data() const noexcept { return data_; }
+
+	size_t size() const noexcept { return size_; }
+
+	bool empty() const noexcept { return size_ == 0; }
+
+	const T& operator[](size_t index) const noexcept { return data_[index]; }
+
+	const T& at(size_t index) const
+	{
+		if (index >= size_)
+		{
+			throw std::out_of_range("Index out of range");
+		}
+		return data_[index];
+	}
+
+	friend bool operator==(const mapped_array& lhs, const mapped_array& rhs)
+	{
+		return lhs.size_ == rhs.size_ &&
+			   equal_elements(lhs.data_, rhs.data_, lhs.size_);
+	}
+
+	friend std::weak_ordering operator<=>(const mapped_array& lhs,
+										  const mapped_array& rhs)
+	{
+		return compare_elements(lhs.data_, lhs.size_, rhs.data_, rhs.size_);
+	}
+
+	template <typename Growth, typename Allocator>
+	friend bool operator==(const mapped_array& lhs,
+						   const simple_vector<T, Growth, Allocator>& rhs)
+	{
+		return lhs.size_ == rhs.size() &&
+			   equal_elements(lhs.data_, rhs.data(), lhs.size_);
+	}
+
+	template <typename Growth, typename Allocator>
+	friend std::weak_ordering operator<=>(
+		const mapped_array& lhs,
+		const simple_vector<T, Growth, Allocator>& rhs)
+	{
+		return compare_elements(lhs.data_, lhs.size_, rhs.data(), rhs.size());
+	}
+
+   private:
+	void unmap() noexcept
+	{
+		if (data_ != nullptr)
+		{
+			::munmap(const_cast<T*>(data_), size_ * sizeof(T));
+		}
+	}
+
+	const T* data_ = nullptr;
+	size_t size_ = 0;
+};
+
+// Writes the bytes of vec's elements to path, replacing the file, for
+// mapped_array<T> to map. Throws std::system_error on I/O errors.
+template <typename T, typename Growth, typename Allocator>
+void save(const simple_vector<T, Growth, Allocator>& vec,
+		  const std::filesystem::path& path)
+{
+	static_assert(std::is_trivially_copyable_v<T>,
+				  "save needs a trivially copyable T");
+	file_descriptor file(
+		::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+	if (file.fd < 0)
+	{
+		throw_file_error("open", path);
+	}
+	const char* from = reinterpret_cast<const char*>(vec.data());
+	size_t left = vec.size() * sizeof(T);
+	while (left > 0)
+	{
+		// Linux writes at most about 2 GB per call
+		const ssize_t written =
+			::write(file.fd, from, std::min<size_t>(left, size_t{1} << 30));
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			throw_file_error("write", path);
+		}
+		from += written;
+		left -= static_cast<size_t>(written);
+	}
+	if (::close(std::exchange(file.fd, -1)) != 0)
+	{
+		throw_file_error("close", path);
+	}
+}
+}  // namespace bmstu
@@ -0,0 +1,236 @@
+// mapped_array is built on POSIX mmap
+#if __has_include(<sys/mman.h>)
+#include "bmstu_mapped_array.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include "bmstu_bench.h"
+#include "bmstu_simple_vector.h"
+
+namespace
+{
+struct Record
+{
+	uint64_t id;
+	double value;
+};
+
+// A file in the temp directory, removed on scope exit
+struct temp_file
+{
+	explicit temp_file(const std::string& name)
+		: path(std::filesystem::temp_directory_path() /
+			   (name + "." + std::to_string(::getpid())))
+	{
+	}
+
+	~temp_file()
+	{
+		std::error_code ignored;
+		std::filesystem::remove(path, ignored);
+	}
+
+	std::filesystem::path path;
+};
+}  // namespace
+
+TEST(MappedArrayTest, SaveAndMap)
+{
+	const temp_file file("mapped_records");
+	bmstu::simple_vector<Record> records;
+	for (uint64_t i = 0; i < 100'000; ++i)
+	{
+		records.push_back(Record{i, i * 0.5});
+	}
+	bmstu::save(records, file.path);
+	ASSERT_EQ(std::filesystem::file_size(file.path),
+			  records.size() * sizeof(Record));
+
+	const bmstu::mapped_array<Record> mapped(file.path,
+											 bmstu::access_hint::sequential);
+	ASSERT_EQ(mapped.size(), records.size());
+	ASSERT_FALSE(mapped.empty());
+	ASSERT_EQ(mapped[99'999].id, 99'999u);
+	ASSERT_EQ(mapped.at(10).value, 5.0);
+	ASSERT_THROW(mapped.at(100'000), std::out_of_range);
+	uint64_t sum = 0;
+	for (const Record& record : mapped)
+	{
+		sum += record.id;
+	}
+	ASSERT_EQ(sum, 99'999ull * 100'000 / 2);
+	ASSERT_EQ(mapped.end() - mapped.begin(), 100'000);
+	mapped.advise(bmstu::access_hint::random);
+	ASSERT_EQ(mapped.data()[5].id, 5u);
+}
+
+TEST(MappedArrayTest, Compare)
+{
+	const temp_file file("mapped_ints");
+	bmstu::simple_vector<int> values(1000);
+	std::iota(values.begin(), values.end(), 0);
+	bmstu::save(values, file.path);
+	const bmstu::mapped_array<int> mapped(file.path);
+	ASSERT_TRUE(mapped == values);
+	ASSERT_TRUE(values == mapped);
+	ASSERT_EQ(mapped <=> values, std::weak_ordering::equivalent);
+	values[500] = -1;
+	ASSERT_TRUE(mapped != values);
+	ASSERT_TRUE(mapped > values);
+	ASSERT_TRUE(values < mapped);
+	values.pop_back();
+	ASSERT_EQ(mapped <=> values, std::weak_ordering::greater);
+
+	const bmstu::mapped_array<int> again(file.path);
+	ASSERT_TRUE(mapped == again);
+	ASSERT_EQ(mapped <=> again, std::weak_ordering::equivalent);
+}
+
+TEST(MappedArrayTest, EmptyAndMoved)
+{
+	const temp_file file("mapped_empty");
+	bmstu::save(bmstu::simple_vector<double>(), file.path);
+	bmstu::mapped_array<double> empty(file.path, bmstu::access_hint::random);
+	ASSERT_TRUE(empty.empty());
+	ASSERT_EQ(empty.begin(), empty.end());
+
+	bmstu::save(bmstu::simple_vector<double>{1.5, 2.5}, file.path);
+	bmstu::mapped_array<double> mapped(file.path);
+	empty = std::move(mapped);
+	ASSERT_TRUE(mapped.empty());
+	ASSERT_EQ(empty.size(), 2u);
+	const bmstu::mapped_array<double> moved(std::move(empty));
+	ASSERT_EQ(moved[1], 2.5);
+	ASSERT_EQ(empty.data(), nullptr);
+}
+
+TEST(MappedArrayTest, Errors)
+{
+	const temp_file file("mapped_odd");
+	ASSERT_THROW(bmstu::mapped_array<int>(file.path), std::system_error);
+	{
+		std::ofstream out(file.path, std::ios::binary);
+		out << "12345";
+	}
+	ASSERT_THROW(bmstu::mapped_array<int>(file.path), std::invalid_argument);
+	ASSERT_EQ(bmstu::mapped_array<char>(file.path).size(), 5u);
+	ASSERT_THROW(bmstu::save(bmstu::simple_vector<int>{1},
+							 file.path / "not_a_directory"),
+				 std::system_error);
+}
+
+namespace
+{
+using bmstu::bench::time_it;
+
+// Asks the kernel to drop the file from the page cache
+void drop_cache(const std::filesystem::path& path)
+{
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	::fdatasync(fd);
+	::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+	::close(fd);
+}
+
+// The old way in: read() the whole file into a simple_vector
+bmstu::simple_vector<Record> read_records(const std::filesystem::path& path)
+{
+	bmstu::simple_vector<Record> records;
+	records.resize_for_overwrite(std::filesystem::file_size(path) /
+								 sizeof(Record));
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	char* to = reinterpret_cast<char*>(records.data());
+	size_t left = records.size() * sizeof(Record);
+	while (left > 0)
+	{
+		const ssize_t got = ::read(fd, to, left);
+		if (got <= 0)
+		{
+			break;
+		}
+		to += got;
+		left -= static_cast<size_t>(got);
+	}
+	::close(fd);
+	return records;
+}
+
+template <typename Range>
+[[gnu::noipa]] long long sum_ids(const Range& records)
+{
+	long long sum = 0;
+	for (const Record& record : records)
+	{
+		sum += static_cast<long long>(record.id);
+	}
+	return sum;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(MappedArrayBench, DISABLED_Startup1GB)
+{
+	const temp_file file("mapped_bench");
+	{
+		bmstu::simple_vector<Record> records;
+		records.resize_for_overwrite((size_t{1} << 30) / sizeof(Record));
+		for (size_t i = 0; i < records.size(); ++i)
+		{
+			records[i] = Record{i, 1.0};
+		}
+		bmstu::save(records, file.path);
+	}
+	for (bool cold : {true, false})
+	{
+		std::cout << (cold ? "cold page cache" : "warm page cache")
+				  << std::endl;
+		if (cold)
+		{
+			drop_cache(file.path);
+		}
+		time_it("  read() + copy, ready",
+				[&]
+				{
+					const auto records = read_records(file.path);
+					return static_cast<long long>(records.size());
+				});
+		if (cold)
+		{
+			drop_cache(file.path);
+		}
+		time_it("  read() + copy, then one scan",
+				[&] { return sum_ids(read_records(file.path)); });
+		if (cold)
+		{
+			drop_cache(file.path);
+		}
+		time_it("  mapped_array, ready",
+				[&]
+				{
+					const bmstu::mapped_array<Record> mapped(file.path);
+					return static_cast<long long>(mapped.size());
+				});
+		if (cold)
+		{
+			drop_cache(file.path);
+		}
+		time_it("  mapped_array, then one scan",
+				[&]
+				{
+					const bmstu::mapped_array<Record> mapped(
+						file.path, bmstu::access_hint::sequential);
+					return sum_ids(mapped);
+				});
+	}
+}
+#endif
@@ -0,0 +1,443 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "array_ptr.h"
+#include "bmstu_simple_vector.h"
+#include "bmstu_vector_compare.h"
+
+namespace bmstu
+{
+// Vector stored in chunks of first_chunk, 2 * first_chunk, 4 * first_chunk...
+// elements. Growing adds the next chunk and never moves an element, so
+// references stay valid until the element is removed, and peak memory is the
+// data plus one fresh chunk instead of old + new buffer. Index to chunk is a
+// bit_width and two shifts, so access stays O(1), but unlike simple_vector
+// the storage isn't contiguous.
+template <typename T>
+class segmented_vector
+{
+	static constexpr size_t first_chunk = 16;
+	static constexpr int first_shift = std::countr_zero(first_chunk);
+
+	// An index into a vector: stays valid across push_back, orders like the
+	// index, and dereferences through the chunk directory
+	template <typename Value>
+	class basic_iterator
+	{
+		using owner_type = std::conditional_t<std::is_const_v<Value>,
+											  const segmented_vector,
+											  segmented_vector>;
+
+	   public:
+		using iterator_concept = std::random_access_iterator_tag;
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = std::remove_cv_t<Value>;
+		using pointer = Value*;
+		using reference = Value&;
+		using difference_type = std::ptrdiff_t;
+
+		basic_iterator() = default;
+
+		basic_iterator(owner_type* owner, size_t index)
+			: owner_(owner), index_(index)
+		{
+		}
+
+		template <typename Other>
+			requires(std::is_const_v<Value> &&
+					 std::is_same_v<Other, std::remove_const_t<Value>>)
+		basic_iterator(const basic_iterator<Other>& other) noexcept
+			: owner_(other.owner_), index_(other.index_)
+		{
+		}
+
+		reference operator*() const { return (*owner_)[index_]; }
+
+		pointer operator->() const { return &(*owner_)[index_]; }
+
+		reference operator[](difference_type n) const
+		{
+			return (*owner_)[index_ + n];
+		}
+
+		basic_iterator& operator++()
+		{
+			++index_;
+			return *this;
+		}
+
+		basic_iterator& operator--()
+		{
+			--index_;
+			return *this;
+		}
+
+		basic_iterator operator++(int)
+		{
+			basic_iterator copy(*this);
+			++index_;
+			return copy;
+		}
+
+		basic_iterator operator--(int)
+		{
+			basic_iterator copy(*this);
+			--index_;
+			return copy;
+		}
+
+		basic_iterator& operator+=(difference_type n) noexcept
+		{
+			index_ += n;
+			return *this;
+		}
+
+		basic_iterator& operator-=(difference_type n) noexcept
+		{
+			index_ -= n;
+			return *this;
+		}
+
+		friend basic_iterator operator+(basic_iterator it,
+										difference_type n) noexcept
+		{
+			return it += n;
+		}
+
+		friend basic_iterator operator+(difference_type n,
+										basic_iterator it) noexcept
+		{
+			return it += n;
+		}
+
+		friend basic_iterator operator-(basic_iterator it,
+										difference_type n) noexcept
+		{
+			return it -= n;
+		}
+
+		friend difference_type operator-(const basic_iterator& end,
+										 const basic_iterator& begin) noexcept
+		{
+			return static_cast<difference_type>(end.index_ - begin.index_);
+		}
+
+		friend bool operator==(const basic_iterator& lhs,
+							   const basic_iterator& rhs)
+		{
+			return lhs.index_ == rhs.index_;
+		}
+
+		friend auto operator<=>(const basic_iterator& lhs,
+								const basic_iterator& rhs)
+		{
+			return lhs.index_ <=> rhs.index_;
+		}
+
+	   private:
+		template <typename>
+		friend class basic_iterator;
+
+		owner_type* owner_ = nullptr;
+		size_t index_ = 0;
+	};
+
+   public:
+	using iterator = basic_iterator<T>;
+	using const_iterator = basic_iterator<const T>;
+
+	segmented_vector() noexcept = default;
+
+	~segmented_vector() { clear(); }
+
+	// These delegate to the default constructor, so that if a copy throws
+	// the destructor frees what was built so far
+	segmented_vector(std::initializer_list<T> init)
+		: segmented_vector()
+	{
+		reserve(init.size());
+		for (const T& value : init)
+		{
+			emplace_back(value);
+		}
+	}
+
+	segmented_vector(size_t size, const T& value = T{})
+		: segmented_vector()
+	{
+		reserve(size);
+		for (size_t i = 0; i < size; ++i)
+		{
+			emplace_back(value);
+		}
+	}
+
+	segmented_vector(const segmented_vector& other)
+		: segmented_vector()
+	{
+		reserve(other.size_);
+		for (const T& value : other)
+		{
+			emplace_back(value);
+		}
+	}
+
+	segmented_vector(segmented_vector&& other) noexcept { swap(other); }
+
+	segmented_vector& operator=(const segmented_vector& other)
+	{
+		if (this != &other)
+		{
+			segmented_vector copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	segmented_vector& operator=(segmented_vector&& other) noexcept
+	{
+		if (this != &other)
+		{
+			segmented_vector moved(std::move(other));
+			swap(moved);
+		}
+		return *this;
+	}
+
+	iterator begin() noexcept { return iterator(this, 0); }
+
+	iterator end() noexcept { return iterator(this, size_); }
+
+	const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+	const_iterator end() const noexcept { return const_iterator(this, size_); }
+
+	const_iterator cbegin() const noexcept { return begin(); }
+
+	const_iterator cend() const noexcept { return end(); }
+
+	T& operator[](size_t index) noexcept
+	{
+		const auto [chunk, offset] = locate(index);
+		return chunks_[chunk][offset];
+	}
+
+	const T& operator[](size_t index) const noexcept
+	{
+		const auto [chunk, offset] = locate(index);
+		return chunks_[chunk][offset];
+	}
+
+	T& at(size_t index)
+	{
+		if (index >= size_)
+		{
+			throw std::out_of_range("Index out of range");
+		}
+		return (*this)[index];
+	}
+
+	const T& at(size_t index) const
+	{
+		if (index >= size_)
+		{
+			throw std::out_of_range("Index out of range");
+		}
+		return (*this)[index];
+	}
+
+	size_t size() const noexcept { return size_; }
+
+	size_t capacity() const noexcept { return capacity_; }
+
+	bool empty() const noexcept { return size_ == 0; }
+
+	size_t chunk_count() const noexcept { return chunks_.size(); }
+
+	void swap(segmented_vector& other) noexcept
+	{
+		chunks_.swap(other.chunks_);
+		std::swap(size_, other.size_);
+		std::swap(capacity_, other.capacity_);
+		std::swap(next_, other.next_);
+		std::swap(chunk_end_, other.chunk_end_);
+	}
+
+	friend void swap(segmented_vector& lhs, segmented_vector& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+	// Adds chunks until new_cap elements fit
+	void reserve(size_t new_cap)
+	{
+		while (capacity_ < new_cap)
+		{
+			const size_t chunk_size = first_chunk << chunks_.size();
+			chunks_.push_back(array_ptr<T>(chunk_size));
+			capacity_ += chunk_size;
+		}
+	}
+
+	// Frees the chunks past the last element
+	void shrink_to_fit()
+	{
+		while (!chunks_.empty() &&
+			   capacity_ - (first_chunk << (chunks_.size() - 1)) >= size_)
+		{
+			capacity_ -= first_chunk << (chunks_.size() - 1);
+			chunks_.pop_back();
+		}
+		sync_tail();
+	}
+
+	// Never moves an element, so args may refer to one
+	template <typename... Args>
+	T& emplace_back(Args&&... args)
+	{
+		if (next_ == chunk_end_)
+		{
+			// the chunk being filled is full, go on to the next one
+			reserve(size_ + 1);
+			sync_tail();
+		}
+		T* slot = std::construct_at(next_, std::forward<Args>(args)...);
+		++next_;
+		++size_;
+		return *slot;
+	}
+
+	void push_back(T&& value) { emplace_back(std::move(value)); }
+
+	void push_back(const T& value) { emplace_back(value); }
+
+	void pop_back()
+	{
+		if (size_ > 0)
+		{
+			std::destroy_at(&(*this)[--size_]);
+			sync_tail();
+		}
+	}
+
+	// Keeps the chunks for reuse
+	void clear() noexcept
+	{
+		size_t left = size_;
+		for (size_t chunk = 0; left > 0; ++chunk)
+		{
+			const size_t count = std::min(left, first_chunk << chunk);
+			std::destroy_n(chunks_[chunk].get(), count);
+			left -= count;
+		}
+		size_ = 0;
+		sync_tail();
+	}
+
+	// Both vectors split their indices into the same chunks, so the
+	// comparison runs chunk by chunk through the flat kernels
+	friend bool operator==(const segmented_vector& lhs,
+						   const segmented_vector& rhs)
+	{
+		if (lhs.size_ != rhs.size_)
+		{
+			return false;
+		}
+		size_t left = lhs.size_;
+		for (size_t chunk = 0; left > 0; ++chunk)
+		{
+			const size_t count = std::min(left, first_chunk << chunk);
+			if (!equal_elements(lhs.chunks_[chunk].get(),
+								rhs.chunks_[chunk].get(), count))
+			{
+				return false;
+			}
+			left -= count;
+		}
+		return true;
+	}
+
+	friend bool operator!=(const segmented_vector& lhs,
+						   const segmented_vector& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	friend std::weak_ordering operator<=>(const segmented_vector& lhs,
+										  const segmented_vector& rhs)
+	{
+		size_t lhs_left = lhs.size_;
+		size_t rhs_left = rhs.size_;
+		for (size_t chunk = 0; lhs_left > 0 && rhs_left > 0; ++chunk)
+		{
+			const size_t lhs_count = std::min(lhs_left, first_chunk << chunk);
+			const size_t rhs_count = std::min(rhs_left, first_chunk << chunk);
+			// shorter vectors end inside this chunk, so != is final here
+			const std::weak_ordering order =
+				compare_elements(lhs.chunks_[chunk].get(), lhs_count,
+								 rhs.chunks_[chunk].get(), rhs_count);
+			if (order != 0)
+			{
+				return order;
+			}
+			lhs_left -= lhs_count;
+			rhs_left -= rhs_count;
+		}
+		return lhs.size_ <=> rhs.size_;
+	}
+
+	friend std::ostream& operator<<(std::ostream& os,
+									const segmented_vector& vec)
+	{
+		os << "{";
+		for (size_t i = 0; i < vec.size_; ++i)
+		{
+			if (i > 0)
+			{
+				os << ", ";
+			}
+			os << vec[i];
+		}
+		return os << "}";
+	}
+
+   private:
+	// Chunk k holds indices [first_chunk * (2^k - 1), first_chunk * (2^(k+1)
+	// - 1)), so the chunk of index + first_chunk is its highest bit
+	static std::pair<size_t, size_t> locate(size_t index) noexcept
+	{
+		const size_t pos = index + first_chunk;
+		const size_t chunk = std::bit_width(pos) - 1 - first_shift;
+		return {chunk, pos - (first_chunk << chunk)};
+	}
+
+	// Points next_ at the slot for the next push_back
+	void sync_tail() noexcept
+	{
+		if (size_ == capacity_)
+		{
+			next_ = chunk_end_ = nullptr;
+			return;
+		}
+		const auto [chunk, offset] = locate(size_);
+		next_ = chunks_[chunk].get() + offset;
+		chunk_end_ = chunks_[chunk].get() + (first_chunk << chunk);
+	}
+
+	simple_vector<array_ptr<T>> chunks_;
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+	// Free part of the chunk push_back is filling, empty when full
+	T* next_ = nullptr;
+	T* chunk_end_ = nullptr;
+};
+}  // namespace bmstu
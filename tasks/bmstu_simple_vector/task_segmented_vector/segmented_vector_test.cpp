@@ -0,0 +1,269 @@
+#include "bmstu_segmented_vector.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "bmstu_simple_vector.h"
+
+#if defined(__unix__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using int_segments = bmstu::segmented_vector<int>;
+static_assert(std::random_access_iterator<int_segments::iterator>);
+static_assert(std::random_access_iterator<int_segments::const_iterator>);
+static_assert(std::ranges::random_access_range<const int_segments>);
+static_assert(!std::contiguous_iterator<int_segments::iterator>);
+static_assert(std::is_convertible_v<int_segments::iterator,
+									int_segments::const_iterator>);
+
+TEST(SegmentedVectorTest, Init)
+{
+	bmstu::segmented_vector<int> empty;
+	ASSERT_TRUE(empty.empty());
+	ASSERT_EQ(empty.capacity(), 0u);
+	ASSERT_EQ(empty.begin(), empty.end());
+
+	bmstu::segmented_vector<int> v(5);
+	ASSERT_EQ(v.size(), 5u);
+	ASSERT_EQ(v.capacity(), 16u);
+	ASSERT_EQ(v[4], 0);
+	bmstu::segmented_vector<std::string> words{"a", "b", "c"};
+	ASSERT_EQ(words.at(2), "c");
+	ASSERT_THROW(words.at(3), std::out_of_range);
+}
+
+TEST(SegmentedVectorTest, RandomAccessAcrossChunks)
+{
+	bmstu::segmented_vector<size_t> v;
+	for (size_t i = 0; i < 5000; ++i)
+	{
+		v.push_back(i * 3);
+	}
+	// 16 + 32 + ... + 4096
+	ASSERT_EQ(v.chunk_count(), 9u);
+	ASSERT_EQ(v.capacity(), 16u * 511);
+	for (size_t i = 0; i < v.size(); ++i)
+	{
+		ASSERT_EQ(v[i], i * 3);
+	}
+	ASSERT_EQ(*(v.begin() + 4999), 4999u * 3);
+}
+
+TEST(SegmentedVectorTest, StableAddresses)
+{
+	bmstu::segmented_vector<std::string> v;
+	v.emplace_back("first");
+	std::string* first = &v[0];
+	std::vector<const std::string*> addresses;
+	for (int i = 0; i < 1000; ++i)
+	{
+		// the argument refers to an element, growth doesn't move it
+		v.emplace_back(v[0]);
+		addresses.push_back(&v.at(i + 1));
+	}
+	ASSERT_EQ(&v[0], first);
+	for (int i = 0; i < 1000; ++i)
+	{
+		ASSERT_EQ(&v[i + 1], addresses[i]);
+	}
+	ASSERT_EQ(v[1000], "first");
+}
+
+TEST(SegmentedVectorTest, Iterators)
+{
+	bmstu::segmented_vector<int> v;
+	for (int i = 0; i < 100; ++i)
+	{
+		v.push_back(99 - i);
+	}
+	std::sort(v.begin(), v.end());
+	ASSERT_TRUE(std::is_sorted(v.cbegin(), v.cend()));
+	ASSERT_EQ(std::accumulate(v.begin(), v.end(), 0), 4950);
+	auto it = v.begin();
+	ASSERT_EQ(it[20], 20);
+	ASSERT_EQ(*(20 + it), 20);
+	it += 30;
+	ASSERT_EQ(*it--, 30);
+	ASSERT_EQ(*it, 29);
+	ASSERT_TRUE(v.begin() < it);
+	ASSERT_EQ(v.end() - it, 71);
+	bmstu::segmented_vector<int>::const_iterator cit = it;
+	ASSERT_TRUE(cit == it);
+	ASSERT_EQ(std::ranges::find(v, 64) - v.begin(), 64);
+	// iterators are indices, so they survive growth
+	auto last = v.end() - 1;
+	for (int i = 0; i < 1000; ++i)
+	{
+		v.push_back(i);
+	}
+	ASSERT_EQ(*last, 99);
+	std::vector<int> reversed(v.end() - 3, v.end());
+	std::reverse(reversed.begin(), reversed.end());
+	ASSERT_EQ(reversed, (std::vector<int>{999, 998, 997}));
+}
+
+TEST(SegmentedVectorTest, CopyMoveCompare)
+{
+	bmstu::segmented_vector<std::string> v;
+	for (int i = 0; i < 100; ++i)
+	{
+		v.push_back(std::to_string(i));
+	}
+	bmstu::segmented_vector<std::string> copy(v);
+	ASSERT_EQ(copy, v);
+	copy[99] = "x";
+	ASSERT_TRUE(v < copy);
+	copy.pop_back();
+	ASSERT_TRUE(copy < v);
+	ASSERT_EQ(copy <=> copy, std::weak_ordering::equivalent);
+
+	bmstu::segmented_vector<std::string> moved(std::move(copy));
+	ASSERT_TRUE(copy.empty());
+	ASSERT_EQ(moved.size(), 99u);
+	copy = moved;
+	ASSERT_EQ(copy, moved);
+
+	bmstu::segmented_vector<int> ints{1, 2, 3};
+	std::ostringstream os;
+	os << ints;
+	ASSERT_EQ(os.str(), "{1, 2, 3}");
+	ASSERT_TRUE(ints != (bmstu::segmented_vector<int>{1, 2}));
+	ASSERT_TRUE((bmstu::segmented_vector<int>{1, 2}) < ints);
+}
+
+namespace
+{
+// Copies throw once copies_left runs out
+struct Fragile
+{
+	Fragile(int v) : value(v) { ++alive; }
+
+	Fragile(const Fragile& other) : value(other.value)
+	{
+		if (copies_left-- == 0)
+		{
+			throw std::runtime_error("copy failed");
+		}
+		++alive;
+	}
+
+	~Fragile() { --alive; }
+
+	int value;
+	inline static int alive = 0;
+	inline static int copies_left = 0;
+};
+}  // namespace
+
+TEST(SegmentedVectorTest, ThrowingCopyLeaksNothing)
+{
+	{
+		bmstu::segmented_vector<Fragile> v;
+		for (int i = 0; i < 100; ++i)
+		{
+			v.emplace_back(i);
+		}
+		Fragile::copies_left = 50;
+		ASSERT_THROW(bmstu::segmented_vector<Fragile> copy(v),
+					 std::runtime_error);
+		ASSERT_EQ(Fragile::alive, 100);
+
+		Fragile::copies_left = 20;
+		ASSERT_THROW(bmstu::segmented_vector<Fragile>(40, Fragile(7)),
+					 std::runtime_error);
+		ASSERT_EQ(Fragile::alive, 100);
+
+		Fragile::copies_left = 1;
+		ASSERT_THROW((bmstu::segmented_vector<Fragile>{1, 2, 3}),
+					 std::runtime_error);
+		ASSERT_EQ(Fragile::alive, 100);
+	}
+	ASSERT_EQ(Fragile::alive, 0);
+}
+
+TEST(SegmentedVectorTest, ClearAndShrink)
+{
+	bmstu::segmented_vector<std::string> v(1000, "value");
+	const size_t capacity = v.capacity();
+	v.clear();
+	ASSERT_TRUE(v.empty());
+	ASSERT_EQ(v.capacity(), capacity);
+	v.push_back("again");
+	ASSERT_EQ(v[0], "again");
+	v.shrink_to_fit();
+	ASSERT_EQ(v.chunk_count(), 1u);
+	ASSERT_EQ(v.capacity(), 16u);
+	v.clear();
+	v.shrink_to_fit();
+	ASSERT_EQ(v.capacity(), 0u);
+}
+
+namespace
+{
+// Runs func in a child process so each container gets its own peak RSS; a
+// container that doesn't fit in memory only takes its child down
+template <typename Func>
+void in_child(const char* name, Func func)
+{
+#if defined(__unix__)
+	std::cout.flush();
+	const pid_t pid = fork();
+	if (pid == 0)
+	{
+		auto start = std::chrono::steady_clock::now();
+		const long long checksum = func();
+		auto elapsed = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start);
+		std::cout << name << ": " << elapsed.count() << " ms (checksum "
+				  << checksum << ")" << std::endl;
+		_exit(0);
+	}
+	int status = 0;
+	rusage usage{};
+	wait4(pid, &status, 0, &usage);
+	if (WIFSIGNALED(status))
+	{
+		std::cout << name << ": killed by signal " << WTERMSIG(status)
+				  << std::endl;
+	}
+	std::cout << name << ": peak RSS " << usage.ru_maxrss / 1024 << " MB"
+			  << std::endl;
+#else
+	std::cout << name << ": needs fork()" << std::endl;
+#endif
+}
+
+template <typename Vector>
+long long append(size_t count)
+{
+	Vector v;
+	for (size_t i = 0; i < count; ++i)
+	{
+		v.push_back(static_cast<int>(i));
+	}
+	return v[count - 1];
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SegmentedVectorBench, DISABLED_Append1e9)
+{
+	constexpr size_t count = 1'000'000'000;
+	in_child("segmented_vector<int>, 10^9 push_back",
+			 [] { return append<bmstu::segmented_vector<int>>(count); });
+	in_child("simple_vector<int>, 10^9 push_back",
+			 [] { return append<bmstu::simple_vector<int>>(count); });
+}
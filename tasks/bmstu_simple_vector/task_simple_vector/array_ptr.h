@@ -1,18 +1,21 @@
 #pragma once
 #include <algorithm>
+#include <bit>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <type_traits>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 namespace
 {
-template <typename T>
-void my_fill(T* ptr, size_t size, const T& value = {})
-{
-	for (size_t i = 0; i < size; ++i)
-	{
-		ptr[i] = value;
-	}
-}
-
 template <typename T>
 void my_swap(T& a, T& b)
 {
@@ -20,51 +23,265 @@ void my_swap(T& a, T& b)
 	a = b;
 	b = tmp;
 }
+
+#if defined(__linux__)
+// Huge page bytes /proc/self/smaps lists for the mapping that holds addr
+inline size_t smaps_huge_bytes(const void* addr) noexcept
+{
+	FILE* smaps = std::fopen("/proc/self/smaps", "r");
+	if (smaps == nullptr)
+	{
+		return 0;
+	}
+	const uintptr_t target = reinterpret_cast<uintptr_t>(addr);
+	bool inside = false;
+	size_t kb = 0;
+	char* line = nullptr;
+	size_t line_cap = 0;
+	while (::getline(&line, &line_cap, smaps) > 0)
+	{
+		// a mapping starts with "first-last perms ...", then "Field: n kB"
+		uintptr_t first = 0;
+		uintptr_t last = 0;
+		if (std::sscanf(line, "%" SCNxPTR "-%" SCNxPTR, &first, &last) == 2)
+		{
+			if (inside)
+			{
+				break;
+			}
+			inside = first <= target && target < last;
+			continue;
+		}
+		char field[32];
+		size_t value = 0;
+		if (inside && std::sscanf(line, "%31[^:]: %zu", field, &value) == 2 &&
+			(std::strcmp(field, "AnonHugePages") == 0 ||
+			 std::strcmp(field, "Shared_Hugetlb") == 0 ||
+			 std::strcmp(field, "Private_Hugetlb") == 0))
+		{
+			kb += value;
+		}
+	}
+	std::free(line);
+	std::fclose(smaps);
+	return kb * 1024;
+}
+#endif
 }  // namespace
 
 namespace bmstu
 {
-template <typename T>
+// Where array_ptr takes its memory from. The huge modes map whole 2 MB
+// pages, so a multi-GB buffer needs 512 times fewer TLB entries:
+//  - transparent_huge: anonymous mmap aligned to 2 MB with MADV_HUGEPAGE,
+//    which the kernel backs with huge pages on first touch where it can
+//  - explicit_huge: MAP_HUGETLB pages from the reserved hugetlbfs pool,
+//    falling back to transparent_huge when the pool can't cover the buffer
+// Mapped pages are placed on first touch, so under the default NUMA policy
+// each lands on the node of the thread that writes it first. Off Linux the
+// huge modes allocate like standard.
+enum class page_mode
+{
+	standard,
+	transparent_huge,
+	explicit_huge,
+};
+
+inline constexpr size_t huge_page_size = size_t{2} << 20;
+
+inline constexpr size_t cache_line_size = 64;
+
+// Allocator whose buffers start on an Align boundary (or alignof(T) if
+// larger), e.g. a cache line or a SIMD register width, so kernels can use
+// aligned loads. Stateless: all instances are equal.
+template <typename T, size_t Align = cache_line_size>
+struct aligned_allocator
+{
+	static_assert(std::has_single_bit(Align), "Align must be a power of two");
+
+	using value_type = T;
+	using is_always_equal = std::true_type;
+
+	static constexpr size_t alignment = std::max(Align, alignof(T));
+
+	template <typename U>
+	struct rebind
+	{
+		using other = aligned_allocator<U, Align>;
+	};
+
+	aligned_allocator() noexcept = default;
+
+	template <typename U>
+	aligned_allocator(const aligned_allocator<U, Align>&) noexcept
+	{
+	}
+
+	[[nodiscard]] T* allocate(size_t size)
+	{
+		if (size > SIZE_MAX / sizeof(T))
+		{
+			throw std::bad_array_new_length();
+		}
+		return static_cast<T*>(
+			::operator new(size * sizeof(T), std::align_val_t(alignment)));
+	}
+
+	void deallocate(T* ptr, size_t) noexcept
+	{
+		::operator delete(ptr, std::align_val_t(alignment));
+	}
+
+	template <typename U>
+	friend bool operator==(const aligned_allocator&,
+						   const aligned_allocator<U, Align>&) noexcept
+	{
+		return true;
+	}
+};
+
+// Alignment of the buffers Allocator hands out for T
+template <typename T, typename Allocator>
+constexpr size_t buffer_alignment_v = alignof(T);
+
+template <typename T, typename U, size_t Align>
+constexpr size_t buffer_alignment_v<T, aligned_allocator<U, Align>> =
+	aligned_allocator<T, Align>::alignment;
+
+// Raw storage from Allocator, which may be any standard allocator or a
+// std::pmr::polymorphic_allocator. The allocator follows the buffer the
+// way it follows a standard container's: on move assignment and swap only
+// if its propagate_on_container_* trait says so, and otherwise the two
+// allocators must compare equal. Huge page modes map memory directly and
+// leave the allocator unused.
+template <typename T, typename Allocator = std::allocator<T>>
 class array_ptr
 {
+	using traits = std::allocator_traits<Allocator>;
+
+	static_assert(std::is_same_v<typename traits::value_type, T>);
+
    public:
+	using allocator_type = Allocator;
+
+	static constexpr size_t alignment = buffer_alignment_v<T, Allocator>;
+
+	static_assert(alignment <= huge_page_size);
+
 	array_ptr() = default;
-	explicit array_ptr(size_t size)
+
+	explicit array_ptr(const Allocator& alloc) noexcept : alloc_(alloc) {}
+
+	// Raw storage for size objects of T: nothing is constructed here and
+	// nothing is destroyed in the destructor, the owner manages lifetimes
+	explicit array_ptr(size_t size) : array_ptr(size, page_mode::standard) {}
+
+	// An empty array_ptr still keeps the mode, for its owner to reuse
+	array_ptr(size_t size, page_mode mode, const Allocator& alloc = Allocator())
+		: alloc_(alloc), mode_(mode)
 	{
-		if (size > 0)
+		if (size == 0)
 		{
-			raw_ptr_ = new T[size];
-			my_fill(raw_ptr_, size);
+			return;
 		}
-		else
+#if defined(__linux__)
+		if (mode != page_mode::standard)
 		{
-			raw_ptr_ = nullptr;
+			raw_ptr_ = map_pages(size);
+			size_ = size;
+			return;
 		}
+#endif
+		raw_ptr_ = traits::allocate(alloc_, size);
+		size_ = size;
+	}
+
+	// raw_ptr and size must come from release() and size() of a standard
+	// mode array_ptr with an equal allocator
+	array_ptr(T* raw_ptr, size_t size, const Allocator& alloc = Allocator())
+		: raw_ptr_(raw_ptr), size_(size), alloc_(alloc)
+	{
 	}
-	explicit array_ptr(T* raw_ptr) : raw_ptr_(raw_ptr) {}
 	array_ptr(const array_ptr& other) = delete;
 	array_ptr& operator=(const array_ptr& other) = delete;
-	array_ptr(array_ptr&& other) noexcept : raw_ptr_(other.raw_ptr_)
+	array_ptr(array_ptr&& other) noexcept
+		: raw_ptr_(other.raw_ptr_),
+		  size_(other.size_),
+		  mapped_bytes_(other.mapped_bytes_),
+		  alloc_(std::move(other.alloc_)),
+		  mode_(other.mode_)
 	{
 		other.raw_ptr_ = nullptr;
+		other.size_ = 0;
+		other.mapped_bytes_ = 0;
 	}
 	array_ptr& operator=(array_ptr&& other) noexcept
 	{
 		if (this != &other)
 		{
-			delete[] raw_ptr_;
+			free_storage();
+			if constexpr (traits::propagate_on_container_move_assignment::value)
+			{
+				alloc_ = std::move(other.alloc_);
+			}
 			raw_ptr_ = other.raw_ptr_;
+			size_ = other.size_;
+			mapped_bytes_ = other.mapped_bytes_;
+			mode_ = other.mode_;
 			other.raw_ptr_ = nullptr;
+			other.size_ = 0;
+			other.mapped_bytes_ = 0;
 		}
 		return *this;
 	}
 
 	T* get() const noexcept { return raw_ptr_; }
 
+	// Objects the buffer has room for
+	size_t size() const noexcept { return size_; }
+
 	explicit operator bool() const noexcept { return raw_ptr_ != nullptr; }
 
-	~array_ptr() { delete[] raw_ptr_; }
-	void swap(array_ptr& other) noexcept { my_swap(raw_ptr_, other.raw_ptr_); }
+	page_mode mode() const noexcept { return mode_; }
+
+	Allocator get_allocator() const noexcept { return alloc_; }
+
+	// Frees the buffer and switches to alloc, which must be assignable
+	void reset(const Allocator& alloc) noexcept
+	{
+		free_storage();
+		raw_ptr_ = nullptr;
+		size_ = 0;
+		mapped_bytes_ = 0;
+		alloc_ = alloc;
+	}
+
+	// Bytes of the buffer the kernel backs with huge pages right now, from
+	// /proc/self/smaps; 0 for heap storage. Transparent huge pages appear
+	// as the buffer is touched, and khugepaged may collapse more later.
+	size_t huge_page_bytes() const noexcept
+	{
+#if defined(__linux__)
+		if (mapped_bytes_ > 0)
+		{
+			return std::min(smaps_huge_bytes(raw_ptr_), mapped_bytes_);
+		}
+#endif
+		return 0;
+	}
+
+	~array_ptr() { free_storage(); }
+	void swap(array_ptr& other) noexcept
+	{
+		my_swap(raw_ptr_, other.raw_ptr_);
+		my_swap(size_, other.size_);
+		my_swap(mapped_bytes_, other.mapped_bytes_);
+		my_swap(mode_, other.mode_);
+		if constexpr (traits::propagate_on_container_swap::value)
+		{
+			my_swap(alloc_, other.alloc_);
+		}
+	}
 
 	const T& operator[](size_t index) const
 	{
@@ -73,14 +290,82 @@ class array_ptr
 
 	T& operator[](size_t index) { return raw_ptr_[index]; }
 
+	// Only for standard mode: a mapped buffer can't be handed back
 	[[nodiscard]] T* release() noexcept
 	{
 		T* tmp = raw_ptr_;
 		raw_ptr_ = nullptr;
+		size_ = 0;
 		return tmp;
 	}
 
    private:
+#if defined(__linux__)
+	// Whole huge pages, the first one 2 MB aligned
+	T* map_pages(size_t size)
+	{
+		if (size > (SIZE_MAX - 2 * huge_page_size) / sizeof(T))
+		{
+			throw std::bad_alloc();
+		}
+		const size_t bytes = (size * sizeof(T) + huge_page_size - 1) &
+							 ~(huge_page_size - 1);
+		constexpr int prot = PROT_READ | PROT_WRITE;
+		constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+		if (mode_ == page_mode::explicit_huge)
+		{
+			void* pages =
+				::mmap(nullptr, bytes, prot, flags | MAP_HUGETLB, -1, 0);
+			if (pages != MAP_FAILED)
+			{
+				mapped_bytes_ = bytes;
+				return static_cast<T*>(pages);
+			}
+		}
+		// map one page more and trim both ends to an aligned range
+		void* raw = ::mmap(nullptr, bytes + huge_page_size, prot, flags, -1, 0);
+		if (raw == MAP_FAILED)
+		{
+			throw std::bad_alloc();
+		}
+		const uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+		const uintptr_t first =
+			(start + huge_page_size - 1) & ~(huge_page_size - 1);
+		if (first > start)
+		{
+			::munmap(raw, first - start);
+		}
+		::munmap(reinterpret_cast<void*>(first + bytes),
+				 huge_page_size - (first - start));
+		::madvise(reinterpret_cast<void*>(first), bytes, MADV_HUGEPAGE);
+		mapped_bytes_ = bytes;
+		return reinterpret_cast<T*>(first);
+	}
+#endif
+
+	void free_storage() noexcept
+	{
+#if defined(__linux__)
+		if (mapped_bytes_ > 0)
+		{
+			::munmap(raw_ptr_, mapped_bytes_);
+			return;
+		}
+#endif
+		if (raw_ptr_ != nullptr)
+		{
+			traits::deallocate(alloc_, raw_ptr_, size_);
+		}
+	}
+
 	T* raw_ptr_ = nullptr;
+	size_t size_ = 0;
+	// non-zero when raw_ptr_ is an mmap of this many bytes
+	size_t mapped_bytes_ = 0;
+	[[no_unique_address]] Allocator alloc_;
+	page_mode mode_ = page_mode::standard;
 };
-}  // namespace bmstu
\ No newline at end of file
+
+template <typename T, size_t Align = cache_line_size>
+using aligned_array_ptr = array_ptr<T, aligned_allocator<T, Align>>;
+}  // namespace bmstu
@@ -0,0 +1,48 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <type_traits>
+
+// Helpers for the DISABLED_ benchmarks of this module
+namespace bmstu::bench
+{
+// xorshift64: fast and reproducible, good enough for test data
+inline uint64_t next_random(uint64_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+// Runs func rounds times and prints the wall time. When func returns a
+// value the results are summed and printed, so the optimizer can't drop
+// the work.
+template <typename Func>
+void time_it(std::string_view name, Func func, int rounds = 1)
+{
+	auto start = std::chrono::steady_clock::now();
+	long long checksum = 0;
+	for (int round = 0; round < rounds; ++round)
+	{
+		if constexpr (std::is_void_v<std::invoke_result_t<Func&>>)
+		{
+			func();
+		}
+		else
+		{
+			checksum += func();
+		}
+	}
+	auto elapsed = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start);
+	std::cout << name << ": " << elapsed.count() << " ms";
+	if constexpr (!std::is_void_v<std::invoke_result_t<Func&>>)
+	{
+		std::cout << " (checksum " << checksum << ")";
+	}
+	std::cout << std::endl;
+}
+}  // namespace bmstu::bench
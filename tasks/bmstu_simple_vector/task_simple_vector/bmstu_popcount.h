@@ -0,0 +1,104 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#endif
+
+// Set-bit count over an array of 64-bit words, shared by the bitmaps
+// (dynamic_bitset, nullable_vector's validity bits).
+//
+// Without -mpopcnt std::popcount is a libgcc call per word, so on x86 with
+// GCC or Clang the kernel is picked once at run time: AVX2 counts 4 words
+// at a time (a nibble lookup table through vpshufb gives per-byte counts,
+// vpsadbw sums them into 64-bit lanes), otherwise the popcnt instruction
+// goes one word at a time. A build that already targets AVX2 calls that
+// kernel directly.
+namespace bmstu
+{
+namespace
+{
+inline size_t popcount_scalar(const uint64_t* words, size_t count)
+{
+	size_t total = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		total += static_cast<size_t>(std::popcount(words[i]));
+	}
+	return total;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+[[gnu::target("popcnt")]] inline size_t popcount_popcnt(const uint64_t* words,
+														size_t count)
+{
+	size_t total = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		total += static_cast<size_t>(__builtin_popcountll(words[i]));
+	}
+	return total;
+}
+
+[[gnu::target("avx2,popcnt")]] inline size_t popcount_avx2(
+	const uint64_t* words, size_t count)
+{
+	const __m256i lookup =
+		_mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,  //
+						 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i low_nibbles = _mm256_set1_epi8(0x0F);
+	__m256i sums = _mm256_setzero_si256();
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m256i v =
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+		const __m256i low = _mm256_and_si256(v, low_nibbles);
+		const __m256i high =
+			_mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibbles);
+		const __m256i bytes =
+			_mm256_add_epi8(_mm256_shuffle_epi8(lookup, low),
+							_mm256_shuffle_epi8(lookup, high));
+		sums = _mm256_add_epi64(
+			sums, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+	}
+	alignas(32) uint64_t lanes[4];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sums);
+	size_t total = static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] +
+									   lanes[3]);
+	for (; i < count; ++i)
+	{
+		total += static_cast<size_t>(__builtin_popcountll(words[i]));
+	}
+	return total;
+}
+#endif
+
+// Set bits in words[0, count)
+inline size_t popcount_words(const uint64_t* words, size_t count)
+{
+#if defined(__GNUC__) && defined(__AVX2__)
+	return popcount_avx2(words, count);
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	static const auto kernel = []
+	{
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+		{
+			return &popcount_avx2;
+		}
+		if (__builtin_cpu_supports("popcnt"))
+		{
+			return &popcount_popcnt;
+		}
+		return &popcount_scalar;
+	}();
+	return kernel(words, count);
+#else
+	return popcount_scalar(words, count);
+#endif
+}
+}  // namespace
+}  // namespace bmstu
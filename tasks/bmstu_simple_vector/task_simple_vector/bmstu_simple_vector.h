@@ -1,210 +1,860 @@
+#pragma once
+#include <algorithm>
+#include <compare>
+#include <initializer_list>
+#include <iterator>
 #include <ostream>
+#include <ranges>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include "array_ptr.h"
+#include "bmstu_vector_compare.h"
 
 namespace bmstu
 {
-template <typename T>
-class simple_vector
+// Iterator of simple_vector and small_vector over Value or const Value; the
+// mutable one converts to the const one. Satisfies std::contiguous_iterator,
+// so std::to_address(it) gives the element pointer and algorithms can work
+// on raw memory.
+template <typename Value>
+class vector_iterator
 {
    public:
-	class iterator
+	using iterator_concept = std::contiguous_iterator_tag;
+	using iterator_category = std::contiguous_iterator_tag;
+	using value_type = std::remove_cv_t<Value>;
+	using element_type = Value;
+	using pointer = Value*;
+	using reference = Value&;
+	using difference_type = std::ptrdiff_t;
+
+	vector_iterator() = default;
+
+	vector_iterator(std::nullptr_t) noexcept : ptr_(nullptr) {}
+
+	explicit vector_iterator(pointer ptr) : ptr_(ptr) {}
+
+	template <typename Other>
+		requires(std::is_const_v<Value> &&
+				 std::is_same_v<Other, std::remove_const_t<Value>>)
+	vector_iterator(const vector_iterator<Other>& other) noexcept
+		: ptr_(std::to_address(other))
 	{
-	   public:
-		using iterator_category = std::contiguous_iterator_tag;
-		using value_type = T;
-		using pointer = T*;
-		using reference = T&;
-		using difference_type = std::ptrdiff_t;
+	}
+
+	reference operator*() const { return *ptr_; }
+
+	pointer operator->() const { return ptr_; }
+
+	reference operator[](difference_type n) const { return ptr_[n]; }
+
+	friend pointer to_address(const vector_iterator& it) noexcept
+	{
+		return it.ptr_;
+	}
+
+	vector_iterator& operator=(std::nullptr_t) noexcept
+	{
+		ptr_ = nullptr;
+		return *this;
+	}
 
-		iterator() = default;
+#pragma region Operators
+	vector_iterator& operator++()
+	{
+		++ptr_;
+		return *this;
+	}
 
-		iterator(const iterator& other) = default;
+	vector_iterator& operator--()
+	{
+		--ptr_;
+		return *this;
+	}
 
-		iterator(std::nullptr_t) noexcept : ptr_(nullptr) {}
+	vector_iterator operator++(int)
+	{
+		vector_iterator copy(*this);
+		++ptr_;
+		return copy;
+	}
 
-		iterator(iterator&& other) noexcept : ptr_(nullptr) {}
+	vector_iterator operator--(int)
+	{
+		vector_iterator copy(*this);
+		--ptr_;
+		return copy;
+	}
 
-		explicit iterator(pointer ptr) : ptr_(ptr) {}
+	explicit operator bool() const { return ptr_ != nullptr; }
 
-		reference operator*() const { return *ptr_; }
+	friend bool operator==(const vector_iterator& lhs,
+						   const vector_iterator& rhs)
+	{
+		return lhs.ptr_ == rhs.ptr_;
+	}
 
-		pointer operator->() const { return ptr_; }
+	friend bool operator==(const vector_iterator& lhs, std::nullptr_t)
+	{
+		return lhs.ptr_ == nullptr;
+	}
 
-		friend pointer to_address(const iterator& it) noexcept
+	friend auto operator<=>(const vector_iterator& lhs,
+							const vector_iterator& rhs)
+	{
+		return lhs.ptr_ <=> rhs.ptr_;
+	}
+
+	vector_iterator& operator+=(difference_type n) noexcept
+	{
+		ptr_ += n;
+		return *this;
+	}
+
+	vector_iterator& operator-=(difference_type n) noexcept
+	{
+		ptr_ -= n;
+		return *this;
+	}
+
+	friend vector_iterator operator+(const vector_iterator& it,
+									difference_type n) noexcept
+	{
+		return vector_iterator(it.ptr_ + n);
+	}
+
+	friend vector_iterator operator+(difference_type n,
+									const vector_iterator& it) noexcept
+	{
+		return vector_iterator(it.ptr_ + n);
+	}
+
+	friend vector_iterator operator-(const vector_iterator& it,
+									difference_type n) noexcept
+	{
+		return vector_iterator(it.ptr_ - n);
+	}
+
+	friend difference_type operator-(const vector_iterator& end,
+									 const vector_iterator& begin) noexcept
+	{
+		return end.ptr_ - begin.ptr_;
+	}
+
+#pragma endregion
+   private:
+	pointer ptr_ = nullptr;
+};
+
+// Growth policy: capacity goes up by Num/Den (at least by one slot), which
+// keeps push_back amortized O(1). 1.5x wastes less memory and lets the
+// allocator reuse freed blocks, 2x copies less often.
+template <size_t Num, size_t Den>
+struct geometric_growth
+{
+	static_assert(Num > Den && Den > 0);
+
+	static constexpr bool shrink_when_sparse = false;
+
+	static size_t next_capacity(size_t capacity, size_t required) noexcept
+	{
+		const size_t step = std::max<size_t>(capacity / Den * (Num - Den), 1);
+		return std::max(required, capacity + step);
+	}
+};
+
+using growth_x2 = geometric_growth<2, 1>;
+using growth_x1_5 = geometric_growth<3, 2>;
+
+// Gives memory back in pop_back/erase: once size drops below capacity / 4
+// the capacity is halved. The gap between the two thresholds keeps a vector
+// that oscillates around one size from reallocating on every call.
+template <typename Growth>
+struct hysteresis : Growth
+{
+	static constexpr bool shrink_when_sparse = true;
+};
+
+// Growth, insertion and erasure shared by simple_vector and small_vector,
+// which differ only in where the elements live. Derived befriends this
+// class and provides:
+//   T* data();  size_t capacity() const;  size_t size_;
+//   allocate(size_t cap)      raw storage for cap elements, owning it
+//                             (with get()) until adopted
+//   void adopt(storage&&, size_t cap) noexcept
+//                             switches to storage already holding the
+//                             elements
+//   void reallocate(size_t cap)  moves the elements to a capacity of cap
+//   inline_capacity           optional, capacity never shrinks below it
+template <typename Derived, typename T, typename Growth>
+class vector_base
+{
+   public:
+	using iterator = vector_iterator<T>;
+	using const_iterator = vector_iterator<const T>;
+
+	// New elements are value-initialized (zeroed for scalars)
+	void resize(size_t new_size)
+	{
+		grow_to(new_size);
+		Derived& vec = self();
+		if (new_size > vec.size_)
 		{
-			return it.ptr_;
+			std::uninitialized_value_construct(vec.data() + vec.size_,
+											   vec.data() + new_size);
 		}
+		shrink_to(new_size);
+	}
 
-		iterator& operator=(const iterator& other) = default;
-
-		iterator& operator=(iterator&& other) noexcept { return *this; }
+	// New elements are default-initialized: for trivial T nothing is written,
+	// so the caller must overwrite them before reading
+	void resize_for_overwrite(size_t new_size)
+	{
+		grow_to(new_size);
+		Derived& vec = self();
+		if (new_size > vec.size_)
+		{
+			std::uninitialized_default_construct(vec.data() + vec.size_,
+												 vec.data() + new_size);
+		}
+		shrink_to(new_size);
+	}
 
-#pragma region Operators
-		iterator& operator++() { return *this; }
+	template <typename... Args>
+	T& emplace_back(Args&&... args)
+	{
+		Derived& vec = self();
+		T* slot;
+		if (vec.size_ < vec.capacity())
+		{
+			slot = std::construct_at(vec.data() + vec.size_,
+									 std::forward<Args>(args)...);
+		}
+		else
+		{
+			// construct before relocating: args may refer to our elements
+			const size_t new_cap =
+				Growth::next_capacity(vec.capacity(), vec.size_ + 1);
+			auto new_data = vec.allocate(new_cap);
+			slot = std::construct_at(new_data.get() + vec.size_,
+									 std::forward<Args>(args)...);
+			try
+			{
+				relocate_to(new_data.get());
+			}
+			catch (...)
+			{
+				std::destroy_at(slot);
+				throw;
+			}
+			vec.adopt(std::move(new_data), new_cap);
+		}
+		++vec.size_;
+		return *slot;
+	}
 
-		iterator& operator--() { return *this; }
+	template <typename... Args>
+	iterator emplace(const_iterator where, Args&&... args)
+	{
+		Derived& vec = self();
+		const size_t index = where - vec.cbegin();
+		if (index == vec.size_)
+		{
+			emplace_back(std::forward<Args>(args)...);
+			return iterator(vec.data() + index);
+		}
+		T value(std::forward<Args>(args)...);
+		emplace_back(std::move(vec.data()[vec.size_ - 1]));
+		T* data = vec.data();
+		std::move_backward(data + index, data + vec.size_ - 2,
+						   data + vec.size_ - 1);
+		data[index] = std::move(value);
+		return iterator(data + index);
+	}
 
-		iterator operator++(int) { return *this; }
+	iterator insert(const_iterator where, T&& value)
+	{
+		return emplace(where, std::move(value));
+	}
 
-		iterator operator--(int) { return *this; }
+	iterator insert(const_iterator where, const T& value)
+	{
+		return emplace(where, value);
+	}
 
-		explicit operator bool() const { return ptr_ != nullptr; }
+	iterator insert(const_iterator where, size_t count, const T& value)
+	{
+		// value may be one of our own elements, about to be moved
+		const T copy(value);
+		return insert_gap(
+			where - self().cbegin(), count,
+			[&](T* out, size_t, size_t n)
+			{ std::uninitialized_fill_n(out, n, copy); },
+			[&](T* out, size_t, size_t n) { std::fill_n(out, n, copy); });
+	}
 
-		friend bool operator==(const iterator& lhs, const iterator& rhs)
+	// [first, last) must not point into this vector
+	template <std::input_iterator It>
+	iterator insert(const_iterator where, It first, It last)
+	{
+		Derived& vec = self();
+		const size_t index = where - vec.cbegin();
+		if constexpr (std::forward_iterator<It>)
 		{
-			return "false";
+			return insert_gap(
+				index, std::distance(first, last),
+				[&](T* out, size_t from, size_t n)
+				{ std::uninitialized_copy_n(std::next(first, from), n, out); },
+				[&](T* out, size_t from, size_t n)
+				{ std::copy_n(std::next(first, from), n, out); });
 		}
+		else
+		{
+			// length unknown up front: append, then rotate into place
+			const size_t old_size = vec.size_;
+			for (; first != last; ++first)
+			{
+				emplace_back(*first);
+			}
+			T* data = vec.data();
+			std::rotate(data + index, data + old_size, data + vec.size_);
+			return iterator(data + index);
+		}
+	}
 
-		friend bool operator==(const iterator& lhs, std::nullptr_t)
+	iterator insert(const_iterator where, std::initializer_list<T> values)
+	{
+		return insert(where, values.begin(), values.end());
+	}
+
+	// Reserves once when the length is known, then constructs in place
+	template <std::ranges::input_range Range>
+	void append_range(Range&& range)
+	{
+		if constexpr (std::ranges::forward_range<Range> ||
+					  std::ranges::sized_range<Range>)
 		{
-			return "false";
+			grow_to(self().size_ + std::ranges::distance(range));
 		}
+		for (auto&& value : range)
+		{
+			emplace_back(std::forward<decltype(value)>(value));
+		}
+	}
+
+	void push_back(T&& value) { emplace_back(std::move(value)); }
 
-		iterator& operator=(std::nullptr_t) noexcept
+	void push_back(const T& value) { emplace_back(value); }
+
+	void clear() noexcept { shrink_to(0); }
+
+	bool empty() const noexcept { return self().size_ == 0; }
+
+	void pop_back()
+	{
+		Derived& vec = self();
+		if (vec.size_ > 0)
 		{
-			ptr_ = nullptr;
-			return *this;
+			std::destroy_at(vec.data() + --vec.size_);
+			release_if_sparse();
 		}
+	}
 
-		friend bool operator==(std::nullptr_t, const iterator& rhs)
+	// erase(end()) drops the last element
+	iterator erase(const_iterator where)
+	{
+		Derived& vec = self();
+		if (vec.size_ == 0)
 		{
-			return true;
+			return vec.end();
 		}
+		size_t index = where - vec.cbegin();
+		if (index >= vec.size_)
+		{
+			index = vec.size_ - 1;
+		}
+		T* data = vec.data();
+		std::move(data + index + 1, data + vec.size_, data + index);
+		std::destroy_at(data + --vec.size_);
+		release_if_sparse();
+		return iterator(vec.data() + index);
+	}
 
-		friend bool operator!=(const iterator& lhs, const iterator& rhs)
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		Derived& vec = self();
+		const size_t index = first - vec.cbegin();
+		const size_t count = last - first;
+		if (count > 0)
 		{
-			return true;
+			T* data = vec.data();
+			std::move(data + index + count, data + vec.size_, data + index);
+			shrink_to(vec.size_ - count);
+			release_if_sparse();
 		}
+		return iterator(vec.data() + index);
+	}
 
-		iterator operator+(const difference_type& n) const noexcept
+   protected:
+	void grow_to(size_t new_size)
+	{
+		Derived& vec = self();
+		if (new_size > vec.capacity())
 		{
-			return nullptr;
+			vec.reallocate(Growth::next_capacity(vec.capacity(), new_size));
 		}
+	}
 
-		iterator operator+=(const difference_type& n) noexcept
+	// Gives memory back for Growth policies that ask for it, see hysteresis
+	void release_if_sparse()
+	{
+		if constexpr (Growth::shrink_when_sparse)
 		{
-			return nullptr;
+			Derived& vec = self();
+			size_t floor = 0;
+			if constexpr (requires { Derived::inline_capacity; })
+			{
+				floor = Derived::inline_capacity;
+			}
+			size_t new_cap = vec.capacity();
+			while (new_cap > floor && vec.size_ < new_cap / 4)
+			{
+				new_cap /= 2;
+			}
+			if (new_cap != vec.capacity())
+			{
+				vec.reallocate(new_cap);
+			}
 		}
+	}
 
-		iterator operator-(const difference_type& n) const noexcept
+	void shrink_to(size_t new_size) noexcept
+	{
+		Derived& vec = self();
+		if (new_size < vec.size_)
 		{
-			return nullptr;
+			std::destroy(vec.data() + new_size, vec.data() + vec.size_);
 		}
+		vec.size_ = new_size;
+	}
 
-		iterator operator-=(const difference_type& n) noexcept
+	// Makes room for count elements at index and fills it: construct(out,
+	// from, n) for raw slots, assign(out, from, n) for slots still holding a
+	// moved-from element, from being the offset into the inserted sequence.
+	// At most one reallocation, and every old element moves once.
+	template <typename Construct, typename Assign>
+	iterator insert_gap(size_t index,
+						size_t count,
+						Construct construct,
+						Assign assign)
+	{
+		Derived& vec = self();
+		if (count == 0)
+		{
+			return iterator(vec.data() + index);
+		}
+		if (vec.size_ + count > vec.capacity())
 		{
-			return nullptr;
+			const size_t new_cap =
+				Growth::next_capacity(vec.capacity(), vec.size_ + count);
+			auto new_data = vec.allocate(new_cap);
+			T* out = new_data.get();
+			construct(out + index, 0, count);
+			try
+			{
+				transfer(vec.data(), index, out);
+				try
+				{
+					transfer(vec.data() + index, vec.size_ - index,
+							 out + index + count);
+				}
+				catch (...)
+				{
+					std::destroy_n(out, index);
+					throw;
+				}
+			}
+			catch (...)
+			{
+				std::destroy_n(out + index, count);
+				throw;
+			}
+			std::destroy_n(vec.data(), vec.size_);
+			vec.adopt(std::move(new_data), new_cap);
+			vec.size_ += count;
+			return iterator(vec.data() + index);
 		}
+		T* pos = vec.data() + index;
+		T* old_end = vec.data() + vec.size_;
+		const size_t after = vec.size_ - index;
+		if (after > count)
+		{
+			std::uninitialized_move(old_end - count, old_end, old_end);
+			vec.size_ += count;
+			std::move_backward(pos, old_end - count, old_end);
+			assign(pos, 0, count);
+		}
+		else
+		{
+			construct(old_end, after, count - after);
+			vec.size_ += count - after;
+			std::uninitialized_move(pos, old_end, pos + count);
+			vec.size_ += after;
+			assign(pos, 0, after);
+		}
+		return iterator(pos);
+	}
 
-		friend difference_type operator-(const iterator& end,
-										 const iterator& begin) noexcept
+	// Moves (or copies, when a throwing move would lose the strong
+	// guarantee) n elements into raw storage, leaving the sources alive
+	static void transfer(T* first, size_t n, T* out)
+	{
+		if constexpr (std::is_nothrow_move_constructible_v<T> ||
+					  !std::is_copy_constructible_v<T>)
+		{
+			std::uninitialized_move_n(first, n, out);
+		}
+		else
 		{
-			return 0;
+			std::uninitialized_copy_n(first, n, out);
 		}
+	}
 
-#pragma endregion
-	   private:
-		pointer ptr_ = nullptr;
-	};
+	// Transfers the elements into fresh storage and ends their old lifetimes
+	void relocate_to(T* new_data)
+	{
+		Derived& vec = self();
+		transfer(vec.data(), vec.size_, new_data);
+		std::destroy_n(vec.data(), vec.size_);
+	}
 
-	simple_vector() noexcept = default;
+   private:
+	Derived& self() noexcept { return static_cast<Derived&>(*this); }
+
+	const Derived& self() const noexcept
+	{
+		return static_cast<const Derived&>(*this);
+	}
+};
 
-	~simple_vector() = default;
+// The buffer comes from Allocator (see array_ptr), which follows the
+// elements on copy, move and swap as in a standard container. Elements are
+// constructed in place directly, not through the allocator.
+template <typename T,
+		  typename Growth = growth_x2,
+		  typename Allocator = std::allocator<T>>
+class simple_vector
+	: public vector_base<simple_vector<T, Growth, Allocator>, T, Growth>
+{
+	using alloc_traits = std::allocator_traits<Allocator>;
+	using base = vector_base<simple_vector, T, Growth>;
 
-	simple_vector(std::initializer_list<T> init) noexcept {}
+	friend base;
 
-	simple_vector(const simple_vector& other) {}
+   public:
+	using allocator_type = Allocator;
+	using iterator = vector_iterator<T>;
+	using const_iterator = vector_iterator<const T>;
 
-	simple_vector(simple_vector&& other) noexcept { swap(other); }
+	static constexpr size_t alignment = array_ptr<T, Allocator>::alignment;
 
-	simple_vector& operator=(const simple_vector& other) { return *this; }
+	simple_vector() noexcept = default;
 
-	simple_vector(size_t size, const T& value = T{}) {}
+	explicit simple_vector(const Allocator& alloc) noexcept : data_(alloc) {}
 
-	iterator begin() noexcept { return nullptr; }
+	~simple_vector() { std::destroy_n(data_.get(), size_); }
 
-	iterator end() noexcept { return nullptr; }
+	simple_vector(std::initializer_list<T> init,
+				  const Allocator& alloc = Allocator())
+		: data_(init.size(), page_mode::standard, alloc)
+	{
+		std::uninitialized_copy(init.begin(), init.end(), data_.get());
+		size_ = init.size();
+	}
 
-	using const_iterator = iterator;
+	simple_vector(const simple_vector& other)
+		: simple_vector(other,
+						alloc_traits::select_on_container_copy_construction(
+							other.get_allocator()))
+	{
+	}
 
-	const_iterator begin() const noexcept { return nullptr; }
+	simple_vector(const simple_vector& other, const Allocator& alloc)
+		: data_(other.size_, other.data_.mode(), alloc)
+	{
+		std::uninitialized_copy_n(other.data(), other.size_, data_.get());
+		size_ = other.size_;
+	}
 
-	const_iterator end() const noexcept { return nullptr; }
+	simple_vector(simple_vector&& other) noexcept
+		: data_(std::move(other.data_)), size_(std::exchange(other.size_, 0))
+	{
+	}
 
-	typename iterator::reference operator[](size_t index) noexcept
+	// Takes other's buffer if alloc equals its allocator, else moves the
+	// elements one by one
+	simple_vector(simple_vector&& other, const Allocator& alloc)
+		: data_(alloc)
 	{
-		return data_[0];
+		if (alloc == other.get_allocator())
+		{
+			data_ = std::move(other.data_);
+			size_ = std::exchange(other.size_, 0);
+		}
+		else
+		{
+			move_from(other);
+		}
 	}
 
-	typename const_iterator::reference operator[](size_t index) const noexcept
+	simple_vector& operator=(const simple_vector& other)
 	{
-		return data_[0];
+		if (this == &other)
+		{
+			return *this;
+		}
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::
+						  value)
+		{
+			if (get_allocator() != other.get_allocator())
+			{
+				// copy first: a throw leaves *this as it was
+				simple_vector copy(other, other.get_allocator());
+				this->clear();
+				data_.reset(other.get_allocator());
+				swap(copy);
+				return *this;
+			}
+		}
+		simple_vector copy(other, get_allocator());
+		swap(copy);
+		return *this;
 	}
 
-	typename iterator::reference at(size_t index) { return data_.get()[1]; }
+	simple_vector& operator=(simple_vector&& other) noexcept(
+		alloc_traits::propagate_on_container_move_assignment::value ||
+		alloc_traits::is_always_equal::value)
+	{
+		if (this == &other)
+		{
+			return *this;
+		}
+		if constexpr (!alloc_traits::propagate_on_container_move_assignment::
+						  value &&
+					  !alloc_traits::is_always_equal::value)
+		{
+			if (get_allocator() != other.get_allocator())
+			{
+				// our allocator can't free other's buffer
+				simple_vector moved(get_allocator());
+				moved.move_from(other);
+				swap(moved);
+				return *this;
+			}
+		}
+		this->clear();
+		data_ = std::move(other.data_);
+		size_ = std::exchange(other.size_, 0);
+		return *this;
+	}
 
-	typename const_iterator::reference at(size_t index) const
+	simple_vector(size_t size,
+				  const T& value = T{},
+				  const Allocator& alloc = Allocator())
+		: data_(size, page_mode::standard, alloc)
+	{
+		std::uninitialized_fill_n(data_.get(), size, value);
+		size_ = size;
+	}
+
+	Allocator get_allocator() const noexcept { return data_.get_allocator(); }
+
+	iterator begin() noexcept { return iterator(data_.get()); }
+
+	iterator end() noexcept { return iterator(data_.get() + size_); }
+
+	const_iterator begin() const noexcept
 	{
-		return data_.get()[1];
+		return const_iterator(data_.get());
 	}
 
-	size_t size() const noexcept { return 1; }
+	const_iterator end() const noexcept
+	{
+		return const_iterator(data_.get() + size_);
+	}
 
-	size_t capacity() const noexcept { return 100500; }
+	const_iterator cbegin() const noexcept { return begin(); }
 
-	void swap(simple_vector& other) noexcept {}
+	const_iterator cend() const noexcept { return end(); }
 
-	friend void swap(simple_vector& lhs, simple_vector& rhs) noexcept {}
+	T* data() noexcept { return data_.get(); }
 
-	void reserve(size_t new_cap) {}
+	const T* data() const noexcept { return data_.get(); }
 
-	void resize(size_t new_size) { return; }
+	typename iterator::reference operator[](size_t index) noexcept
+	{
+		return data_[index];
+	}
 
-	iterator insert(const_iterator where, T&& value) { return nullptr; }
+	typename const_iterator::reference operator[](size_t index) const noexcept
+	{
+		return data_[index];
+	}
 
-	iterator insert(const_iterator where, const T& value) { return nullptr; }
+	typename iterator::reference at(size_t index)
+	{
+		if (index >= size_)
+		{
+			throw std::out_of_range("Index out of range");
+		}
+		return data_[index];
+	}
+
+	typename const_iterator::reference at(size_t index) const
+	{
+		if (index >= size_)
+		{
+			throw std::out_of_range("Index out of range");
+		}
+		return data_[index];
+	}
 
-	void push_back(T&& value) {}
+	size_t size() const noexcept { return size_; }
+
+	size_t capacity() const noexcept { return data_.size(); }
+
+	void swap(simple_vector& other) noexcept
+	{
+		data_.swap(other.data_);
+		std::swap(size_, other.size_);
+	}
+
+	friend void swap(simple_vector& lhs, simple_vector& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
 
-	void clear() noexcept {}
+	void reserve(size_t new_cap)
+	{
+		if (new_cap > capacity())
+		{
+			reallocate(new_cap);
+		}
+	}
 
-	void push_back(const T& value) {}
+	// Also moves the elements to memory of the given page mode, which later
+	// reallocations and copies keep
+	void reserve(size_t new_cap, page_mode mode)
+	{
+		if (new_cap > capacity() || mode != data_.mode())
+		{
+			reallocate(std::max(new_cap, capacity()), mode);
+		}
+	}
 
-	bool empty() const noexcept { return false; }
+	// See array_ptr::huge_page_bytes
+	size_t huge_page_bytes() const noexcept { return data_.huge_page_bytes(); }
 
-	void pop_back() { return; }
+	void shrink_to_fit()
+	{
+		if (size_ < capacity())
+		{
+			reallocate(size_);
+		}
+	}
 
 	friend bool operator==(const simple_vector& lhs, const simple_vector& rhs)
 	{
-		return true;
+		return lhs.size_ == rhs.size_ &&
+			   equal_elements(lhs.data(), rhs.data(), lhs.size_);
 	}
 
 	friend bool operator!=(const simple_vector& lhs, const simple_vector& rhs)
 	{
-		return false;
+		return !(lhs == rhs);
 	}
 
-	friend auto operator<=>(const simple_vector& lhs, const simple_vector& rhs)
+	friend std::weak_ordering operator<=>(const simple_vector& lhs,
+										  const simple_vector& rhs)
 	{
-		return true;
+		return compare_elements(lhs.data(), lhs.size_, rhs.data(), rhs.size_);
 	}
 
 	friend std::ostream& operator<<(std::ostream& os, const simple_vector& vec)
 	{
-		return os;
+		os << "{";
+		for (size_t i = 0; i < vec.size_; ++i)
+		{
+			if (i > 0)
+			{
+				os << ", ";
+			}
+			os << vec.data_[i];
+		}
+		return os << "}";
 	}
-	iterator erase(iterator where) { return nullptr; }
-
    private:
-	static bool alphabet_compare(const simple_vector<T>& lhs,
-								 const simple_vector<T>& rhs)
+	array_ptr<T, Allocator> allocate(size_t capacity) const
 	{
-		return false;
+		return array_ptr<T, Allocator>(capacity, data_.mode(),
+									   data_.get_allocator());
 	}
-	array_ptr<T> data_;
+
+	void adopt(array_ptr<T, Allocator>&& new_data, size_t) noexcept
+	{
+		data_.swap(new_data);
+	}
+
+	void reallocate(size_t new_cap) { reallocate(new_cap, data_.mode()); }
+
+	void reallocate(size_t new_cap, page_mode mode)
+	{
+		array_ptr<T, Allocator> new_data(new_cap, mode, data_.get_allocator());
+		this->relocate_to(new_data.get());
+		data_.swap(new_data);
+	}
+	// Moves other's elements into a buffer from our allocator, for when it
+	// can't take over other's buffer. *this must be empty; other ends empty
+	// but keeps its buffer.
+	void move_from(simple_vector& other)
+	{
+		array_ptr<T, Allocator> new_data(other.size_, other.data_.mode(),
+										 data_.get_allocator());
+		std::uninitialized_move_n(other.data(), other.size_, new_data.get());
+		data_.swap(new_data);
+		size_ = other.size_;
+		other.clear();
+	}
+
+	array_ptr<T, Allocator> data_;
 	size_t size_ = 0;
-	size_t capacity_ = 0;
 };
+
+// data() is aligned to Align bytes, e.g. for aligned SIMD loads
+template <typename T,
+		  size_t Align = cache_line_size,
+		  typename Growth = growth_x2>
+using aligned_simple_vector =
+	simple_vector<T, Growth, aligned_allocator<T, Align>>;
+
+namespace pmr
+{
+// Takes its buffers from a std::pmr::memory_resource, e.g. an arena
+template <typename T, typename Growth = growth_x2>
+using simple_vector =
+	bmstu::simple_vector<T, Growth, std::pmr::polymorphic_allocator<T>>;
+}  // namespace pmr
+
+// Removes the matching elements in one pass, returns how many were removed
+template <typename T, typename Growth, typename Allocator, typename Predicate>
+size_t erase_if(simple_vector<T, Growth, Allocator>& vec, Predicate pred)
+{
+	auto first = std::remove_if(vec.begin(), vec.end(), pred);
+	const size_t removed = vec.end() - first;
+	vec.erase(first, vec.end());
+	return removed;
+}
 }  // namespace bmstu
@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Element comparison kernels shared by simple_vector and small_vector.
+// Integers compare equal through memcmp, and unsigned bytes are ordered by
+// it too. Other integers and float/double look for the first differing
+// element 32/16 bytes at a time (AVX/SSE2) and compare only that pair with
+// operator<, so signed, -0.0 and NaN orders are as in an element loop.
+// Any other T gets the element loop itself.
+namespace bmstu
+{
+namespace
+{
+template <typename T>
+constexpr bool bitwise_comparable_v =
+	std::is_integral_v<T> || std::is_enum_v<T>;
+
+// memcmp order matches operator< only for unsigned single bytes
+template <typename T>
+constexpr bool memcmp_ordered_v =
+	sizeof(T) == 1 && (std::is_unsigned_v<T> || std::is_same_v<T, std::byte>);
+
+template <typename T>
+constexpr bool simd_floating_v =
+	std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+// Index of the first byte where lhs and rhs differ, or size
+inline size_t find_byte_mismatch(const unsigned char* lhs,
+								 const unsigned char* rhs,
+								 size_t size)
+{
+	size_t i = 0;
+#if defined(__AVX2__)
+	for (; i + 32 <= size; i += 32)
+	{
+		const __m256i a =
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+		const __m256i b =
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+		const uint32_t mask = ~static_cast<uint32_t>(
+			_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+		if (mask != 0)
+		{
+			return i + std::countr_zero(mask);
+		}
+	}
+#endif
+#if defined(__SSE2__)
+	for (; i + 16 <= size; i += 16)
+	{
+		const __m128i a =
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+		const __m128i b =
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+		const uint32_t mask =
+			~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) &
+			0xFFFFu;
+		if (mask != 0)
+		{
+			return i + std::countr_zero(mask);
+		}
+	}
+#endif
+	for (; i + 8 <= size; i += 8)
+	{
+		uint64_t a;
+		uint64_t b;
+		std::memcpy(&a, lhs + i, sizeof(a));
+		std::memcpy(&b, rhs + i, sizeof(b));
+		if (a != b)
+		{
+			static_assert(std::endian::native == std::endian::little);
+			return i + std::countr_zero(a ^ b) / 8;
+		}
+	}
+	for (; i < size; ++i)
+	{
+		if (lhs[i] != rhs[i])
+		{
+			return i;
+		}
+	}
+	return size;
+}
+
+// Index of the first element that differs, or size. Ordered: the pair is
+// ordered and unequal, i.e. lhs < rhs or rhs < lhs. Otherwise: the pair
+// isn't ==, which includes every NaN.
+template <bool Ordered, typename T>
+size_t find_float_mismatch(const T* lhs, const T* rhs, size_t size)
+{
+	size_t i = 0;
+#if defined(__AVX__)
+	constexpr int predicate = Ordered ? _CMP_NEQ_OQ : _CMP_NEQ_UQ;
+	if constexpr (std::is_same_v<T, float>)
+	{
+		for (; i + 8 <= size; i += 8)
+		{
+			const int mask = _mm256_movemask_ps(_mm256_cmp_ps(
+				_mm256_loadu_ps(lhs + i), _mm256_loadu_ps(rhs + i), predicate));
+			if (mask != 0)
+			{
+				return i + std::countr_zero(static_cast<unsigned>(mask));
+			}
+		}
+	}
+	else
+	{
+		for (; i + 4 <= size; i += 4)
+		{
+			const int mask = _mm256_movemask_pd(_mm256_cmp_pd(
+				_mm256_loadu_pd(lhs + i), _mm256_loadu_pd(rhs + i), predicate));
+			if (mask != 0)
+			{
+				return i + std::countr_zero(static_cast<unsigned>(mask));
+			}
+		}
+	}
+#elif defined(__SSE2__)
+	if constexpr (std::is_same_v<T, float>)
+	{
+		for (; i + 4 <= size; i += 4)
+		{
+			const __m128 a = _mm_loadu_ps(lhs + i);
+			const __m128 b = _mm_loadu_ps(rhs + i);
+			const __m128 differ =
+				Ordered ? _mm_or_ps(_mm_cmplt_ps(a, b), _mm_cmpgt_ps(a, b))
+						: _mm_cmpneq_ps(a, b);
+			const int mask = _mm_movemask_ps(differ);
+			if (mask != 0)
+			{
+				return i + std::countr_zero(static_cast<unsigned>(mask));
+			}
+		}
+	}
+	else
+	{
+		for (; i + 2 <= size; i += 2)
+		{
+			const __m128d a = _mm_loadu_pd(lhs + i);
+			const __m128d b = _mm_loadu_pd(rhs + i);
+			const __m128d differ =
+				Ordered ? _mm_or_pd(_mm_cmplt_pd(a, b), _mm_cmpgt_pd(a, b))
+						: _mm_cmpneq_pd(a, b);
+			const int mask = _mm_movemask_pd(differ);
+			if (mask != 0)
+			{
+				return i + std::countr_zero(static_cast<unsigned>(mask));
+			}
+		}
+	}
+#endif
+	for (; i < size; ++i)
+	{
+		const bool differ = Ordered ? lhs[i] < rhs[i] || rhs[i] < lhs[i]
+									: !(lhs[i] == rhs[i]);
+		if (differ)
+		{
+			return i;
+		}
+	}
+	return size;
+}
+}  // namespace
+
+// Same result as std::equal(lhs, lhs + size, rhs)
+template <typename T>
+bool equal_elements(const T* lhs, const T* rhs, size_t size)
+{
+	if constexpr (bitwise_comparable_v<T>)
+	{
+		return size == 0 || std::memcmp(lhs, rhs, size * sizeof(T)) == 0;
+	}
+	else if constexpr (simd_floating_v<T>)
+	{
+		return find_float_mismatch<false>(lhs, rhs, size) == size;
+	}
+	else
+	{
+		return std::equal(lhs, lhs + size, rhs);
+	}
+}
+
+// Lexicographic order by operator<, in one pass
+template <typename T>
+std::weak_ordering compare_elements(const T* lhs,
+									size_t lhs_size,
+									const T* rhs,
+									size_t rhs_size)
+{
+	const size_t common = std::min(lhs_size, rhs_size);
+	if constexpr (memcmp_ordered_v<T>)
+	{
+		const int result = common == 0 ? 0 : std::memcmp(lhs, rhs, common);
+		if (result != 0)
+		{
+			return result < 0 ? std::weak_ordering::less
+							  : std::weak_ordering::greater;
+		}
+	}
+	else
+	{
+		size_t i = 0;
+		if constexpr (bitwise_comparable_v<T>)
+		{
+			i = find_byte_mismatch(reinterpret_cast<const unsigned char*>(lhs),
+								   reinterpret_cast<const unsigned char*>(rhs),
+								   common * sizeof(T)) /
+				sizeof(T);
+		}
+		else if constexpr (simd_floating_v<T>)
+		{
+			i = find_float_mismatch<true>(lhs, rhs, common);
+		}
+		else
+		{
+			while (i < common && !(lhs[i] < rhs[i]) && !(rhs[i] < lhs[i]))
+			{
+				++i;
+			}
+		}
+		if (i < common)
+		{
+			return lhs[i] < rhs[i] ? std::weak_ordering::less
+								   : std::weak_ordering::greater;
+		}
+	}
+	return lhs_size <=> rhs_size;
+}
+}  // namespace bmstu
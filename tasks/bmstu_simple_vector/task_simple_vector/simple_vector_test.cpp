@@ -2,8 +2,36 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <numeric>
+#include <ranges>
 #include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "bmstu_bench.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using int_vector = bmstu::simple_vector<int>;
+static_assert(std::contiguous_iterator<int_vector::iterator>);
+static_assert(std::contiguous_iterator<int_vector::const_iterator>);
+static_assert(std::ranges::contiguous_range<int_vector>);
+static_assert(std::ranges::contiguous_range<const int_vector>);
+static_assert(std::is_same_v<std::ranges::iterator_t<const int_vector>,
+							 int_vector::const_iterator>);
+static_assert(std::is_convertible_v<int_vector::iterator,
+									int_vector::const_iterator>);
+static_assert(!std::is_convertible_v<int_vector::const_iterator,
+									 int_vector::iterator>);
+static_assert(std::is_trivially_copyable_v<int_vector::iterator>);
 
 TEST(SimpleVector, DefaultConstructor)
 {
@@ -452,8 +480,9 @@ TEST(SimpleVector, PushBackCopyMove)
 
 	v.push_back(original);
 
-	ASSERT_EQ(CopyTracker::copy_count, 2);
-	ASSERT_GE(CopyTracker::move_count, 1);
+	// copied straight into raw storage, no temporary and no assignment
+	ASSERT_EQ(CopyTracker::copy_count, 1);
+	ASSERT_EQ(CopyTracker::move_count, 0);
 	ASSERT_EQ(v[0].value, 42);
 	ASSERT_EQ(original.value, 42);
 }
@@ -467,8 +496,8 @@ TEST(SimpleVector, PushBackCopyMove2)
 
 	v.push_back(std::move(original));
 
-	ASSERT_EQ(CopyTracker::copy_count, 1);
-	ASSERT_GE(CopyTracker::move_count, 1);
+	ASSERT_EQ(CopyTracker::copy_count, 0);
+	ASSERT_EQ(CopyTracker::move_count, 1);
 	ASSERT_EQ(v[0].value, 42);
 	ASSERT_EQ(original.value, 0);
 }
@@ -480,3 +509,878 @@ TEST(SimpleVector, PushBackCopyMove3)
 	auto it = v.begin();
 	it = nullptr;
 }
+
+namespace
+{
+// No default constructor, counts live objects
+struct Tracked
+{
+	Tracked(int a, std::string b) : value(a), name(std::move(b)) { ++alive; }
+
+	Tracked(const Tracked& other) : value(other.value), name(other.name)
+	{
+		++alive;
+	}
+
+	Tracked(Tracked&& other) noexcept
+		: value(other.value), name(std::move(other.name))
+	{
+		++alive;
+	}
+
+	Tracked& operator=(const Tracked& other) = default;
+
+	Tracked& operator=(Tracked&& other) noexcept = default;
+
+	~Tracked() { --alive; }
+
+	int value;
+	std::string name;
+	inline static int alive = 0;
+};
+}  // namespace
+
+TEST(SimpleVector, EmplaceBack)
+{
+	{
+		bmstu::simple_vector<Tracked> v;
+		Tracked& first = v.emplace_back(1, "one");
+		ASSERT_EQ(first.name, "one");
+		v.emplace_back(2, "two");
+		ASSERT_EQ(v.capacity(), 2u);
+		// the argument lives in the buffer that is about to be replaced
+		v.emplace_back(v[0]);
+		ASSERT_EQ(v.size(), 3u);
+		ASSERT_EQ(v[2].name, "one");
+		ASSERT_EQ(Tracked::alive, 3);
+		v.pop_back();
+		ASSERT_EQ(Tracked::alive, 2);
+	}
+	ASSERT_EQ(Tracked::alive, 0);
+}
+
+TEST(SimpleVector, Emplace)
+{
+	{
+		bmstu::simple_vector<Tracked> v;
+		v.emplace_back(1, "a");
+		v.emplace_back(3, "c");
+		auto it = v.emplace(v.begin() + 1, 2, "b");
+		ASSERT_EQ(it->value, 2);
+		v.emplace(v.begin(), 0, "z");
+		v.emplace(v.end(), 4, "d");
+		ASSERT_EQ(v.size(), 5u);
+		for (int i = 0; i < 5; ++i)
+		{
+			ASSERT_EQ(v[i].value, i);
+		}
+		ASSERT_EQ(v[0].name, "z");
+		v.erase(v.begin());
+		ASSERT_EQ(Tracked::alive, 4);
+		v.clear();
+		ASSERT_EQ(Tracked::alive, 0);
+		v.emplace_back(5, "e");
+		ASSERT_EQ(v[0].name, "e");
+	}
+	ASSERT_EQ(Tracked::alive, 0);
+}
+
+TEST(SimpleVector, ResizeForOverwrite)
+{
+	bmstu::simple_vector<char> v;
+	v.resize_for_overwrite(100);
+	ASSERT_EQ(v.size(), 100u);
+	std::fill(v.begin(), v.end(), 'x');
+	v.resize(200);
+	ASSERT_EQ(v[99], 'x');
+	ASSERT_EQ(v[199], '\0');
+	v.resize_for_overwrite(10);
+	ASSERT_EQ(v.size(), 10u);
+
+	bmstu::simple_vector<std::string> strings;
+	strings.resize_for_overwrite(3);
+	ASSERT_TRUE(strings[2].empty());
+}
+
+TEST(SimpleVector, GrowthPolicy)
+{
+	bmstu::simple_vector<int, bmstu::growth_x1_5> v;
+	std::vector<size_t> capacities;
+	for (int i = 0; i < 20; ++i)
+	{
+		v.push_back(i);
+		if (capacities.empty() || capacities.back() != v.capacity())
+		{
+			capacities.push_back(v.capacity());
+		}
+	}
+	ASSERT_EQ(capacities,
+			  (std::vector<size_t>{1, 2, 3, 4, 6, 9, 13, 19, 28}));
+	v.resize(100);
+	ASSERT_EQ(v.capacity(), 100u);
+	ASSERT_EQ(v[19], 19);
+}
+
+TEST(SimpleVector, ShrinkToFit)
+{
+	bmstu::simple_vector<std::string> v;
+	for (int i = 0; i < 10; ++i)
+	{
+		v.push_back(std::to_string(i));
+	}
+	ASSERT_EQ(v.capacity(), 16u);
+	v.shrink_to_fit();
+	ASSERT_EQ(v.capacity(), 10u);
+	ASSERT_EQ(v[9], "9");
+	v.clear();
+	v.shrink_to_fit();
+	ASSERT_EQ(v.capacity(), 0u);
+	ASSERT_EQ(v.begin(), nullptr);
+}
+
+TEST(SimpleVector, Hysteresis)
+{
+	bmstu::simple_vector<int, bmstu::hysteresis<bmstu::growth_x2>> v;
+	for (int i = 0; i < 1024; ++i)
+	{
+		v.push_back(i);
+	}
+	ASSERT_EQ(v.capacity(), 1024u);
+	while (v.size() > 256)
+	{
+		v.pop_back();
+		ASSERT_EQ(v.capacity(), 1024u);
+	}
+	v.pop_back();
+	ASSERT_EQ(v.capacity(), 512u);
+	ASSERT_EQ(v[254], 254);
+	// oscillating around the threshold doesn't reallocate
+	v.push_back(-1);
+	v.pop_back();
+	ASSERT_EQ(v.capacity(), 512u);
+	while (v.size() > 10)
+	{
+		v.erase(v.begin());
+	}
+	ASSERT_LT(v.capacity(), 4 * 10u);
+	ASSERT_EQ(v[0], 245);
+	ASSERT_EQ(v[9], 254);
+}
+
+TEST(SimpleVector, InsertRange)
+{
+	bmstu::simple_vector<std::string> v{"a", "b", "c", "d"};
+	v.reserve(16);
+	const std::vector<std::string> two{"x", "y"};
+	// fewer inserted than after the gap
+	auto it = v.insert(v.begin() + 1, two.begin(), two.end());
+	ASSERT_EQ(*it, "x");
+	ASSERT_EQ(v, (bmstu::simple_vector<std::string>{"a", "x", "y", "b", "c",
+													"d"}));
+	// more inserted than after the gap
+	const std::vector<std::string> four{"1", "2", "3", "4"};
+	v.insert(v.end() - 1, four.begin(), four.end());
+	ASSERT_EQ(v, (bmstu::simple_vector<std::string>{"a", "x", "y", "b", "c",
+													"1", "2", "3", "4", "d"}));
+	ASSERT_EQ(v.capacity(), 16u);
+	// reallocates once
+	v.insert(v.begin(), four.begin(), four.end());
+	v.insert(v.begin() + 2, four.begin(), four.end());
+	ASSERT_EQ(v.size(), 18u);
+	ASSERT_EQ(v.capacity(), 32u);
+	ASSERT_EQ(v[0], "1");
+	ASSERT_EQ(v[2], "1");
+	ASSERT_EQ(v[6], "3");
+	ASSERT_EQ(v[17], "d");
+
+	std::istringstream input("7 8 9");
+	bmstu::simple_vector<int> ints{1, 2};
+	ints.insert(ints.begin() + 1, std::istream_iterator<int>(input),
+				std::istream_iterator<int>());
+	ASSERT_EQ(ints, (bmstu::simple_vector<int>{1, 7, 8, 9, 2}));
+	ints.insert(ints.begin(), {5, 6});
+	ASSERT_EQ(ints[1], 6);
+}
+
+TEST(SimpleVector, InsertCount)
+{
+	bmstu::simple_vector<std::string> v{"a", "b", "c"};
+	v.insert(v.begin(), 2, v[2]);
+	ASSERT_EQ(v, (bmstu::simple_vector<std::string>{"c", "c", "a", "b", "c"}));
+	v.insert(v.begin() + 4, 0, "z");
+	ASSERT_EQ(v.size(), 5u);
+	bmstu::simple_vector<int> ints;
+	ints.insert(ints.end(), 3, 7);
+	ASSERT_EQ(ints, (bmstu::simple_vector<int>{7, 7, 7}));
+}
+
+TEST(SimpleVector, AppendRange)
+{
+	{
+		bmstu::simple_vector<Tracked> v;
+		std::vector<Tracked> source;
+		for (int i = 0; i < 5; ++i)
+		{
+			source.emplace_back(i, std::to_string(i));
+		}
+		v.append_range(source);
+		ASSERT_EQ(v.capacity(), 5u);
+		v.append_range(source);
+		ASSERT_EQ(v.size(), 10u);
+		ASSERT_EQ(v.capacity(), 10u);
+		ASSERT_EQ(v[9].name, "4");
+		ASSERT_EQ(Tracked::alive, 15);
+	}
+	ASSERT_EQ(Tracked::alive, 0);
+	bmstu::simple_vector<int> squares;
+	squares.append_range(std::views::iota(0, 5) |
+						 std::views::transform([](int i) { return i * i; }));
+	ASSERT_EQ(squares, (bmstu::simple_vector<int>{0, 1, 4, 9, 16}));
+}
+
+TEST(SimpleVector, EraseRangeAndIf)
+{
+	{
+		bmstu::simple_vector<Tracked> v;
+		for (int i = 0; i < 10; ++i)
+		{
+			v.emplace_back(i, std::to_string(i));
+		}
+		auto it = v.erase(v.begin() + 2, v.begin() + 5);
+		ASSERT_EQ(it->value, 5);
+		ASSERT_EQ(v.size(), 7u);
+		ASSERT_EQ(Tracked::alive, 7);
+		ASSERT_EQ(v.erase(v.begin(), v.begin()), v.begin());
+		const size_t removed = bmstu::erase_if(
+			v, [](const Tracked& t) { return t.value % 2 == 1; });
+		ASSERT_EQ(removed, 4u);
+		ASSERT_EQ(v.size(), 3u);
+		ASSERT_EQ(v[0].name, "0");
+		ASSERT_EQ(v[2].name, "8");
+		ASSERT_EQ(Tracked::alive, 3);
+	}
+	ASSERT_EQ(Tracked::alive, 0);
+
+	bmstu::simple_vector<int, bmstu::hysteresis<bmstu::growth_x2>> sparse(1024);
+	sparse.erase(sparse.begin() + 10, sparse.end());
+	ASSERT_EQ(sparse.size(), 10u);
+	ASSERT_EQ(sparse.capacity(), 32u);
+}
+
+namespace
+{
+template <typename T>
+std::weak_ordering reference_order(const bmstu::simple_vector<T>& lhs,
+								   const bmstu::simple_vector<T>& rhs)
+{
+	if (std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+									 rhs.end()))
+	{
+		return std::weak_ordering::less;
+	}
+	if (std::lexicographical_compare(rhs.begin(), rhs.end(), lhs.begin(),
+									 lhs.end()))
+	{
+		return std::weak_ordering::greater;
+	}
+	return std::weak_ordering::equivalent;
+}
+
+// Every length up to a few SIMD blocks, every mismatch position, both signs
+template <typename T>
+void check_against_loop(T low, T high)
+{
+	for (size_t size = 0; size < 70; ++size)
+	{
+		bmstu::simple_vector<T> base(size, T(1));
+		for (size_t pos = 0; pos < size; ++pos)
+		{
+			for (T value : {low, high})
+			{
+				bmstu::simple_vector<T> other(base);
+				other[pos] = value;
+				ASSERT_EQ(base == other, std::equal(base.begin(), base.end(),
+													other.begin()));
+				ASSERT_EQ(base <=> other, reference_order(base, other));
+				ASSERT_EQ(other <=> base, reference_order(other, base));
+			}
+		}
+		bmstu::simple_vector<T> longer(base);
+		longer.push_back(low);
+		ASSERT_EQ(base <=> longer, std::weak_ordering::less);
+		ASSERT_EQ(base <=> base, std::weak_ordering::equivalent);
+	}
+}
+}  // namespace
+
+TEST(SimpleVector, VectorizedCompare)
+{
+	check_against_loop<char>(-100, 100);
+	check_against_loop<signed char>(-100, 100);
+	check_against_loop<unsigned char>(0, 200);
+	check_against_loop<short>(-300, 300);
+	check_against_loop<int>(-5, 1 << 20);
+	check_against_loop<long long>(-1, 1ll << 40);
+	check_against_loop<float>(-0.5f, 2.5f);
+	check_against_loop<double>(-1e300, 1e300);
+
+	// NaN is unordered against everything, -0.0 equals 0.0
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	bmstu::simple_vector<double> a(40, 0.0);
+	bmstu::simple_vector<double> b(40, -0.0);
+	ASSERT_TRUE(a == b);
+	a[20] = nan;
+	ASSERT_FALSE(a == b);
+	ASSERT_EQ(a <=> b, std::weak_ordering::equivalent);
+	b[30] = -1.0;
+	ASSERT_EQ(a <=> b, std::weak_ordering::greater);
+	bmstu::simple_vector<std::string> words{"b", "a"};
+	ASSERT_EQ(words <=> (bmstu::simple_vector<std::string>{"b", "b"}),
+			  std::weak_ordering::less);
+}
+
+TEST(SimpleVector, RandomAccessIterator)
+{
+	bmstu::simple_vector<int> v{10, 20, 30, 40};
+	auto it = v.begin();
+	ASSERT_EQ(it[2], 30);
+	ASSERT_EQ(*(2 + it), 30);
+	ASSERT_EQ(&(it += 3), &it);
+	ASSERT_EQ(*it, 40);
+	ASSERT_TRUE(v.begin() < it);
+	ASSERT_TRUE(it >= v.begin() + 3);
+	ASSERT_EQ(std::to_address(v.begin()), v.data());
+	ASSERT_EQ(std::to_address(v.end()), v.data() + v.size());
+
+	bmstu::simple_vector<int>::const_iterator cit = v.begin();
+	ASSERT_TRUE(cit == v.begin());
+	ASSERT_EQ(v.cend() - v.begin(), 4);
+	ASSERT_EQ(std::ranges::find(std::as_const(v), 30) - v.cbegin(), 2);
+	std::ranges::sort(v, std::greater<>());
+	ASSERT_EQ(v, (bmstu::simple_vector<int>{40, 30, 20, 10}));
+}
+
+namespace
+{
+template <size_t Align, typename T>
+bool aligned_to(const T* ptr)
+{
+	return reinterpret_cast<uintptr_t>(ptr) % Align == 0;
+}
+}  // namespace
+
+TEST(SimpleVector, AlignedStorage)
+{
+	bmstu::aligned_simple_vector<float> floats;
+	static_assert(decltype(floats)::alignment == bmstu::cache_line_size);
+	for (int i = 0; i < 1000; ++i)
+	{
+		floats.push_back(static_cast<float>(i));
+		ASSERT_TRUE(aligned_to<64>(floats.data()));
+	}
+	floats.insert(floats.begin(), floats.capacity(), 0.5f);
+	ASSERT_TRUE(aligned_to<64>(floats.data()));
+	ASSERT_EQ(bmstu::erase_if(floats, [](float f) { return f == 0.5f; }),
+			  1024u);
+	floats.shrink_to_fit();
+	ASSERT_TRUE(aligned_to<64>(floats.data()));
+	const bmstu::aligned_simple_vector<float> copy(floats);
+	ASSERT_TRUE(aligned_to<64>(copy.data()));
+	ASSERT_EQ(copy[999], 999.0f);
+
+	bmstu::aligned_simple_vector<char, 32, bmstu::growth_x1_5> bytes(5, 'a');
+	bytes.reserve(1000);
+	ASSERT_TRUE(aligned_to<32>(bytes.data()));
+	using byte_vector =
+		bmstu::aligned_simple_vector<char, 32, bmstu::growth_x1_5>;
+	ASSERT_EQ(bytes, byte_vector(5, 'a'));
+
+	const bmstu::aligned_array_ptr<double, 4096> page(3);
+	ASSERT_TRUE(aligned_to<4096>(page.get()));
+	static_assert(bmstu::array_ptr<double>::alignment == alignof(double));
+}
+
+namespace
+{
+// Stateful allocator that moves with the elements on copy, move and swap
+template <typename T>
+struct tagged_allocator
+{
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	explicit tagged_allocator(int tag) noexcept : tag(tag) {}
+
+	template <typename U>
+	tagged_allocator(const tagged_allocator<U>& other) noexcept
+		: tag(other.tag)
+	{
+	}
+
+	T* allocate(size_t size) { return std::allocator<T>().allocate(size); }
+
+	void deallocate(T* ptr, size_t size) noexcept
+	{
+		std::allocator<T>().deallocate(ptr, size);
+	}
+
+	friend bool operator==(const tagged_allocator& lhs,
+						   const tagged_allocator& rhs) noexcept
+	{
+		return lhs.tag == rhs.tag;
+	}
+
+	int tag;
+};
+}  // namespace
+
+TEST(SimpleVector, PropagatingAllocator)
+{
+	using tagged_vector =
+		bmstu::simple_vector<int, bmstu::growth_x2, tagged_allocator<int>>;
+	tagged_vector a({1, 2, 3}, tagged_allocator<int>(1));
+	tagged_vector b(tagged_allocator<int>(2));
+	b = a;
+	ASSERT_EQ(b.get_allocator().tag, 1);
+	ASSERT_EQ(b, a);
+
+	tagged_vector c(5, 7, tagged_allocator<int>(3));
+	c.swap(a);
+	ASSERT_EQ(c.get_allocator().tag, 1);
+	ASSERT_EQ(a.get_allocator().tag, 3);
+	ASSERT_EQ(a, tagged_vector(5, 7, tagged_allocator<int>(0)));
+
+	const int* buffer = c.data();
+	a = std::move(c);
+	ASSERT_EQ(a.get_allocator().tag, 1);
+	ASSERT_EQ(a.data(), buffer);
+	ASSERT_TRUE(c.empty());
+
+	const tagged_vector d(a);
+	ASSERT_EQ(d.get_allocator().tag, 1);
+}
+
+TEST(SimpleVector, PmrAllocator)
+{
+	std::byte buffer[4096];
+	std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+	bmstu::pmr::simple_vector<int> a(&arena);
+	for (int i = 0; i < 100; ++i)
+	{
+		a.push_back(i);
+	}
+	ASSERT_EQ(a.get_allocator().resource(), &arena);
+	ASSERT_GE(static_cast<void*>(a.data()), static_cast<void*>(buffer));
+	ASSERT_LT(static_cast<void*>(a.data()),
+			  static_cast<void*>(buffer + sizeof(buffer)));
+
+	// copies get the default resource, assignment keeps the target's
+	const bmstu::pmr::simple_vector<int> copy(a);
+	ASSERT_EQ(copy.get_allocator().resource(),
+			  std::pmr::get_default_resource());
+	bmstu::pmr::simple_vector<int> b(&arena);
+	b = copy;
+	ASSERT_EQ(b.get_allocator().resource(), &arena);
+	ASSERT_EQ(b, copy);
+
+	// moving between resources moves the elements, not the buffer
+	bmstu::pmr::simple_vector<int> c;
+	c = std::move(b);
+	ASSERT_EQ(c.get_allocator().resource(), std::pmr::get_default_resource());
+	ASSERT_EQ(c, copy);
+	ASSERT_TRUE(b.empty());
+	bmstu::pmr::simple_vector<int> d(std::move(a), &arena);
+	ASSERT_EQ(d.get_allocator().resource(), &arena);
+	ASSERT_EQ(d, copy);
+	bmstu::pmr::simple_vector<int> e(std::move(d));
+	ASSERT_EQ(e.get_allocator().resource(), &arena);
+	bmstu::pmr::simple_vector<int> f(std::move(e),
+									 std::pmr::new_delete_resource());
+	ASSERT_EQ(f, copy);
+	ASSERT_TRUE(e.empty());
+	f.shrink_to_fit();
+	ASSERT_EQ(f.get_allocator().resource(), std::pmr::new_delete_resource());
+}
+
+namespace
+{
+[[gnu::noipa]] void copy_by_iterator(const bmstu::simple_vector<int>& from,
+									 bmstu::simple_vector<int>& to)
+{
+	std::copy(from.begin(), from.end(), to.begin());
+}
+
+[[gnu::noipa]] void copy_by_address(const bmstu::simple_vector<int>& from,
+									bmstu::simple_vector<int>& to)
+{
+	std::copy(std::to_address(from.begin()), std::to_address(from.end()),
+			  std::to_address(to.begin()));
+}
+
+[[gnu::noipa]] bool equal_by_iterator(const bmstu::simple_vector<int>& lhs,
+									  const bmstu::simple_vector<int>& rhs)
+{
+	return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+[[gnu::noipa]] bool equal_by_address(const bmstu::simple_vector<int>& lhs,
+									 const bmstu::simple_vector<int>& rhs)
+{
+	return std::equal(std::to_address(lhs.begin()),
+					  std::to_address(lhs.end()),
+					  std::to_address(rhs.begin()));
+}
+
+using bmstu::bench::time_it;
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SimpleVectorBench, DISABLED_StringGrowth)
+{
+	time_it("push_back 1M strings",
+			[]
+			{
+				bmstu::simple_vector<std::string> v;
+				for (int i = 0; i < 1'000'000; ++i)
+				{
+					v.push_back(std::string(40, 'a' + i % 26));
+				}
+				return static_cast<long long>(v.size());
+			});
+	time_it("emplace_back 1M strings",
+			[]
+			{
+				bmstu::simple_vector<std::string> v;
+				for (int i = 0; i < 1'000'000; ++i)
+				{
+					v.emplace_back(40, 'a' + i % 26);
+				}
+				return static_cast<long long>(v.size());
+			});
+}
+
+TEST(SimpleVectorBench, DISABLED_CharBulkFill)
+{
+	constexpr size_t size = 256u << 20;
+	time_it("resize + fill 256 MB",
+			[]
+			{
+				bmstu::simple_vector<char> v;
+				v.resize(size);
+				std::fill(v.begin(), v.end(), 'x');
+				return static_cast<long long>(v[size - 1]);
+			});
+	time_it("resize_for_overwrite + fill 256 MB",
+			[]
+			{
+				bmstu::simple_vector<char> v;
+				v.resize_for_overwrite(size);
+				std::fill(v.begin(), v.end(), 'x');
+				return static_cast<long long>(v[size - 1]);
+			});
+}
+
+namespace
+{
+// Grows to a peak and falls back to a trough, reports the trough capacity
+template <typename Growth>
+long long sawtooth()
+{
+	bmstu::simple_vector<int, Growth> v;
+	for (int cycle = 0; cycle < 20; ++cycle)
+	{
+		for (int i = 0; i < 1'000'000; ++i)
+		{
+			v.push_back(i);
+		}
+		while (v.size() > 1000)
+		{
+			v.pop_back();
+		}
+	}
+	return static_cast<long long>(v.capacity());
+}
+}  // namespace
+
+TEST(SimpleVectorBench, DISABLED_Sawtooth)
+{
+	time_it("2x", sawtooth<bmstu::growth_x2>);
+	time_it("1.5x", sawtooth<bmstu::growth_x1_5>);
+	time_it("2x + hysteresis", sawtooth<bmstu::hysteresis<bmstu::growth_x2>>);
+	time_it("1.5x + hysteresis",
+			sawtooth<bmstu::hysteresis<bmstu::growth_x1_5>>);
+}
+
+TEST(SimpleVectorBench, DISABLED_InsertMiddle)
+{
+	const std::vector<int> chunk(1000, 1);
+	time_it("insert 1000 single elements, 50 times",
+			[&]
+			{
+				bmstu::simple_vector<int> v(10'000);
+				for (int round = 0; round < 50; ++round)
+				{
+					auto where = v.begin() + v.size() / 2;
+					for (int value : chunk)
+					{
+						where = v.insert(where, value) + 1;
+					}
+				}
+				return static_cast<long long>(v.size());
+			});
+	time_it("insert range of 1000, 50 times",
+			[&]
+			{
+				bmstu::simple_vector<int> v(10'000);
+				for (int round = 0; round < 50; ++round)
+				{
+					v.insert(v.begin() + v.size() / 2, chunk.begin(),
+							 chunk.end());
+				}
+				return static_cast<long long>(v.size());
+			});
+}
+
+TEST(SimpleVectorBench, DISABLED_Filter)
+{
+	bmstu::simple_vector<int> source;
+	for (int i = 0; i < 100'000; ++i)
+	{
+		source.push_back(i);
+	}
+	auto odd = [](int value) { return value % 2 == 1; };
+	time_it("erase one by one, 100k ints, 50% removed",
+			[&]
+			{
+				bmstu::simple_vector<int> v(source);
+				for (auto it = v.begin(); it != v.end();)
+				{
+					it = odd(*it) ? v.erase(it) : it + 1;
+				}
+				return static_cast<long long>(v.size());
+			});
+	time_it("erase_if, 100k ints, 50% removed",
+			[&]
+			{
+				bmstu::simple_vector<int> v(source);
+				bmstu::erase_if(v, odd);
+				return static_cast<long long>(v.size());
+			});
+}
+
+namespace
+{
+template <typename T>
+[[gnu::noipa]] bool loop_equal(const bmstu::simple_vector<T>& lhs,
+							   const bmstu::simple_vector<T>& rhs)
+{
+	return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T>
+[[gnu::noipa]] bool loop_less(const bmstu::simple_vector<T>& lhs,
+							  const bmstu::simple_vector<T>& rhs)
+{
+	return reference_order(lhs, rhs) < 0;
+}
+
+template <typename T>
+[[gnu::noipa]] bool vector_equal(const bmstu::simple_vector<T>& lhs,
+								 const bmstu::simple_vector<T>& rhs)
+{
+	return lhs == rhs;
+}
+
+template <typename T>
+[[gnu::noipa]] bool vector_less(const bmstu::simple_vector<T>& lhs,
+								const bmstu::simple_vector<T>& rhs)
+{
+	return lhs < rhs;
+}
+
+// Equal vectors, so every call scans the whole range; 256 MB per line
+template <typename T>
+void time_compare(const char* type)
+{
+	for (size_t bytes : {size_t(1) << 10, size_t(1) << 16, size_t(1) << 20,
+						 size_t(1) << 26})
+	{
+		const size_t size = bytes / sizeof(T);
+		bmstu::simple_vector<T> lhs(size);
+		for (size_t i = 0; i < size; ++i)
+		{
+			lhs[i] = static_cast<T>(i % 100);
+		}
+		const bmstu::simple_vector<T> rhs(lhs);
+		const int rounds = static_cast<int>((size_t(1) << 28) / bytes);
+		std::cout << type << ", " << (bytes >> 10) << " KB" << std::endl;
+		time_it("  std::equal", [&] { return loop_equal(lhs, rhs); }, rounds);
+		time_it("  ==", [&] { return vector_equal(lhs, rhs); }, rounds);
+		time_it("  lexicographical_compare x2",
+				[&] { return loop_less(lhs, rhs); }, rounds);
+		time_it("  <", [&] { return vector_less(lhs, rhs); }, rounds);
+	}
+}
+}  // namespace
+
+TEST(SimpleVectorBench, DISABLED_Compare)
+{
+	time_compare<char>("char");
+	time_compare<int>("int");
+	time_compare<double>("double");
+}
+
+TEST(SimpleVectorBench, DISABLED_CopyEqual)
+{
+	bmstu::simple_vector<int> from(4'000'000);
+	std::iota(from.begin(), from.end(), 0);
+	bmstu::simple_vector<int> to(from.size());
+	time_it("std::copy, iterators",
+			[&]
+			{
+				copy_by_iterator(from, to);
+				return to[to.size() - 1];
+			},
+			50);
+	time_it("std::copy, to_address (memmove)",
+			[&]
+			{
+				copy_by_address(from, to);
+				return to[to.size() - 1];
+			},
+			50);
+	time_it("std::equal, iterators",
+			[&] { return equal_by_iterator(from, to); }, 50);
+	time_it("std::equal, to_address (memcmp)",
+			[&] { return equal_by_address(from, to); }, 50);
+}
+
+#if defined(__AVX2__)
+namespace
+{
+// Four accumulators, so the loads and not the add latency set the pace
+template <bool Aligned>
+[[gnu::noipa]] long long sum_floats(const float* data, size_t size)
+{
+	__m256 acc[4] = {_mm256_setzero_ps(), _mm256_setzero_ps(),
+					 _mm256_setzero_ps(), _mm256_setzero_ps()};
+	for (size_t i = 0; i + 32 <= size; i += 32)
+	{
+		for (size_t k = 0; k < 4; ++k)
+		{
+			const float* at = data + i + 8 * k;
+			acc[k] = _mm256_add_ps(
+				acc[k], Aligned ? _mm256_load_ps(at) : _mm256_loadu_ps(at));
+		}
+	}
+	alignas(32) float lanes[8];
+	_mm256_store_ps(lanes, _mm256_add_ps(_mm256_add_ps(acc[0], acc[1]),
+										 _mm256_add_ps(acc[2], acc[3])));
+	float sum = 0;
+	for (float lane : lanes)
+	{
+		sum += lane;
+	}
+	return static_cast<long long>(sum);
+}
+}  // namespace
+#endif
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SimpleVectorBench, DISABLED_AlignedLoads)
+{
+#if defined(__AVX2__)
+	// 256 MB read per line
+	for (size_t bytes : {size_t(1) << 14, size_t(1) << 20, size_t(1) << 28})
+	{
+		const size_t size = bytes / sizeof(float);
+		bmstu::aligned_simple_vector<float, 32> vec(size + 1, 1.0f);
+		const int rounds = static_cast<int>((size_t(1) << 28) / bytes);
+		std::cout << (bytes >> 10) << " KB" << std::endl;
+		time_it("  aligned data, vmovaps",
+				[&] { return sum_floats<true>(vec.data(), size); }, rounds);
+		time_it("  aligned data, vmovups",
+				[&] { return sum_floats<false>(vec.data(), size); }, rounds);
+		// every other 32-byte load splits a cache line
+		time_it("  data + 4 bytes, vmovups",
+				[&] { return sum_floats<false>(vec.data() + 1, size); },
+				rounds);
+	}
+#else
+	GTEST_SKIP() << "built without AVX2";
+#endif
+}
+
+namespace
+{
+// One request: a few short-lived vectors of different sizes
+template <typename Vector, typename... Alloc>
+[[gnu::noipa]] long long handle_request(int request, const Alloc&... alloc)
+{
+	long long sum = 0;
+	for (int list = 0; list < 8; ++list)
+	{
+		Vector values(alloc...);
+		const int count = 8 + (request * 7 + list * 13) % 56;
+		for (int i = 0; i < count; ++i)
+		{
+			values.push_back(i ^ request);
+		}
+		Vector filtered(alloc...);
+		for (int value : values)
+		{
+			if (value % 3 != 0)
+			{
+				filtered.push_back(value);
+			}
+		}
+		sum += static_cast<long long>(filtered.size());
+	}
+	return sum;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SimpleVectorBench, DISABLED_ShortLivedVectors)
+{
+	constexpr int requests = 1'000'000;
+	time_it("1M requests, std::allocator",
+			[]
+			{
+				long long sum = 0;
+				for (int r = 0; r < requests; ++r)
+				{
+					sum += handle_request<bmstu::simple_vector<int>>(r);
+				}
+				return sum;
+			});
+	time_it("1M requests, monotonic arena released per request",
+			[]
+			{
+				std::byte buffer[16 << 10];
+				std::pmr::monotonic_buffer_resource arena(buffer,
+														  sizeof(buffer));
+				long long sum = 0;
+				for (int r = 0; r < requests; ++r)
+				{
+					sum += handle_request<bmstu::pmr::simple_vector<int>>(
+						r, &arena);
+					arena.release();
+				}
+				return sum;
+			});
+	time_it("1M requests, unsynchronized pool",
+			[]
+			{
+				std::pmr::unsynchronized_pool_resource pool;
+				long long sum = 0;
+				for (int r = 0; r < requests; ++r)
+				{
+					sum += handle_request<bmstu::pmr::simple_vector<int>>(
+						r, &pool);
+				}
+				return sum;
+			});
+}
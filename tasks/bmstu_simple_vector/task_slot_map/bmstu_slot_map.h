@@ -0,0 +1,203 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "bmstu_simple_vector.h"
+
+namespace bmstu
+{
+// Handle to a slot_map element: the slot it was given plus the slot's
+// generation at that time. Erasing bumps the generation, so a key to an
+// erased element never finds the element that reuses the slot.
+struct slot_key
+{
+	uint32_t index = std::numeric_limits<uint32_t>::max();
+	uint32_t generation = 0;
+
+	friend bool operator==(const slot_key& lhs, const slot_key& rhs) = default;
+};
+
+// Unordered container with O(1) insert, erase and lookup by slot_key, and
+// values kept packed in one simple_vector for iteration.
+//
+// slots_ is the sparse side: slot i holds the position of its value in
+// values_, or the next free slot while it is unused. values_ and owners_
+// are the dense side: owners_[d] is the slot of values_[d]. Erase moves the
+// last value into the hole, so iteration order changes and iterators and
+// pointers to the last element are invalidated; keys stay valid.
+template <typename T>
+class slot_map
+{
+	struct slot
+	{
+		// position in values_ when occupied, next free slot when not
+		uint32_t target;
+		// odd while occupied
+		uint32_t generation;
+	};
+
+	static constexpr uint32_t no_slot = std::numeric_limits<uint32_t>::max();
+
+   public:
+	using key_type = slot_key;
+	using iterator = typename simple_vector<T>::iterator;
+	using const_iterator = typename simple_vector<T>::const_iterator;
+
+	slot_map() noexcept = default;
+
+	iterator begin() noexcept { return values_.begin(); }
+
+	iterator end() noexcept { return values_.end(); }
+
+	const_iterator begin() const noexcept { return values_.begin(); }
+
+	const_iterator end() const noexcept { return values_.end(); }
+
+	T* data() noexcept { return values_.data(); }
+
+	const T* data() const noexcept { return values_.data(); }
+
+	size_t size() const noexcept { return values_.size(); }
+
+	bool empty() const noexcept { return values_.empty(); }
+
+	// Slots ever created: live elements plus free slots
+	size_t slot_count() const noexcept { return slots_.size(); }
+
+	void reserve(size_t new_cap)
+	{
+		values_.reserve(new_cap);
+		owners_.reserve(new_cap);
+		slots_.reserve(new_cap);
+	}
+
+	template <typename... Args>
+	slot_key emplace(Args&&... args)
+	{
+		if (free_head_ == no_slot)
+		{
+			if (slots_.size() == no_slot)
+			{
+				throw std::length_error("slot_map is full");
+			}
+			// a new slot joins the free list, so a throw below leaves it free
+			slots_.push_back(slot{no_slot, 0});
+			free_head_ = static_cast<uint32_t>(slots_.size() - 1);
+		}
+		const uint32_t index = free_head_;
+		const uint32_t dense = static_cast<uint32_t>(values_.size());
+		values_.emplace_back(std::forward<Args>(args)...);
+		try
+		{
+			owners_.push_back(index);
+		}
+		catch (...)
+		{
+			values_.pop_back();
+			throw;
+		}
+		slot& taken = slots_[index];
+		free_head_ = taken.target;
+		taken.target = dense;
+		++taken.generation;
+		return slot_key{index, taken.generation};
+	}
+
+	slot_key insert(const T& value) { return emplace(value); }
+
+	slot_key insert(T&& value) { return emplace(std::move(value)); }
+
+	bool contains(slot_key key) const noexcept
+	{
+		return key.index < slots_.size() &&
+			   slots_[key.index].generation == key.generation &&
+			   key.generation % 2 == 1;
+	}
+
+	// nullptr for a stale or foreign key
+	T* find(slot_key key) noexcept
+	{
+		return contains(key) ? &values_[slots_[key.index].target] : nullptr;
+	}
+
+	const T* find(slot_key key) const noexcept
+	{
+		return contains(key) ? &values_[slots_[key.index].target] : nullptr;
+	}
+
+	T& at(slot_key key)
+	{
+		if (!contains(key))
+		{
+			throw std::out_of_range("Stale slot_map key");
+		}
+		return values_[slots_[key.index].target];
+	}
+
+	const T& at(slot_key key) const
+	{
+		if (!contains(key))
+		{
+			throw std::out_of_range("Stale slot_map key");
+		}
+		return values_[slots_[key.index].target];
+	}
+
+	// The key must be valid
+	T& operator[](slot_key key) noexcept
+	{
+		return values_[slots_[key.index].target];
+	}
+
+	const T& operator[](slot_key key) const noexcept
+	{
+		return values_[slots_[key.index].target];
+	}
+
+	// Swap-and-pop: the last value moves into the hole. Returns false for a
+	// stale key.
+	bool erase(slot_key key)
+	{
+		if (!contains(key))
+		{
+			return false;
+		}
+		slot& erased = slots_[key.index];
+		const uint32_t hole = erased.target;
+		const uint32_t last = static_cast<uint32_t>(values_.size() - 1);
+		if (hole != last)
+		{
+			values_[hole] = std::move(values_[last]);
+			owners_[hole] = owners_[last];
+			slots_[owners_[hole]].target = hole;
+		}
+		values_.pop_back();
+		owners_.pop_back();
+		++erased.generation;
+		erased.target = free_head_;
+		free_head_ = key.index;
+		return true;
+	}
+
+	// Invalidates every key; slots are kept and their generations move on
+	void clear() noexcept
+	{
+		for (uint32_t index : owners_)
+		{
+			++slots_[index].generation;
+			slots_[index].target = free_head_;
+			free_head_ = index;
+		}
+		values_.clear();
+		owners_.clear();
+	}
+
+   private:
+	simple_vector<T> values_;
+	simple_vector<uint32_t> owners_;
+	simple_vector<slot> slots_;
+	uint32_t free_head_ = no_slot;
+};
+}  // namespace bmstu
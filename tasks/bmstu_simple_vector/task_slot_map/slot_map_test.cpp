@@ -0,0 +1,185 @@
+#include "bmstu_slot_map.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "bmstu_bench.h"
+#include "bmstu_simple_vector.h"
+
+TEST(SlotMapTest, InsertFind)
+{
+	bmstu::slot_map<std::string> map;
+	ASSERT_TRUE(map.empty());
+	const bmstu::slot_key a = map.insert("a");
+	const bmstu::slot_key b = map.emplace(3, 'b');
+	ASSERT_EQ(map.size(), 2u);
+	ASSERT_NE(a, b);
+	ASSERT_EQ(map[a], "a");
+	ASSERT_EQ(map.at(b), "bbb");
+	ASSERT_TRUE(map.contains(a));
+	ASSERT_EQ(*map.find(b), "bbb");
+	ASSERT_EQ(map.find(bmstu::slot_key{}), nullptr);
+	ASSERT_EQ(map.find(bmstu::slot_key{7, 1}), nullptr);
+	map[a] += "!";
+	ASSERT_EQ(map.at(a), "a!");
+}
+
+TEST(SlotMapTest, StaleKey)
+{
+	bmstu::slot_map<int> map;
+	const bmstu::slot_key first = map.insert(1);
+	ASSERT_TRUE(map.erase(first));
+	ASSERT_FALSE(map.erase(first));
+	ASSERT_FALSE(map.contains(first));
+	ASSERT_EQ(map.find(first), nullptr);
+	ASSERT_THROW(map.at(first), std::out_of_range);
+
+	// the slot is reused under a new generation
+	const bmstu::slot_key second = map.insert(2);
+	ASSERT_EQ(second.index, first.index);
+	ASSERT_NE(second.generation, first.generation);
+	ASSERT_EQ(map.slot_count(), 1u);
+	ASSERT_EQ(map.find(first), nullptr);
+	ASSERT_EQ(map[second], 2);
+	// a free slot's next generation was never handed out
+	map.erase(second);
+	ASSERT_FALSE(map.contains(
+		bmstu::slot_key{second.index, second.generation + 1}));
+}
+
+TEST(SlotMapTest, SwapAndPopKeepsKeys)
+{
+	bmstu::slot_map<int> map;
+	std::vector<bmstu::slot_key> keys;
+	for (int i = 0; i < 100; ++i)
+	{
+		keys.push_back(map.insert(i));
+	}
+	for (int i = 0; i < 100; i += 3)
+	{
+		ASSERT_TRUE(map.erase(keys[i]));
+	}
+	ASSERT_EQ(map.size(), 66u);
+	for (int i = 0; i < 100; ++i)
+	{
+		if (i % 3 == 0)
+		{
+			ASSERT_FALSE(map.contains(keys[i]));
+		}
+		else
+		{
+			ASSERT_EQ(map.at(keys[i]), i);
+		}
+	}
+	// values stay packed
+	std::vector<int> values(map.begin(), map.end());
+	std::sort(values.begin(), values.end());
+	ASSERT_EQ(values.size(), 66u);
+	ASSERT_EQ(std::accumulate(map.begin(), map.end(), 0),
+			  std::accumulate(values.begin(), values.end(), 0));
+	ASSERT_EQ(map.data(), &*map.begin());
+
+	for (int i = 0; i < 34; ++i)
+	{
+		map.insert(1000 + i);
+	}
+	ASSERT_EQ(map.slot_count(), 100u);
+}
+
+TEST(SlotMapTest, Clear)
+{
+	bmstu::slot_map<std::string> map;
+	const bmstu::slot_key a = map.insert("a");
+	const bmstu::slot_key b = map.insert("b");
+	map.clear();
+	ASSERT_TRUE(map.empty());
+	ASSERT_FALSE(map.contains(a));
+	ASSERT_FALSE(map.contains(b));
+	const bmstu::slot_key c = map.insert("c");
+	ASSERT_EQ(map.slot_count(), 2u);
+	ASSERT_EQ(map[c], "c");
+	ASSERT_FALSE(map.contains(a));
+}
+
+namespace
+{
+struct Particle
+{
+	float x;
+	float y;
+	float dx;
+	float dy;
+	uint32_t id;
+};
+
+// The high half of xorshift64 is the better mixed one
+uint32_t next_random(uint64_t& state)
+{
+	return static_cast<uint32_t>(bmstu::bench::next_random(state) >> 32);
+}
+
+using bmstu::bench::time_it;
+
+constexpr uint32_t live = 100'000;
+constexpr int churn_steps = 200'000;
+
+template <typename Range>
+[[gnu::noipa]] long long step_all(Range& particles)
+{
+	long long sum = 0;
+	for (Particle& p : particles)
+	{
+		p.x += p.dx;
+		p.y += p.dy;
+		sum += p.id;
+	}
+	return sum;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SlotMapBench, DISABLED_Churn)
+{
+	// each step kills a random entity and spawns one: slot_map by key,
+	// simple_vector by position, shifting everything after it
+	bmstu::slot_map<Particle> map;
+	bmstu::simple_vector<bmstu::slot_key> keys;
+	bmstu::simple_vector<Particle> vec;
+	for (uint32_t i = 0; i < live; ++i)
+	{
+		keys.push_back(map.insert({0, 0, 1, 1, i}));
+		vec.push_back({0, 0, 1, 1, i});
+	}
+	time_it("slot_map churn 200k",
+			[&]
+			{
+				uint64_t state = 88172645463325252ull;
+				for (int step = 0; step < churn_steps; ++step)
+				{
+					bmstu::slot_key& key = keys[next_random(state) % live];
+					map.erase(key);
+					key = map.insert({0, 0, 1, 1, live + step});
+				}
+				return static_cast<long long>(map.size());
+			});
+	time_it("simple_vector erase(pos) churn 200k",
+			[&]
+			{
+				uint64_t state = 88172645463325252ull;
+				for (int step = 0; step < churn_steps; ++step)
+				{
+					vec.erase(vec.begin() + next_random(state) % live);
+					vec.push_back({0, 0, 1, 1, live + step});
+				}
+				return static_cast<long long>(vec.size());
+			});
+	time_it("slot_map iterate 100k x 1000", [&] { return step_all(map); },
+			1000);
+	time_it("simple_vector iterate 100k x 1000",
+			[&] { return step_all(vec); }, 1000);
+}
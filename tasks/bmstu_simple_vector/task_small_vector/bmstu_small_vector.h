@@ -0,0 +1,326 @@
+#pragma once
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "array_ptr.h"
+#include "bmstu_simple_vector.h"
+#include "bmstu_vector_compare.h"
+
+namespace bmstu
+{
+// simple_vector that keeps up to N elements inside the object and only goes
+// to the heap beyond that. Same operations, iterators and comparisons.
+// Moving an inline small_vector moves its elements one by one, so unlike
+// simple_vector the move is O(N), invalidates iterators and can throw when
+// T's move constructor can.
+//
+// Heap buffers come from a default-constructed Allocator, so it should be
+// stateless; there is no constructor taking one.
+template <typename T,
+		  size_t N,
+		  typename Growth = growth_x2,
+		  typename Allocator = std::allocator<T>>
+class small_vector
+	: public vector_base<small_vector<T, N, Growth, Allocator>, T, Growth>
+{
+	static_assert(N > 0, "use simple_vector for N == 0");
+
+	using base = vector_base<small_vector, T, Growth>;
+	using buffer = array_ptr<T, Allocator>;
+
+	friend base;
+
+   public:
+	using iterator = vector_iterator<T>;
+	using const_iterator = vector_iterator<const T>;
+
+	static constexpr size_t inline_capacity = N;
+
+	small_vector() noexcept = default;
+
+	~small_vector()
+	{
+		std::destroy_n(data(), size_);
+		free_heap();
+	}
+
+	// These delegate to the default constructor, so that if a copy throws
+	// the destructor frees the heap buffer
+	small_vector(std::initializer_list<T> init) : small_vector()
+	{
+		reserve(init.size());
+		std::uninitialized_copy(init.begin(), init.end(), data());
+		size_ = init.size();
+	}
+
+	small_vector(size_t size, const T& value = T{}) : small_vector()
+	{
+		reserve(size);
+		std::uninitialized_fill_n(data(), size, value);
+		size_ = size;
+	}
+
+	small_vector(const small_vector& other) : small_vector()
+	{
+		reserve(other.size_);
+		std::uninitialized_copy_n(other.data(), other.size_, data());
+		size_ = other.size_;
+	}
+
+	small_vector(small_vector&& other) noexcept(
+		std::is_nothrow_move_constructible_v<T>)
+	{
+		take(other);
+	}
+
+	small_vector& operator=(const small_vector& other)
+	{
+		if (this != &other)
+		{
+			small_vector copy(other);
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	small_vector& operator=(small_vector&& other) noexcept(
+		std::is_nothrow_move_constructible_v<T>)
+	{
+		if (this != &other)
+		{
+			this->clear();
+			free_heap();
+			take(other);
+		}
+		return *this;
+	}
+
+	iterator begin() noexcept { return iterator(data()); }
+
+	iterator end() noexcept { return iterator(data() + size_); }
+
+	const_iterator begin() const noexcept { return const_iterator(data()); }
+
+	const_iterator end() const noexcept
+	{
+		return const_iterator(data() + size_);
+	}
+
+	const_iterator cbegin() const noexcept { return begin(); }
+
+	const_iterator cend() const noexcept { return end(); }
+
+	T* data() noexcept { return is_inline() ? inline_data() : heap_; }
+
+	const T* data() const noexcept
+	{
+		return is_inline() ? inline_data() : heap_;
+	}
+
+	T& operator[](size_t index) noexcept { return data()[index]; }
+
+	const T& operator[](size_t index) const noexcept { return data()[index]; }
+
+	T& at(size_t index)
+	{
+		if (index >= size_)
+		{
+			throw std::out_of_range("Index out of range");
+		}
+		return data()[index];
+	}
+
+	const T& at(size_t index) const
+	{
+		if (index >= size_)
+		{
+			throw std::out_of_range("Index out of range");
+		}
+		return data()[index];
+	}
+
+	size_t size() const noexcept { return size_; }
+
+	size_t capacity() const noexcept { return capacity_; }
+
+	// Whether the elements live inside the object
+	bool is_inline() const noexcept { return capacity_ == N; }
+
+	void swap(small_vector& other) noexcept(
+		std::is_nothrow_move_constructible_v<T>)
+	{
+		small_vector tmp(std::move(other));
+		other = std::move(*this);
+		*this = std::move(tmp);
+	}
+
+	friend void swap(small_vector& lhs, small_vector& rhs) noexcept(
+		std::is_nothrow_move_constructible_v<T>)
+	{
+		lhs.swap(rhs);
+	}
+
+	void reserve(size_t new_cap)
+	{
+		if (new_cap > capacity_)
+		{
+			reallocate(new_cap);
+		}
+	}
+
+	// Moves back inside the object when the elements fit
+	void shrink_to_fit()
+	{
+		if (!is_inline() && size_ < capacity_)
+		{
+			reallocate(size_);
+		}
+	}
+
+	friend bool operator==(const small_vector& lhs, const small_vector& rhs)
+	{
+		return lhs.size_ == rhs.size_ &&
+			   equal_elements(lhs.data(), rhs.data(), lhs.size_);
+	}
+
+	friend bool operator!=(const small_vector& lhs, const small_vector& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	friend std::weak_ordering operator<=>(const small_vector& lhs,
+										  const small_vector& rhs)
+	{
+		return compare_elements(lhs.data(), lhs.size_, rhs.data(),
+								rhs.size_);
+	}
+
+	friend std::ostream& operator<<(std::ostream& os, const small_vector& vec)
+	{
+		os << "{";
+		for (size_t i = 0; i < vec.size_; ++i)
+		{
+			if (i > 0)
+			{
+				os << ", ";
+			}
+			os << vec[i];
+		}
+		return os << "}";
+	}
+
+   private:
+	T* inline_data() noexcept { return reinterpret_cast<T*>(inline_); }
+
+	const T* inline_data() const noexcept
+	{
+		return reinterpret_cast<const T*>(inline_);
+	}
+
+	// Expects this to hold no elements and be inline. A heap buffer is
+	// stolen, inline elements are moved over one by one; other is left
+	// empty and inline.
+	void take(small_vector& other)
+	{
+		if (other.is_inline())
+		{
+			std::uninitialized_move_n(other.inline_data(), other.size_,
+									  inline_data());
+			size_ = other.size_;
+			other.clear();
+			return;
+		}
+		heap_ = other.heap_;
+		capacity_ = other.capacity_;
+		size_ = std::exchange(other.size_, 0);
+		other.capacity_ = N;
+	}
+
+	// An array_ptr owns a new buffer until adopt() releases it into heap_
+	buffer allocate(size_t capacity) const { return buffer(capacity); }
+
+	// Switches to a heap buffer that already holds the elements
+	void adopt(buffer&& heap, size_t capacity) noexcept
+	{
+		free_heap();
+		heap_ = heap.release();
+		capacity_ = capacity;
+	}
+
+	static void deallocate(T* heap, size_t capacity) noexcept
+	{
+		Allocator alloc;
+		std::allocator_traits<Allocator>::deallocate(alloc, heap, capacity);
+	}
+
+	// Frees the heap buffer, if any, and goes inline; its elements must be
+	// gone
+	void free_heap() noexcept
+	{
+		if (!is_inline())
+		{
+			deallocate(heap_, capacity_);
+			capacity_ = N;
+		}
+	}
+
+	// To a heap buffer of new_cap slots, or back inline if new_cap <= N
+	void reallocate(size_t new_cap)
+	{
+		if (new_cap > N)
+		{
+			buffer new_heap(new_cap);
+			this->relocate_to(new_heap.get());
+			adopt(std::move(new_heap), new_cap);
+			return;
+		}
+		if (!is_inline())
+		{
+			// the elements overwrite heap_, so keep it aside
+			T* heap = heap_;
+			try
+			{
+				base::transfer(heap, size_, inline_data());
+			}
+			catch (...)
+			{
+				heap_ = heap;
+				throw;
+			}
+			std::destroy_n(heap, size_);
+			deallocate(heap, capacity_);
+			capacity_ = N;
+		}
+	}
+
+	size_t size_ = 0;
+	size_t capacity_ = N;
+	// capacity_ == N while the elements are inline, heap buffers are bigger
+	union
+	{
+		T* heap_;
+		alignas(T) unsigned char inline_[N * sizeof(T)];
+	};
+};
+
+template <typename T,
+		  size_t N,
+		  typename Growth,
+		  typename Allocator,
+		  typename Predicate>
+size_t erase_if(small_vector<T, N, Growth, Allocator>& vec, Predicate pred)
+{
+	auto first = std::remove_if(vec.begin(), vec.end(), pred);
+	const size_t removed = vec.end() - first;
+	vec.erase(first, vec.end());
+	return removed;
+}
+}  // namespace bmstu
@@ -0,0 +1,241 @@
+#include "bmstu_small_vector.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "bmstu_simple_vector.h"
+
+namespace
+{
+size_t allocations = 0;
+
+// std::allocator that counts the buffers it hands out
+template <typename T>
+struct counting_allocator
+{
+	using value_type = T;
+
+	counting_allocator() noexcept = default;
+
+	template <typename U>
+	counting_allocator(const counting_allocator<U>&) noexcept
+	{
+	}
+
+	T* allocate(size_t size)
+	{
+		++allocations;
+		return std::allocator<T>().allocate(size);
+	}
+
+	void deallocate(T* ptr, size_t size) noexcept
+	{
+		std::allocator<T>().deallocate(ptr, size);
+	}
+
+	friend bool operator==(const counting_allocator&,
+						   const counting_allocator&) noexcept
+	{
+		return true;
+	}
+};
+
+// Counts live objects
+struct Tracked
+{
+	Tracked(int v) : value(std::to_string(v)) { ++alive; }
+
+	Tracked(const Tracked& other) : value(other.value) { ++alive; }
+
+	Tracked(Tracked&& other) noexcept : value(std::move(other.value))
+	{
+		++alive;
+	}
+
+	Tracked& operator=(const Tracked& other) = default;
+
+	Tracked& operator=(Tracked&& other) noexcept = default;
+
+	~Tracked() { --alive; }
+
+	std::string value;
+	inline static int alive = 0;
+};
+
+using small_ints =
+	bmstu::small_vector<int, 8, bmstu::growth_x2, counting_allocator<int>>;
+using simple_ints =
+	bmstu::simple_vector<int, bmstu::growth_x2, counting_allocator<int>>;
+}  // namespace
+
+static_assert(std::is_same_v<small_ints::iterator,
+							 bmstu::simple_vector<int>::iterator>);
+static_assert(std::is_same_v<small_ints::const_iterator,
+							 bmstu::simple_vector<int>::const_iterator>);
+static_assert(std::ranges::contiguous_range<small_ints>);
+static_assert(std::is_nothrow_move_constructible_v<small_ints>);
+static_assert(sizeof(small_ints) == 2 * sizeof(size_t) + 8 * sizeof(int));
+
+TEST(SmallVectorTest, InlineUntilFull)
+{
+	const size_t before = allocations;
+	small_ints v;
+	for (int i = 0; i < 8; ++i)
+	{
+		v.push_back(i);
+	}
+	small_ints copy(v);
+	copy.insert(copy.begin() + 2, 3, -1);
+	ASSERT_EQ(allocations - before, 1u);
+	ASSERT_TRUE(v.is_inline());
+	ASSERT_EQ(v.capacity(), 8u);
+	ASSERT_FALSE(copy.is_inline());
+	ASSERT_EQ(copy.size(), 11u);
+
+	v.push_back(8);
+	ASSERT_EQ(allocations - before, 2u);
+	ASSERT_FALSE(v.is_inline());
+	ASSERT_EQ(v.capacity(), 16u);
+	for (int i = 0; i < 9; ++i)
+	{
+		ASSERT_EQ(v[i], i);
+	}
+}
+
+TEST(SmallVectorTest, MoveInline)
+{
+	{
+		bmstu::small_vector<Tracked, 4> v;
+		v.emplace_back(1);
+		v.emplace_back(2);
+		bmstu::small_vector<Tracked, 4> moved(std::move(v));
+		ASSERT_TRUE(v.empty());
+		ASSERT_TRUE(moved.is_inline());
+		ASSERT_EQ(moved[1].value, "2");
+		ASSERT_EQ(Tracked::alive, 2);
+
+		bmstu::small_vector<Tracked, 4> target{5, 6, 7, 8, 9};
+		target = std::move(moved);
+		ASSERT_EQ(target.size(), 2u);
+		ASSERT_EQ(target[0].value, "1");
+		ASSERT_EQ(Tracked::alive, 2);
+		// the moved-from vector is usable
+		moved.emplace_back(3);
+		ASSERT_EQ(moved.data(), &moved[0]);
+		ASSERT_TRUE(moved.is_inline());
+	}
+	ASSERT_EQ(Tracked::alive, 0);
+}
+
+TEST(SmallVectorTest, MoveHeap)
+{
+	bmstu::small_vector<std::string, 2> v{"a", "b", "c"};
+	const std::string* elements = v.data();
+	bmstu::small_vector<std::string, 2> moved(std::move(v));
+	ASSERT_EQ(moved.data(), elements);
+	ASSERT_TRUE(v.empty());
+	ASSERT_TRUE(v.is_inline());
+	v = std::move(moved);
+	ASSERT_EQ(v.data(), elements);
+	ASSERT_EQ(v[2], "c");
+}
+
+TEST(SmallVectorTest, Swap)
+{
+	bmstu::small_vector<std::string, 2> small{"x"};
+	bmstu::small_vector<std::string, 2> big{"a", "b", "c"};
+	swap(small, big);
+	ASSERT_EQ(small.size(), 3u);
+	ASSERT_EQ(big, (bmstu::small_vector<std::string, 2>{"x"}));
+	ASSERT_TRUE(big.is_inline());
+	ASSERT_TRUE(small < big);
+}
+
+TEST(SmallVectorTest, BackInline)
+{
+	{
+		bmstu::small_vector<Tracked, 4> v;
+		for (int i = 0; i < 10; ++i)
+		{
+			v.emplace_back(i);
+		}
+		v.erase(v.begin() + 2, v.end());
+		v.shrink_to_fit();
+		ASSERT_TRUE(v.is_inline());
+		ASSERT_EQ(v.capacity(), 4u);
+		ASSERT_EQ(v[1].value, "1");
+		ASSERT_EQ(Tracked::alive, 2);
+	}
+	ASSERT_EQ(Tracked::alive, 0);
+
+	bmstu::small_vector<int, 4, bmstu::hysteresis<bmstu::growth_x2>> v(64);
+	ASSERT_EQ(bmstu::erase_if(v, [](int) { return true; }), 64u);
+	ASSERT_TRUE(v.is_inline());
+}
+
+TEST(SmallVectorTest, SameInterface)
+{
+	small_ints v{5, 1, 4};
+	v.append_range(std::views::iota(0, 3));
+	v.emplace(v.begin(), 9);
+	ASSERT_EQ(v.at(0), 9);
+	ASSERT_THROW(v.at(7), std::out_of_range);
+	std::ranges::sort(v);
+	std::ostringstream os;
+	os << v;
+	ASSERT_EQ(os.str(), "{0, 1, 1, 2, 4, 5, 9}");
+	v.erase(v.end());
+	v.pop_back();
+	v.resize(2);
+	ASSERT_EQ(v, (small_ints{0, 1}));
+	ASSERT_TRUE(v != (small_ints{0, 2}));
+}
+
+namespace
+{
+template <typename Vector>
+[[gnu::noipa]] long long build_and_sum(int length)
+{
+	Vector v;
+	for (int i = 0; i < length; ++i)
+	{
+		v.push_back(i);
+	}
+	long long sum = 0;
+	for (int value : v)
+	{
+		sum += value;
+	}
+	return sum;
+}
+
+template <typename Vector>
+void time_short(const char* name)
+{
+	const size_t before = allocations;
+	auto start = std::chrono::steady_clock::now();
+	long long checksum = 0;
+	for (int i = 0; i < 2'000'000; ++i)
+	{
+		checksum += build_and_sum<Vector>(i % 9);
+	}
+	auto elapsed = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start);
+	std::cout << name << ": " << elapsed.count() << " ms, "
+			  << allocations - before << " allocations (checksum "
+			  << checksum << ")" << std::endl;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SmallVectorBench, DISABLED_ShortLengths)
+{
+	time_short<simple_ints>("simple_vector<int>, 0-8 elements");
+	time_short<small_ints>("small_vector<int, 8>, 0-8 elements");
+}
@@ -0,0 +1,485 @@
+#pragma once
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "array_ptr.h"
+#include "bmstu_simple_vector.h"
+
+namespace bmstu
+{
+// Vector of rows (Ts...) stored as one column per field: field I of every
+// row lies in its own array_ptr<T_I>. A loop over one field reads only that
+// column, so the cache and the vectorizer see a plain array instead of
+// records with the other fields in between. Rows are handed out as tuples
+// of references.
+template <typename... Ts>
+class soa_vector
+{
+	static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one field");
+	// Growth moves the columns one after another, so a move that throws
+	// after others have gone through would tear the rows apart
+	static_assert(((std::is_nothrow_move_constructible_v<Ts> ||
+					std::is_copy_constructible_v<Ts>) &&
+				   ...),
+				  "a move-only field must be nothrow move constructible");
+
+	static constexpr size_t field_count = sizeof...(Ts);
+
+	template <size_t I>
+	using field_t = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+	// Row index with the operations of a random access iterator. operator*
+	// gives a proxy row, so it is only an input iterator to the old
+	// iterator_category, and a random access one to C++20 only where the
+	// library relates a row of references to value_type (const rows need
+	// C++23's tuple common references)
+	template <typename Owner, typename Row>
+	class basic_iterator
+	{
+	   public:
+		using iterator_concept = std::conditional_t<
+			std::common_reference_with<Row&&, std::tuple<Ts...>&> &&
+				std::common_reference_with<Row&&, const std::tuple<Ts...>&>,
+			std::random_access_iterator_tag,
+			std::input_iterator_tag>;
+		using iterator_category = std::input_iterator_tag;
+		using value_type = std::tuple<Ts...>;
+		using reference = Row;
+		using difference_type = std::ptrdiff_t;
+
+		basic_iterator() = default;
+
+		basic_iterator(Owner* owner, size_t index)
+			: owner_(owner), index_(index)
+		{
+		}
+
+		reference operator*() const { return (*owner_)[index_]; }
+
+		reference operator[](difference_type n) const
+		{
+			return (*owner_)[index_ + n];
+		}
+
+		basic_iterator& operator++()
+		{
+			++index_;
+			return *this;
+		}
+
+		basic_iterator& operator--()
+		{
+			--index_;
+			return *this;
+		}
+
+		basic_iterator operator++(int)
+		{
+			basic_iterator copy(*this);
+			++index_;
+			return copy;
+		}
+
+		basic_iterator operator--(int)
+		{
+			basic_iterator copy(*this);
+			--index_;
+			return copy;
+		}
+
+		basic_iterator& operator+=(difference_type n) noexcept
+		{
+			index_ += n;
+			return *this;
+		}
+
+		basic_iterator& operator-=(difference_type n) noexcept
+		{
+			index_ -= n;
+			return *this;
+		}
+
+		friend basic_iterator operator+(basic_iterator it,
+										difference_type n) noexcept
+		{
+			return it += n;
+		}
+
+		friend basic_iterator operator+(difference_type n,
+										basic_iterator it) noexcept
+		{
+			return it += n;
+		}
+
+		friend basic_iterator operator-(basic_iterator it,
+										difference_type n) noexcept
+		{
+			return it -= n;
+		}
+
+		friend difference_type operator-(const basic_iterator& end,
+										 const basic_iterator& begin) noexcept
+		{
+			return static_cast<difference_type>(end.index_ - begin.index_);
+		}
+
+		friend bool operator==(const basic_iterator& lhs,
+							   const basic_iterator& rhs)
+		{
+			return lhs.index_ == rhs.index_;
+		}
+
+		friend auto operator<=>(const basic_iterator& lhs,
+								const basic_iterator& rhs)
+		{
+			return lhs.index_ <=> rhs.index_;
+		}
+
+	   private:
+		Owner* owner_ = nullptr;
+		size_t index_ = 0;
+	};
+
+   public:
+	using value_type = std::tuple<Ts...>;
+	using reference = std::tuple<Ts&...>;
+	using const_reference = std::tuple<const Ts&...>;
+	using iterator = basic_iterator<soa_vector, reference>;
+	using const_iterator = basic_iterator<const soa_vector, const_reference>;
+
+	soa_vector() noexcept = default;
+
+	~soa_vector() { clear(); }
+
+	// These delegate to the default constructor, so that if a copy throws
+	// the destructor frees what was built so far
+	soa_vector(std::initializer_list<value_type> init)
+		: soa_vector()
+	{
+		reserve(init.size());
+		for (const value_type& row : init)
+		{
+			push_back(row);
+		}
+	}
+
+	soa_vector(const soa_vector& other)
+		: soa_vector()
+	{
+		reserve(other.size_);
+		for (const_reference row : other)
+		{
+			std::apply([this](const Ts&... fields) { emplace_back(fields...); },
+					   row);
+		}
+	}
+
+	soa_vector(soa_vector&& other) noexcept { swap(other); }
+
+	soa_vector& operator=(const soa_vector& other)
+	{
+		if (this != &other)
+		{
+			soa_vector copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	soa_vector& operator=(soa_vector&& other) noexcept
+	{
+		if (this != &other)
+		{
+			soa_vector moved(std::move(other));
+			swap(moved);
+		}
+		return *this;
+	}
+
+	iterator begin() noexcept { return iterator(this, 0); }
+
+	iterator end() noexcept { return iterator(this, size_); }
+
+	const_iterator begin() const noexcept { return const_iterator(this, 0); }
+
+	const_iterator end() const noexcept { return const_iterator(this, size_); }
+
+	const_iterator cbegin() const noexcept { return begin(); }
+
+	const_iterator cend() const noexcept { return end(); }
+
+	// Assigning to the row writes through to the columns
+	reference operator[](size_t index) noexcept
+	{
+		return row<reference>(*this, index,
+							  std::index_sequence_for<Ts...>{});
+	}
+
+	const_reference operator[](size_t index) const noexcept
+	{
+		return row<const_reference>(*this, index,
+									std::index_sequence_for<Ts...>{});
+	}
+
+	reference at(size_t index)
+	{
+		if (index >= size_)
+		{
+			throw std::out_of_range("Index out of range");
+		}
+		return (*this)[index];
+	}
+
+	const_reference at(size_t index) const
+	{
+		if (index >= size_)
+		{
+			throw std::out_of_range("Index out of range");
+		}
+		return (*this)[index];
+	}
+
+	// Field I of every row as one contiguous array
+	template <size_t I>
+	std::span<field_t<I>> column() noexcept
+	{
+		return {std::get<I>(columns_).get(), size_};
+	}
+
+	template <size_t I>
+	std::span<const field_t<I>> column() const noexcept
+	{
+		return {std::get<I>(columns_).get(), size_};
+	}
+
+	size_t size() const noexcept { return size_; }
+
+	size_t capacity() const noexcept { return capacity_; }
+
+	bool empty() const noexcept { return size_ == 0; }
+
+	void swap(soa_vector& other) noexcept
+	{
+		columns_.swap(other.columns_);
+		std::swap(size_, other.size_);
+		std::swap(capacity_, other.capacity_);
+	}
+
+	friend void swap(soa_vector& lhs, soa_vector& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+	void reserve(size_t new_cap)
+	{
+		if (new_cap > capacity_)
+		{
+			reallocate(new_cap);
+		}
+	}
+
+	// Takes one argument per field
+	template <typename... Args>
+		requires(sizeof...(Args) == field_count)
+	reference emplace_back(Args&&... args)
+	{
+		if (size_ == capacity_)
+		{
+			// args may refer to a row of this vector, so build the row
+			// before the columns move
+			value_type row(std::forward<Args>(args)...);
+			reserve(growth_x2::next_capacity(capacity_, size_ + 1));
+			construct_fields<0>(std::move(row));
+		}
+		else
+		{
+			construct_fields<0>(
+				std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+		return (*this)[size_++];
+	}
+
+	void push_back(const value_type& row)
+	{
+		std::apply([this](const Ts&... fields) { emplace_back(fields...); },
+				   row);
+	}
+
+	void push_back(value_type&& row)
+	{
+		std::apply([this](Ts&... fields)
+				   { emplace_back(std::move(fields)...); },
+				   row);
+	}
+
+	void pop_back()
+	{
+		if (size_ > 0)
+		{
+			--size_;
+			for_each_column([this](auto* column)
+							{ std::destroy_at(column + size_); });
+		}
+	}
+
+	void clear() noexcept
+	{
+		for_each_column([this](auto* column)
+						{ std::destroy_n(column, size_); });
+		size_ = 0;
+	}
+
+	// Stable sort of the rows by field I. The order is worked out on the
+	// key column alone, then every column is permuted in place with swaps.
+	template <size_t I, typename Compare = std::less<>>
+	void sort_by(Compare comp = {})
+	{
+		const field_t<I>* keys = std::get<I>(columns_).get();
+		simple_vector<size_t> order(size_);
+		std::iota(order.begin(), order.end(), size_t{0});
+		std::stable_sort(order.begin(), order.end(),
+						 [&](size_t lhs, size_t rhs)
+						 { return comp(keys[lhs], keys[rhs]); });
+		// row order[k] goes to k: walk each cycle, fixing one row per swap
+		for (size_t start = 0; start < size_; ++start)
+		{
+			size_t current = start;
+			while (order[current] != start)
+			{
+				const size_t next = order[current];
+				for_each_column(
+					[&](auto* column)
+					{ std::ranges::swap(column[current], column[next]); });
+				order[current] = current;
+				current = next;
+			}
+			order[current] = current;
+		}
+	}
+
+	friend bool operator==(const soa_vector& lhs, const soa_vector& rhs)
+	{
+		return lhs.size_ == rhs.size_ &&
+			   std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	friend bool operator!=(const soa_vector& lhs, const soa_vector& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+   private:
+	template <typename Row, typename Self, size_t... I>
+	static Row row(Self& self, size_t index, std::index_sequence<I...>)
+	{
+		return Row(std::get<I>(self.columns_)[index]...);
+	}
+
+	template <typename Func>
+	void for_each_column(Func func)
+	{
+		std::apply([&](array_ptr<Ts>&... columns)
+				   { (func(columns.get()), ...); },
+				   columns_);
+	}
+
+	// Builds field I.. of row size_ from args; on a throw the fields built
+	// so far are destroyed again
+	template <size_t I, typename Args>
+	void construct_fields(Args&& args)
+	{
+		if constexpr (I < field_count)
+		{
+			field_t<I>* field =
+				std::construct_at(std::get<I>(columns_).get() + size_,
+								  std::get<I>(std::forward<Args>(args)));
+			try
+			{
+				construct_fields<I + 1>(std::forward<Args>(args));
+			}
+			catch (...)
+			{
+				std::destroy_at(field);
+				throw;
+			}
+		}
+	}
+
+	template <typename T>
+	static constexpr bool moves_on_relocate =
+		std::is_nothrow_move_constructible_v<T> ||
+		!std::is_copy_constructible_v<T>;
+
+	// Columns that have to be copied go first, so if a copy throws nothing
+	// has been moved out of the old columns yet
+	template <size_t I>
+	void copy_columns(std::tuple<array_ptr<Ts>...>& fresh)
+	{
+		if constexpr (I < field_count)
+		{
+			if constexpr (moves_on_relocate<field_t<I>>)
+			{
+				copy_columns<I + 1>(fresh);
+			}
+			else
+			{
+				field_t<I>* out = std::get<I>(fresh).get();
+				std::uninitialized_copy_n(std::get<I>(columns_).get(), size_,
+										  out);
+				try
+				{
+					copy_columns<I + 1>(fresh);
+				}
+				catch (...)
+				{
+					std::destroy_n(out, size_);
+					throw;
+				}
+			}
+		}
+	}
+
+	// Can't throw: see the static_assert on Ts
+	template <size_t... I>
+	void move_columns(std::tuple<array_ptr<Ts>...>& fresh,
+					  std::index_sequence<I...>)
+	{
+		(
+			[&]
+			{
+				if constexpr (moves_on_relocate<field_t<I>>)
+				{
+					std::uninitialized_move_n(std::get<I>(columns_).get(),
+											  size_, std::get<I>(fresh).get());
+				}
+			}(),
+			...);
+	}
+
+	void reallocate(size_t new_cap)
+	{
+		std::tuple<array_ptr<Ts>...> fresh{array_ptr<Ts>(new_cap)...};
+		copy_columns<0>(fresh);
+		move_columns(fresh, std::index_sequence_for<Ts...>{});
+		for_each_column([this](auto* column)
+						{ std::destroy_n(column, size_); });
+		columns_.swap(fresh);
+		capacity_ = new_cap;
+	}
+
+	std::tuple<array_ptr<Ts>...> columns_;
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+};
+}  // namespace bmstu
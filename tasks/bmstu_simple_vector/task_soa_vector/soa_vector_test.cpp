@@ -0,0 +1,269 @@
+#include "bmstu_soa_vector.h"
+
+#include <gtest/gtest.h>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "bmstu_bench.h"
+#include "bmstu_simple_vector.h"
+
+namespace
+{
+using students = bmstu::soa_vector<std::string, int, double>;
+
+// Copies fine until copies_left runs out, and has no noexcept move, so
+// growth has to copy it. Counts live objects.
+struct FragileCopy
+{
+	FragileCopy(int v) : value(v) { ++alive; }
+
+	FragileCopy(const FragileCopy& other) : value(other.value)
+	{
+		if (copies_left-- == 0)
+		{
+			throw std::runtime_error("copy failed");
+		}
+		++alive;
+	}
+
+	FragileCopy& operator=(const FragileCopy& other) = default;
+
+	~FragileCopy() { --alive; }
+
+	int value;
+	inline static int alive = 0;
+	inline static int copies_left = 1'000'000;
+};
+}  // namespace
+
+static_assert(std::is_same_v<decltype(std::declval<students&>()[0]),
+							 std::tuple<std::string&, int&, double&>>);
+static_assert(std::is_same_v<decltype(std::declval<students&>().column<1>()),
+							 std::span<int>>);
+static_assert(
+	std::is_same_v<decltype(std::declval<const students&>().column<0>()),
+				   std::span<const std::string>>);
+static_assert(std::is_nothrow_move_constructible_v<students>);
+static_assert(std::random_access_iterator<students::iterator>);
+static_assert(std::ranges::random_access_range<students>);
+// the tag claims only what the concept can check
+static_assert(std::random_access_iterator<students::const_iterator> ==
+			  std::is_same_v<students::const_iterator::iterator_concept,
+							 std::random_access_iterator_tag>);
+
+TEST(SoaVectorTest, PushBackAndRows)
+{
+	students v;
+	ASSERT_TRUE(v.empty());
+	v.push_back({"Alice", 20, 4.5});
+	std::tuple<std::string, int, double> bob{"Bob", 18, 3.9};
+	v.push_back(bob);
+	v.emplace_back("Charlie", 22, 4.1);
+	ASSERT_EQ(v.size(), 3u);
+	ASSERT_EQ(std::get<0>(bob), "Bob");
+
+	auto [name, age, score] = v[1];
+	ASSERT_EQ(name, "Bob");
+	ASSERT_EQ(age, 18);
+	ASSERT_DOUBLE_EQ(score, 3.9);
+	// the row is a view: writes land in the columns
+	age = 19;
+	v[2] = std::make_tuple(std::string("Carol"), 23, 4.2);
+	ASSERT_EQ(v.column<1>()[1], 19);
+	ASSERT_EQ(v.column<0>()[2], "Carol");
+	ASSERT_THROW(v.at(3), std::out_of_range);
+
+	v.pop_back();
+	ASSERT_EQ(v.size(), 2u);
+	ASSERT_EQ(std::get<0>(v.at(1)), "Bob");
+	ASSERT_EQ(std::get<0>(*(1 + v.begin())), "Bob");
+}
+
+TEST(SoaVectorTest, Columns)
+{
+	bmstu::soa_vector<int, float> v;
+	for (int i = 0; i < 1000; ++i)
+	{
+		v.emplace_back(i, i * 0.5f);
+	}
+	std::span<int> ids = v.column<0>();
+	std::span<float> weights = v.column<1>();
+	ASSERT_EQ(ids.size(), 1000u);
+	ASSERT_EQ(std::accumulate(ids.begin(), ids.end(), 0), 499500);
+	ASSERT_FLOAT_EQ(weights[999], 499.5f);
+	for (float& weight : weights)
+	{
+		weight *= 2;
+	}
+	ASSERT_FLOAT_EQ(std::get<1>(v[10]), 10.0f);
+	ASSERT_GE(v.capacity(), 1000u);
+}
+
+TEST(SoaVectorTest, EmplaceOwnRow)
+{
+	bmstu::soa_vector<std::string, int> v;
+	v.emplace_back(std::string(40, 'a'), 1);
+	for (int i = 0; i < 100; ++i)
+	{
+		// the first row is read while the columns grow
+		auto [text, number] = v[0];
+		v.emplace_back(text, number + i);
+	}
+	ASSERT_EQ(v.size(), 101u);
+	ASSERT_EQ(std::get<0>(v[100]), std::string(40, 'a'));
+	ASSERT_EQ(std::get<1>(v[100]), 100);
+}
+
+TEST(SoaVectorTest, SortByColumn)
+{
+	students v{{"Alice", 20, 4.5},
+			   {"Bob", 18, 3.9},
+			   {"Charlie", 22, 4.1},
+			   {"Dave", 18, 4.8},
+			   {"Eve", 20, 3.0}};
+	v.sort_by<1>();
+	ASSERT_EQ(v, (students{{"Bob", 18, 3.9},
+						   {"Dave", 18, 4.8},
+						   {"Alice", 20, 4.5},
+						   {"Eve", 20, 3.0},
+						   {"Charlie", 22, 4.1}}));
+	v.sort_by<2>(std::greater<>{});
+	ASSERT_EQ(v.column<0>()[0], "Dave");
+	ASSERT_EQ(v.column<0>()[4], "Eve");
+	v.sort_by<0>();
+	ASSERT_EQ(v.column<1>()[2], 22);
+
+	bmstu::soa_vector<int, int> big;
+	for (int i = 0; i < 1000; ++i)
+	{
+		big.emplace_back((i * 7919) % 1000, i);
+	}
+	big.sort_by<0>();
+	for (int i = 0; i < 1000; ++i)
+	{
+		ASSERT_EQ(big.column<0>()[i], i);
+		ASSERT_EQ((big.column<1>()[i] * 7919) % 1000, i);
+	}
+}
+
+TEST(SoaVectorTest, CopyMove)
+{
+	students v{{"Alice", 20, 4.5}, {"Bob", 18, 3.9}};
+	students copy(v);
+	ASSERT_EQ(copy, v);
+	std::get<1>(copy[0]) = 21;
+	ASSERT_TRUE(copy != v);
+
+	students moved(std::move(copy));
+	ASSERT_TRUE(copy.empty());
+	ASSERT_EQ(std::get<1>(moved[0]), 21);
+	copy = moved;
+	ASSERT_EQ(copy, moved);
+	swap(v, moved);
+	ASSERT_EQ(std::get<1>(v[0]), 21);
+
+	int total = 0;
+	for (auto [name, age, score] : v)
+	{
+		total += age;
+	}
+	ASSERT_EQ(total, 39);
+}
+
+TEST(SoaVectorTest, GrowthCopyThrows)
+{
+	bmstu::soa_vector<std::string, FragileCopy> v;
+	v.reserve(4);
+	for (int i = 0; i < 4; ++i)
+	{
+		v.emplace_back(std::to_string(i), i);
+	}
+	FragileCopy::copies_left = 2;
+	// the FragileCopy column is copied before the strings are moved
+	ASSERT_THROW(v.reserve(8), std::runtime_error);
+	FragileCopy::copies_left = 1'000'000;
+	ASSERT_EQ(v.capacity(), 4u);
+	ASSERT_EQ(v.column<0>()[3], "3");
+	ASSERT_EQ(v.column<1>()[3].value, 3);
+	v.reserve(8);
+	ASSERT_EQ(v.column<0>()[0], "0");
+}
+
+TEST(SoaVectorTest, ThrowingCopyLeaksNothing)
+{
+	using fragile_rows = bmstu::soa_vector<std::string, FragileCopy>;
+	const int before = FragileCopy::alive;
+	{
+		fragile_rows v;
+		for (int i = 0; i < 10; ++i)
+		{
+			v.emplace_back(std::to_string(i), i);
+		}
+		FragileCopy::copies_left = 5;
+		ASSERT_THROW(fragile_rows copy(v), std::runtime_error);
+		ASSERT_EQ(FragileCopy::alive, before + 10);
+
+		FragileCopy::copies_left = 1;
+		ASSERT_THROW((fragile_rows{{"a", 1}, {"b", 2}, {"c", 3}}),
+					 std::runtime_error);
+		ASSERT_EQ(FragileCopy::alive, before + 10);
+		FragileCopy::copies_left = 1'000'000;
+	}
+	ASSERT_EQ(FragileCopy::alive, before);
+}
+
+namespace
+{
+struct Student
+{
+	std::string name;
+	int age;
+	double score;
+};
+
+[[gnu::noipa]] long long sum_ages(std::span<const int> ages)
+{
+	long long sum = 0;
+	for (int age : ages)
+	{
+		sum += age;
+	}
+	return sum;
+}
+
+[[gnu::noipa]] long long sum_ages(const bmstu::simple_vector<Student>& v)
+{
+	long long sum = 0;
+	for (const Student& student : v)
+	{
+		sum += student.age;
+	}
+	return sum;
+}
+
+using bmstu::bench::time_it;
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(SoaVectorBench, DISABLED_ScanOneField)
+{
+	constexpr int count = 4'000'000;
+	bmstu::simple_vector<Student> records;
+	students columns;
+	records.reserve(count);
+	columns.reserve(count);
+	for (int i = 0; i < count; ++i)
+	{
+		records.push_back({"student", 17 + i % 10, 4.0});
+		columns.emplace_back("student", 17 + i % 10, 4.0);
+	}
+	time_it("simple_vector<Student>, sum of age x 50",
+			[&] { return sum_ages(records); }, 50);
+	time_it("soa_vector<string, int, double>, sum of age x 50",
+			[&] { return sum_ages(columns.column<1>()); }, 50);
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include "bmstu_simple_vector.h"
+
+namespace bmstu
+{
+// Fixed set of threads for fork-join loops: run(count, func) calls
+// func(0) ... func(count - 1) spread over the workers and the calling
+// thread, and returns once all calls are done. Calls are handed out one
+// index at a time, so uneven tasks balance themselves.
+class thread_pool
+{
+   public:
+	// threads counts the caller too, so threads - 1 workers are started
+	explicit thread_pool(size_t threads = default_threads())
+	{
+		try
+		{
+			for (size_t i = 1; i < threads; ++i)
+			{
+				workers_.push_back(std::thread([this] { worker_loop(); }));
+			}
+		}
+		catch (...)
+		{
+			stop();
+			throw;
+		}
+	}
+
+	thread_pool(const thread_pool& other) = delete;
+
+	thread_pool& operator=(const thread_pool& other) = delete;
+
+	~thread_pool() { stop(); }
+
+	// Threads that take part in run(), the caller included
+	size_t size() const noexcept { return workers_.size() + 1; }
+
+	// Rethrows the first exception thrown by func once every call has
+	// finished. Must not be called from inside func.
+	template <typename Func>
+	void run(size_t count, Func&& func)
+	{
+		if (workers_.empty() || count <= 1)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				func(i);
+			}
+			return;
+		}
+		std::lock_guard run_lock(run_mutex_);
+		{
+			std::lock_guard lock(mutex_);
+			task_ = [](void* context, size_t index)
+			{ (*static_cast<std::remove_reference_t<Func>*>(context))(index); };
+			context_ = const_cast<void*>(
+				static_cast<const void*>(std::addressof(func)));
+			count_ = count;
+			next_.store(0, std::memory_order_relaxed);
+			active_ = workers_.size();
+			error_ = nullptr;
+			++generation_;
+		}
+		wake_.notify_all();
+		work();
+		std::unique_lock lock(mutex_);
+		done_.wait(lock, [this] { return active_ == 0; });
+		if (error_)
+		{
+			std::rethrow_exception(error_);
+		}
+	}
+
+	// Shared pool with one thread per hardware thread
+	static thread_pool& shared()
+	{
+		static thread_pool pool;
+		return pool;
+	}
+
+   private:
+	static size_t default_threads() noexcept
+	{
+		return std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	void stop() noexcept
+	{
+		{
+			std::lock_guard lock(mutex_);
+			stop_ = true;
+		}
+		wake_.notify_all();
+		for (std::thread& worker : workers_)
+		{
+			worker.join();
+		}
+	}
+
+	void work()
+	{
+		for (size_t i = next_.fetch_add(1, std::memory_order_relaxed);
+			 i < count_; i = next_.fetch_add(1, std::memory_order_relaxed))
+		{
+			try
+			{
+				task_(context_, i);
+			}
+			catch (...)
+			{
+				std::lock_guard lock(mutex_);
+				if (!error_)
+				{
+					error_ = std::current_exception();
+				}
+			}
+		}
+	}
+
+	void worker_loop()
+	{
+		uint64_t seen = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock lock(mutex_);
+				wake_.wait(lock,
+						   [&] { return stop_ || generation_ != seen; });
+				if (stop_)
+				{
+					return;
+				}
+				seen = generation_;
+			}
+			work();
+			std::lock_guard lock(mutex_);
+			if (--active_ == 0)
+			{
+				done_.notify_one();
+			}
+		}
+	}
+
+	simple_vector<std::thread> workers_;
+	std::mutex run_mutex_;
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable done_;
+	// the current job, set under mutex_ before generation_ moves on
+	void (*task_)(void*, size_t) = nullptr;
+	void* context_ = nullptr;
+	size_t count_ = 0;
+	std::atomic<size_t> next_ = 0;
+	size_t active_ = 0;
+	uint64_t generation_ = 0;
+	bool stop_ = false;
+	std::exception_ptr error_;
+};
+}  // namespace bmstu
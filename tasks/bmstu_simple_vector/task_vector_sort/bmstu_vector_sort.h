@@ -0,0 +1,339 @@
+#pragma once
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "array_ptr.h"
+#include "bmstu_simple_vector.h"
+#include "bmstu_thread_pool.h"
+
+// Parallel sorts for simple_vector.
+//
+// sort(v, comp) is a merge sort: the vector is cut into one run per pool
+// thread, the runs are sorted with std::sort in parallel and then merged
+// pairwise. Every merge is split by merge path (a binary search for where
+// the k-th output element comes from), so each round keeps all threads
+// busy, the last one included.
+//
+// radix_sort(v, key) is an LSD radix sort on 8-bit digits of an integral
+// key, stable. Each pass has every thread count digits in its own block,
+// turns the per-thread counts into write offsets and scatters its block.
+// A pass where every key has the same digit is skipped.
+//
+// Both move elements through a second buffer of size() elements.
+namespace bmstu
+{
+namespace
+{
+// Below this a single std::sort beats splitting the work
+constexpr size_t parallel_sort_threshold = 1 << 14;
+
+// Elements [first, last) of the sorted runs are copied to out
+struct merge_task
+{
+	size_t first1;
+	size_t last1;
+	size_t first2;
+	size_t last2;
+	size_t out;
+};
+
+// How many of the first k merged elements come from a[0, na); ties go to
+// a first, like std::merge
+template <typename T, typename Compare>
+size_t merge_path(const T* a, size_t na, const T* b, size_t nb, size_t k,
+				  Compare& comp)
+{
+	size_t low = k > nb ? k - nb : 0;
+	size_t high = std::min(k, na);
+	while (low < high)
+	{
+		const size_t mid = low + (high - low) / 2;
+		if (comp(b[k - mid - 1], a[mid]))
+		{
+			high = mid;
+		}
+		else
+		{
+			low = mid + 1;
+		}
+	}
+	return low;
+}
+
+// Runs [bounds[i], bounds[i + 1]) of data are sorted; merges them
+// pairwise until one is left, moving elements between data and buffer.
+// Returns the one of the two that holds the result.
+template <typename T, typename Compare>
+T* merge_runs(T* data, T* buffer, simple_vector<size_t> bounds, size_t n,
+			  Compare& comp, thread_pool& pool)
+{
+	T* src = data;
+	T* dst = buffer;
+	while (bounds.size() > 2)
+	{
+		simple_vector<merge_task> tasks;
+		simple_vector<size_t> merged;
+		for (size_t run = 0; run + 1 < bounds.size(); run += 2)
+		{
+			const size_t first1 = bounds[run];
+			const size_t last1 = bounds[run + 1];
+			// an odd run out is moved over as a merge with nothing
+			const size_t last2 =
+				run + 2 < bounds.size() ? bounds[run + 2] : last1;
+			const size_t length = last2 - first1;
+			const size_t pieces =
+				std::max<size_t>(1, (pool.size() * length + n - 1) / n);
+			size_t from_a = 0;
+			for (size_t piece = 1; piece <= pieces; ++piece)
+			{
+				const size_t k = length * piece / pieces;
+				const size_t to_a =
+					merge_path(src + first1, last1 - first1, src + last1,
+							   last2 - last1, k, comp);
+				const size_t k_prev = length * (piece - 1) / pieces;
+				tasks.push_back(merge_task{
+					first1 + from_a, first1 + to_a, last1 + (k_prev - from_a),
+					last1 + (k - to_a), first1 + k_prev});
+				from_a = to_a;
+			}
+			merged.push_back(first1);
+		}
+		merged.push_back(n);
+		pool.run(tasks.size(),
+				 [&](size_t i)
+				 {
+					 const merge_task& task = tasks[i];
+					 std::merge(std::make_move_iterator(src + task.first1),
+								std::make_move_iterator(src + task.last1),
+								std::make_move_iterator(src + task.first2),
+								std::make_move_iterator(src + task.last2),
+								dst + task.out, comp);
+				 });
+		bounds = std::move(merged);
+		std::swap(src, dst);
+	}
+	return src;
+}
+
+// Moves from[0, n) over to[0, n), a slice per pool thread
+template <typename T>
+void parallel_move(T* from, T* to, size_t n, thread_pool& pool)
+{
+	pool.run(pool.size(),
+			 [&](size_t i)
+			 {
+				 const size_t first = n * i / pool.size();
+				 const size_t last = n * (i + 1) / pool.size();
+				 std::move(from + first, from + last, to + first);
+			 });
+}
+
+// Raw storage for n elements that are move-constructed from data on
+// creation and destroyed with the buffer
+template <typename T>
+class sort_buffer
+{
+   public:
+	sort_buffer(T* data, size_t n, thread_pool& pool) : storage_(n), n_(n)
+	{
+		if constexpr (!std::is_trivially_copyable_v<T>)
+		{
+			pool.run(pool.size(),
+					 [&](size_t i)
+					 {
+						 const size_t first = n * i / pool.size();
+						 const size_t last = n * (i + 1) / pool.size();
+						 std::uninitialized_move(data + first, data + last,
+												 storage_.get() + first);
+					 });
+		}
+	}
+
+	sort_buffer(const sort_buffer& other) = delete;
+
+	sort_buffer& operator=(const sort_buffer& other) = delete;
+
+	~sort_buffer()
+	{
+		if constexpr (!std::is_trivially_copyable_v<T>)
+		{
+			std::destroy_n(storage_.get(), n_);
+		}
+	}
+
+	T* get() const noexcept { return storage_.get(); }
+
+   private:
+	array_ptr<T> storage_;
+	size_t n_;
+};
+
+// Radix digits of a key, with the sign bit flipped so that signed keys
+// order like unsigned ones
+template <typename Key>
+auto radix_bits(Key key) noexcept
+{
+	using U = std::make_unsigned_t<Key>;
+	U bits = static_cast<U>(key);
+	if constexpr (std::is_signed_v<Key>)
+	{
+		bits ^= U{1} << (std::numeric_limits<U>::digits - 1);
+	}
+	return bits;
+}
+}  // namespace
+
+template <typename T, typename Growth, typename Allocator, typename Compare>
+	requires std::strict_weak_order<Compare&, const T&, const T&>
+void sort(simple_vector<T, Growth, Allocator>& vec,
+		  Compare comp,
+		  thread_pool& pool = thread_pool::shared())
+{
+	T* data = vec.data();
+	const size_t n = vec.size();
+	if (n < parallel_sort_threshold || pool.size() == 1)
+	{
+		std::sort(data, data + n, comp);
+		return;
+	}
+	simple_vector<size_t> bounds;
+	for (size_t i = 0; i <= pool.size(); ++i)
+	{
+		bounds.push_back(n * i / pool.size());
+	}
+	pool.run(pool.size(),
+			 [&](size_t i)
+			 { std::sort(data + bounds[i], data + bounds[i + 1], comp); });
+	sort_buffer<T> buffer(data, n, pool);
+	T* runs = data;
+	T* scratch = buffer.get();
+	if constexpr (!std::is_trivially_copyable_v<T>)
+	{
+		// the sorted runs were moved into the buffer
+		std::swap(runs, scratch);
+	}
+	T* result = merge_runs(runs, scratch, std::move(bounds), n, comp, pool);
+	if (result != data)
+	{
+		parallel_move(result, data, n, pool);
+	}
+}
+
+template <typename T, typename Key>
+using radix_key_t = std::remove_cvref_t<std::invoke_result_t<Key&, const T&>>;
+
+// Stable LSD radix sort by key(element), which must be integral
+template <typename T, typename Growth, typename Allocator, typename Key>
+	requires(std::integral<radix_key_t<T, Key>> &&
+			 !std::same_as<radix_key_t<T, Key>, bool>)
+void radix_sort(simple_vector<T, Growth, Allocator>& vec,
+				Key key,
+				thread_pool& pool = thread_pool::shared())
+{
+	using key_type = radix_key_t<T, Key>;
+	constexpr size_t digits = sizeof(key_type);
+	constexpr size_t radix = 256;
+	const size_t n = vec.size();
+	if (n < 2)
+	{
+		return;
+	}
+	const auto digit = [&](const T& value, size_t pass)
+	{
+		return static_cast<size_t>(
+			(radix_bits(std::invoke(key, value)) >> (pass * 8)) & 0xFF);
+	};
+	// small inputs don't pay for the passes and the buffer
+	if (n < 64)
+	{
+		std::stable_sort(vec.begin(), vec.end(),
+						 [&](const T& lhs, const T& rhs)
+						 {
+							 return radix_bits(std::invoke(key, lhs)) <
+									radix_bits(std::invoke(key, rhs));
+						 });
+		return;
+	}
+
+	const size_t blocks = n < parallel_sort_threshold ? 1 : pool.size();
+	simple_vector<size_t> counts(blocks * radix);
+	sort_buffer<T> buffer(vec.data(), n, pool);
+	T* src = vec.data();
+	T* dst = buffer.get();
+	if constexpr (!std::is_trivially_copyable_v<T>)
+	{
+		// the elements now live in the buffer
+		std::swap(src, dst);
+	}
+	for (size_t pass = 0; pass < digits; ++pass)
+	{
+		std::fill(counts.begin(), counts.end(), size_t{0});
+		pool.run(blocks,
+				 [&](size_t block)
+				 {
+					 size_t* count = counts.data() + block * radix;
+					 const size_t last = n * (block + 1) / blocks;
+					 for (size_t i = n * block / blocks; i < last; ++i)
+					 {
+						 ++count[digit(src[i], pass)];
+					 }
+				 });
+		// turn counts into offsets: digit-major, then block order
+		size_t offset = 0;
+		bool one_digit = false;
+		for (size_t d = 0; d < radix; ++d)
+		{
+			size_t total = 0;
+			for (size_t block = 0; block < blocks; ++block)
+			{
+				size_t& count = counts[block * radix + d];
+				total += count;
+				count = offset + total - count;
+			}
+			one_digit = one_digit || total == n;
+			offset += total;
+		}
+		if (one_digit)
+		{
+			continue;
+		}
+		pool.run(blocks,
+				 [&](size_t block)
+				 {
+					 size_t* next = counts.data() + block * radix;
+					 const size_t last = n * (block + 1) / blocks;
+					 for (size_t i = n * block / blocks; i < last; ++i)
+					 {
+						 dst[next[digit(src[i], pass)]++] = std::move(src[i]);
+					 }
+				 });
+		std::swap(src, dst);
+	}
+	if (src != vec.data())
+	{
+		parallel_move(src, vec.data(), n, pool);
+	}
+}
+
+// Integers go through radix_sort, anything else through the merge sort
+template <typename T, typename Growth, typename Allocator>
+void sort(simple_vector<T, Growth, Allocator>& vec,
+		  thread_pool& pool = thread_pool::shared())
+{
+	if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+	{
+		radix_sort(vec, std::identity{}, pool);
+	}
+	else
+	{
+		sort(vec, std::less<>{}, pool);
+	}
+}
+}  // namespace bmstu
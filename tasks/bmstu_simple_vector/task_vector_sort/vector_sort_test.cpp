@@ -0,0 +1,222 @@
+#include "bmstu_vector_sort.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "bmstu_bench.h"
+#include "bmstu_simple_vector.h"
+#include "bmstu_thread_pool.h"
+
+namespace
+{
+using bmstu::bench::next_random;
+
+template <typename T>
+bmstu::simple_vector<T> random_vector(size_t n, uint64_t seed = 1)
+{
+	bmstu::simple_vector<T> v;
+	v.reserve(n);
+	uint64_t state = 88172645463325252ull + seed;
+	for (size_t i = 0; i < n; ++i)
+	{
+		v.push_back(static_cast<T>(next_random(state)));
+	}
+	return v;
+}
+
+struct Record
+{
+	uint64_t key;
+	uint32_t order;
+	uint32_t payload[3];
+};
+}  // namespace
+
+TEST(ThreadPoolTest, RunsEveryIndexOnce)
+{
+	bmstu::thread_pool pool(4);
+	ASSERT_EQ(pool.size(), 4u);
+	std::vector<std::atomic<int>> hits(1000);
+	for (int round = 0; round < 3; ++round)
+	{
+		pool.run(hits.size(), [&](size_t i) { ++hits[i]; });
+	}
+	for (const std::atomic<int>& hit : hits)
+	{
+		ASSERT_EQ(hit.load(), 3);
+	}
+	ASSERT_THROW(pool.run(100,
+						  [](size_t i)
+						  {
+							  if (i == 42)
+							  {
+								  throw std::runtime_error("task failed");
+							  }
+						  }),
+				 std::runtime_error);
+	std::atomic<size_t> sum = 0;
+	pool.run(10, [&](size_t i) { sum += i; });
+	ASSERT_EQ(sum.load(), 45u);
+
+	bmstu::thread_pool single(1);
+	size_t calls = 0;
+	single.run(5, [&](size_t) { ++calls; });
+	ASSERT_EQ(calls, 5u);
+}
+
+TEST(VectorSortTest, MergeSortMatchesStdSort)
+{
+	bmstu::thread_pool pool(4);
+	for (size_t n : {0u, 1u, 1000u, 100'003u})
+	{
+		auto v = random_vector<int>(n);
+		std::vector<int> expected(v.begin(), v.end());
+		std::sort(expected.begin(), expected.end(), std::greater<>{});
+		bmstu::sort(v, std::greater<>{}, pool);
+		ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin(),
+							   expected.end()));
+	}
+
+	// odd number of runs, and elements that aren't trivially copyable
+	bmstu::thread_pool three(3);
+	bmstu::simple_vector<std::string> words;
+	uint64_t state = 7;
+	for (int i = 0; i < 50'000; ++i)
+	{
+		words.push_back(std::to_string(next_random(state) % 100'000));
+	}
+	std::vector<std::string> expected(words.begin(), words.end());
+	std::sort(expected.begin(), expected.end());
+	bmstu::sort(words, three);
+	ASSERT_TRUE(std::equal(words.begin(), words.end(), expected.begin(),
+						   expected.end()));
+}
+
+TEST(VectorSortTest, RadixSortIntegers)
+{
+	bmstu::thread_pool pool(4);
+	for (size_t n : {10u, 1000u, 100'000u})
+	{
+		auto v = random_vector<int32_t>(n);
+		v[0] = std::numeric_limits<int32_t>::min();
+		v[1] = std::numeric_limits<int32_t>::max();
+		v[2] = -1;
+		std::vector<int32_t> expected(v.begin(), v.end());
+		std::sort(expected.begin(), expected.end());
+		bmstu::sort(v, pool);
+		ASSERT_TRUE(std::equal(v.begin(), v.end(), expected.begin(),
+							   expected.end()));
+	}
+
+	auto bytes = random_vector<uint8_t>(70'000);
+	std::vector<uint8_t> expected_bytes(bytes.begin(), bytes.end());
+	std::sort(expected_bytes.begin(), expected_bytes.end());
+	bmstu::radix_sort(bytes, std::identity{}, pool);
+	ASSERT_TRUE(std::equal(bytes.begin(), bytes.end(), expected_bytes.begin(),
+						   expected_bytes.end()));
+
+	// only the low digit differs, the other passes are skipped
+	auto small = random_vector<int64_t>(5000);
+	for (int64_t& value : small)
+	{
+		value = value & 0xFF;
+	}
+	bmstu::sort(small);
+	ASSERT_TRUE(std::is_sorted(small.begin(), small.end()));
+}
+
+TEST(VectorSortTest, RadixSortByKeyIsStable)
+{
+	bmstu::thread_pool pool(4);
+	bmstu::simple_vector<Record> records;
+	uint64_t state = 3;
+	for (uint32_t i = 0; i < 100'000; ++i)
+	{
+		records.push_back(Record{next_random(state) % 1000, i, {i, i, i}});
+	}
+	bmstu::radix_sort(records, &Record::key, pool);
+	for (size_t i = 1; i < records.size(); ++i)
+	{
+		ASSERT_LE(records[i - 1].key, records[i].key);
+		if (records[i - 1].key == records[i].key)
+		{
+			ASSERT_LT(records[i - 1].order, records[i].order);
+		}
+		ASSERT_EQ(records[i].payload[2], records[i].order);
+	}
+
+	bmstu::simple_vector<std::string> words{"ccc", "a", "bb", "dd", "e"};
+	bmstu::radix_sort(words, [](const std::string& s) { return s.size(); });
+	ASSERT_EQ(words, (bmstu::simple_vector<std::string>{"a", "e", "bb", "dd",
+														 "ccc"}));
+}
+
+namespace
+{
+template <typename Func>
+void time_it(const char* name, size_t threads, Func func)
+{
+	bmstu::bench::time_it(
+		std::string(name) + ", " + std::to_string(threads) + " threads", func);
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(VectorSortBench, DISABLED_Sort100M)
+{
+	constexpr size_t n = 100'000'000;
+	std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+			  << std::endl;
+	{
+		auto v = random_vector<uint32_t>(n);
+		time_it("std::sort 100M uint32", 1,
+				[&] { std::sort(v.begin(), v.end()); });
+	}
+	for (size_t threads : {1, 2, 4, 8})
+	{
+		bmstu::thread_pool pool(threads);
+		auto v = random_vector<uint32_t>(n);
+		time_it("bmstu::sort (radix) 100M uint32", threads,
+				[&] { bmstu::sort(v, pool); });
+		v = random_vector<uint32_t>(n);
+		time_it("bmstu::sort (merge) 100M uint32", threads,
+				[&] { bmstu::sort(v, std::less<>{}, pool); });
+	}
+
+	constexpr size_t record_count = 20'000'000;
+	const auto make_records = [&]
+	{
+		bmstu::simple_vector<Record> records;
+		records.reserve(record_count);
+		uint64_t state = 5;
+		for (uint32_t i = 0; i < record_count; ++i)
+		{
+			records.push_back(Record{next_random(state), i, {i, i, i}});
+		}
+		return records;
+	};
+	const auto by_key = [](const Record& lhs, const Record& rhs)
+	{ return lhs.key < rhs.key; };
+	{
+		auto records = make_records();
+		time_it("std::sort 20M 24-byte records", 1,
+				[&] { std::sort(records.begin(), records.end(), by_key); });
+	}
+	for (size_t threads : {1, 2, 4, 8})
+	{
+		bmstu::thread_pool pool(threads);
+		auto records = make_records();
+		time_it("bmstu::radix_sort 20M 24-byte records", threads,
+				[&] { bmstu::radix_sort(records, &Record::key, pool); });
+		records = make_records();
+		time_it("bmstu::sort (merge) 20M 24-byte records", threads,
+				[&] { bmstu::sort(records, by_key, pool); });
+	}
+}
@@ -15,6 +15,7 @@ private:
     size_t size_ = 0;
     size_t capacity_ = 0;
 
+public:
     void reserve(size_t new_capacity) {
         if (new_capacity <= capacity_) return;
         
@@ -30,7 +31,6 @@ private:
         capacity_ = new_capacity;
     }
 
-public:
     stack() = default;
     
     ~stack() {
@@ -91,6 +91,9 @@ public:
     
     bool empty() const { return size_ == 0; }
     size_t size() const { return size_; }
+
+    // Elements from the bottom of the stack to the top
+    const T* data() const noexcept { return data_; }
     
     void clear() {
         for (size_t i = 0; i < size_; ++i) data_[i].~T();
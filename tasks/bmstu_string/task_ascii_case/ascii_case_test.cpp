@@ -0,0 +1,304 @@
+#include "bmstu_ascii_case.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bmstu_sso_string.h"
+
+namespace
+{
+std::string scalar_lower(std::string str)
+{
+	for (auto& ch : str)
+	{
+		ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+	}
+	return str;
+}
+
+std::string scalar_upper(std::string str)
+{
+	for (auto& ch : str)
+	{
+		ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+	}
+	return str;
+}
+
+int sign(int value) { return (value > 0) - (value < 0); }
+
+int scalar_icompare(const std::string& lhs, const std::string& rhs)
+{
+	// char_traits<char> compares as unsigned char, like the kernels do
+	return sign(scalar_lower(lhs).compare(scalar_lower(rhs)));
+}
+}  // namespace
+
+TEST(AsciiCaseTest, LowerUpperShort)
+{
+	std::string str = "Content-Type";
+	bmstu::to_lower(str.data(), str.size());
+	ASSERT_EQ(str, "content-type");
+	bmstu::to_upper(str.data(), str.size());
+	ASSERT_EQ(str, "CONTENT-TYPE");
+}
+
+TEST(AsciiCaseTest, MatchesScalarOnAllLengths)
+{
+	std::string pattern;
+	for (int ch = 1; ch < 128; ++ch)
+	{
+		pattern += static_cast<char>(ch);
+	}
+	for (size_t size = 0; size <= pattern.size(); ++size)
+	{
+		std::string lower = pattern.substr(0, size);
+		std::string upper = lower;
+		bmstu::to_lower(lower.data(), lower.size());
+		bmstu::to_upper(upper.data(), upper.size());
+		ASSERT_EQ(lower, scalar_lower(pattern.substr(0, size)));
+		ASSERT_EQ(upper, scalar_upper(pattern.substr(0, size)));
+	}
+}
+
+TEST(AsciiCaseTest, NonAsciiFallback)
+{
+	std::string str =
+		"HeLLo-\xD0\x9F\xD0\xA0\xD0\x98-WORLD-1234567890-ABCDEFGHIJ";
+	std::string expected = scalar_lower(str);
+	bmstu::to_lower(str.data(), str.size());
+	ASSERT_EQ(str, expected);
+	ASSERT_NE(str.find("\xD0\x9F"), std::string::npos);
+}
+
+TEST(AsciiCaseTest, IEquals)
+{
+	const std::string a = "ACCEPT-ENCODING";
+	const std::string b = "Accept-Encoding";
+	ASSERT_TRUE(bmstu::iequals(a.data(), a.size(), b.data(), b.size()));
+	ASSERT_FALSE(bmstu::iequals(a.data(), a.size(), b.data(), b.size() - 1));
+	const std::string c = "Accept-Encodinh";
+	ASSERT_FALSE(bmstu::iequals(a.data(), a.size(), c.data(), c.size()));
+	// '@' and '`' differ from 'A' and 'a' only in bit 0x20 too
+	ASSERT_FALSE(bmstu::iequals("@", 1, "`", 1));
+	ASSERT_FALSE(bmstu::iequals("[", 1, "{", 1));
+}
+
+TEST(AsciiCaseTest, IEqualsLongWithMismatchEverywhere)
+{
+	std::string a(200, 'x');
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		a[i] = static_cast<char>('a' + i % 26);
+	}
+	std::string b = scalar_upper(a);
+	ASSERT_TRUE(bmstu::iequals(a.data(), a.size(), b.data(), b.size()));
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		std::string c = b;
+		c[i] = '#';
+		ASSERT_FALSE(bmstu::iequals(a.data(), a.size(), c.data(), c.size()));
+		ASSERT_EQ(
+			sign(bmstu::icompare(a.data(), a.size(), c.data(), c.size())),
+			scalar_icompare(a, c));
+	}
+}
+
+TEST(AsciiCaseTest, ICompare)
+{
+	auto cmp = [](const std::string& a, const std::string& b)
+	{ return sign(bmstu::icompare(a.data(), a.size(), b.data(), b.size())); };
+	ASSERT_EQ(cmp("host", "HOST"), 0);
+	ASSERT_EQ(cmp("Host", "hosts"), -1);
+	ASSERT_EQ(cmp("Hosts", "host"), 1);
+	ASSERT_EQ(cmp("abc", "ABD"), -1);
+	ASSERT_EQ(cmp("", ""), 0);
+	ASSERT_EQ(cmp("a", ""), 1);
+	// ordering is defined on lower-cased characters, so '_' < 'b'
+	ASSERT_EQ(cmp("A_", "aB"), scalar_icompare("A_", "aB"));
+	ASSERT_EQ(cmp("\xC3\xA9", "e"), 1);
+}
+
+TEST(AsciiCaseTest, WideStrings)
+{
+	std::wstring str = L"Content-LENGTH";
+	bmstu::to_lower(str.data(), str.size());
+	ASSERT_EQ(str, L"content-length");
+	ASSERT_TRUE(bmstu::iequals(L"ETag", 4, L"ETAG", 4));
+}
+
+TEST(AsciiCaseTest, SSOStringMembers)
+{
+	bmstu::string short_str("X-Forwarded-For");
+	bmstu::string long_str("Strict-Transport-Security: Max-Age=31536000");
+	short_str.to_lower();
+	long_str.to_upper();
+	ASSERT_STREQ(short_str.c_str(), "x-forwarded-for");
+	ASSERT_STREQ(long_str.c_str(),
+				 "STRICT-TRANSPORT-SECURITY: MAX-AGE=31536000");
+
+	ASSERT_TRUE(iequals(bmstu::string("Accept"), bmstu::string("ACCEPT")));
+	ASSERT_FALSE(iequals(bmstu::string("Accept"), bmstu::string("Accepts")));
+	ASSERT_EQ(icompare(bmstu::string("accept"), bmstu::string("ACCEPT")), 0);
+	ASSERT_LT(icompare(bmstu::string("Accept"), bmstu::string("Allow")), 0);
+	ASSERT_GT(icompare(bmstu::string("Via"), bmstu::string("Age")), 0);
+
+	bmstu::wstring wide(L"Keep-Alive");
+	wide.to_upper();
+	ASSERT_STREQ(wide.c_str(), L"KEEP-ALIVE");
+}
+
+namespace
+{
+const std::vector<std::string>& header_names()
+{
+	static const std::vector<std::string> names = {
+		"Host",
+		"Accept",
+		"Content-Type",
+		"Content-Length",
+		"Accept-Encoding",
+		"Accept-Language",
+		"If-Modified-Since",
+		"X-Forwarded-For",
+		"Access-Control-Allow-Origin",
+		"Strict-Transport-Security",
+		"Access-Control-Allow-Credentials-And-Some-Long-Vendor-Suffix",
+	};
+	return names;
+}
+
+template <typename Func>
+void time_it(const char* name, Func func)
+{
+	auto start = std::chrono::steady_clock::now();
+	size_t checksum = func();
+	auto elapsed = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start);
+	std::cout << name << ": " << elapsed.count() << " ms (checksum "
+			  << checksum << ")" << std::endl;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(AsciiCaseBench, DISABLED_HeaderNames)
+{
+	std::vector<std::string> headers;
+	for (int i = 0; i < 100000; ++i)
+	{
+		headers.push_back(header_names()[i % header_names().size()]);
+	}
+
+	time_it("to_lower (kernel)",
+			[&]
+			{
+				size_t sum = 0;
+				for (int round = 0; round < 20; ++round)
+				{
+					for (auto& header : headers)
+					{
+						bmstu::to_lower(header.data(), header.size());
+						sum += static_cast<unsigned char>(header[0]);
+					}
+				}
+				return sum;
+			});
+	time_it("to_lower (std::tolower)",
+			[&]
+			{
+				size_t sum = 0;
+				for (int round = 0; round < 20; ++round)
+				{
+					for (auto& header : headers)
+					{
+						for (auto& ch : header)
+						{
+							ch = static_cast<char>(
+								std::tolower(static_cast<unsigned char>(ch)));
+						}
+						sum += static_cast<unsigned char>(header[0]);
+					}
+				}
+				return sum;
+			});
+
+	std::vector<std::string> upper = headers;
+	for (auto& header : upper)
+	{
+		header = scalar_upper(header);
+	}
+	time_it("iequals (kernel)",
+			[&]
+			{
+				size_t sum = 0;
+				for (int round = 0; round < 20; ++round)
+				{
+					for (size_t i = 0; i < headers.size(); ++i)
+					{
+						sum += bmstu::iequals(
+							headers[i].data(), headers[i].size(),
+							upper[i].data(), upper[i].size());
+					}
+				}
+				return sum;
+			});
+	time_it("iequals (std::tolower)",
+			[&]
+			{
+				size_t sum = 0;
+				for (int round = 0; round < 20; ++round)
+				{
+					for (size_t i = 0; i < headers.size(); ++i)
+					{
+						sum += std::equal(
+							headers[i].begin(), headers[i].end(),
+							upper[i].begin(), upper[i].end(),
+							[](char a, char b)
+							{
+								return std::tolower(
+										   static_cast<unsigned char>(a)) ==
+									   std::tolower(
+										   static_cast<unsigned char>(b));
+							});
+					}
+				}
+				return sum;
+			});
+}
+
+TEST(AsciiCaseBench, DISABLED_LongBody)
+{
+	std::string body(64 << 20, 'a');
+	for (size_t i = 0; i < body.size(); ++i)
+	{
+		body[i] = static_cast<char>(' ' + i % 95);
+	}
+	std::string other = scalar_upper(body);
+
+	time_it("to_lower 64 MB (kernel)",
+			[&]
+			{
+				bmstu::to_lower(body.data(), body.size());
+				return static_cast<size_t>(body[body.size() / 2]);
+			});
+	time_it("to_lower 64 MB (std::tolower)",
+			[&]
+			{
+				for (auto& ch : body)
+				{
+					ch = static_cast<char>(
+						std::tolower(static_cast<unsigned char>(ch)));
+				}
+				return static_cast<size_t>(body[body.size() / 2]);
+			});
+	time_it("iequals 64 MB (kernel)",
+			[&]
+			{
+				return static_cast<size_t>(bmstu::iequals(
+					body.data(), body.size(), other.data(), other.size()));
+			});
+}
@@ -0,0 +1,319 @@
+#pragma once
+#include <bit>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cwctype>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// ASCII case folding kernels shared by simple_basic_string and basic_string.
+// Blocks of pure ASCII are folded 32/16 bytes at a time (AVX2/SSE2) or
+// 8 bytes at a time (SWAR). A block that contains a byte >= 0x80 goes through
+// the scalar path, which defers to std::tolower/std::toupper and therefore
+// respects single-byte locales.
+namespace bmstu
+{
+namespace
+{
+constexpr uint64_t swar_ones = 0x0101010101010101ull;
+constexpr uint64_t swar_high = 0x8080808080808080ull;
+
+template <typename T>
+T fold_lower(T ch)
+{
+	using U = std::make_unsigned_t<T>;
+	const U code = static_cast<U>(ch);
+	if (code < 0x80)
+	{
+		return static_cast<U>(code - 'A') < 26u ? static_cast<T>(code | 0x20)
+												: ch;
+	}
+	if constexpr (std::is_same_v<T, char>)
+	{
+		return static_cast<char>(std::tolower(code));
+	}
+	else if constexpr (std::is_same_v<T, wchar_t>)
+	{
+		return static_cast<wchar_t>(std::towlower(static_cast<wint_t>(ch)));
+	}
+	else
+	{
+		return ch;
+	}
+}
+
+template <typename T>
+T fold_upper(T ch)
+{
+	using U = std::make_unsigned_t<T>;
+	const U code = static_cast<U>(ch);
+	if (code < 0x80)
+	{
+		return static_cast<U>(code - 'a') < 26u ? static_cast<T>(code & ~0x20)
+												: ch;
+	}
+	if constexpr (std::is_same_v<T, char>)
+	{
+		return static_cast<char>(std::toupper(code));
+	}
+	else if constexpr (std::is_same_v<T, wchar_t>)
+	{
+		return static_cast<wchar_t>(std::towupper(static_cast<wint_t>(ch)));
+	}
+	else
+	{
+		return ch;
+	}
+}
+
+// Flips bit 0x20 of every byte in [first, first + 25], x must be pure ASCII
+inline uint64_t swar_flip_range(uint64_t x, unsigned char first)
+{
+	const uint64_t ge_first = x + swar_ones * (0x80 - first);
+	const uint64_t gt_last = x + swar_ones * (0x80 - first - 26);
+	return x ^ (((ge_first ^ gt_last) & swar_high) >> 2);
+}
+
+inline uint64_t swar_lower(uint64_t x) { return swar_flip_range(x, 'A'); }
+
+inline uint64_t swar_upper(uint64_t x) { return swar_flip_range(x, 'a'); }
+
+inline uint64_t load_u64(const char* ptr)
+{
+	uint64_t x;
+	std::memcpy(&x, ptr, sizeof(x));
+	return x;
+}
+
+inline void store_u64(char* ptr, uint64_t x)
+{
+	std::memcpy(ptr, &x, sizeof(x));
+}
+
+#if defined(__SSE2__)
+inline __m128i sse_flip_range(__m128i x, char first)
+{
+	const __m128i ge_first = _mm_cmpgt_epi8(x, _mm_set1_epi8(first - 1));
+	const __m128i le_last = _mm_cmplt_epi8(x, _mm_set1_epi8(first + 26));
+	return _mm_xor_si128(x, _mm_and_si128(_mm_and_si128(ge_first, le_last),
+										  _mm_set1_epi8(0x20)));
+}
+#endif
+
+#if defined(__AVX2__)
+inline __m256i avx_flip_range(__m256i x, char first)
+{
+	const __m256i ge_first = _mm256_cmpgt_epi8(x, _mm256_set1_epi8(first - 1));
+	const __m256i le_last = _mm256_cmpgt_epi8(_mm256_set1_epi8(first + 26), x);
+	return _mm256_xor_si256(
+		x, _mm256_and_si256(_mm256_and_si256(ge_first, le_last),
+							_mm256_set1_epi8(0x20)));
+}
+#endif
+
+// first is 'A' for lower-casing and 'a' for upper-casing
+template <bool Lower>
+void fold_chars(char* data, size_t size)
+{
+	constexpr char first = Lower ? 'A' : 'a';
+	size_t i = 0;
+#if defined(__AVX2__)
+	for (; i + 32 <= size; i += 32)
+	{
+		auto* ptr = reinterpret_cast<__m256i*>(data + i);
+		const __m256i x = _mm256_loadu_si256(ptr);
+		if (_mm256_movemask_epi8(x) != 0)
+		{
+			for (size_t j = i; j < i + 32; ++j)
+			{
+				data[j] = Lower ? fold_lower(data[j]) : fold_upper(data[j]);
+			}
+			continue;
+		}
+		_mm256_storeu_si256(ptr, avx_flip_range(x, first));
+	}
+#endif
+#if defined(__SSE2__)
+	for (; i + 16 <= size; i += 16)
+	{
+		auto* ptr = reinterpret_cast<__m128i*>(data + i);
+		const __m128i x = _mm_loadu_si128(ptr);
+		if (_mm_movemask_epi8(x) != 0)
+		{
+			for (size_t j = i; j < i + 16; ++j)
+			{
+				data[j] = Lower ? fold_lower(data[j]) : fold_upper(data[j]);
+			}
+			continue;
+		}
+		_mm_storeu_si128(ptr, sse_flip_range(x, first));
+	}
+#endif
+	for (; i + 8 <= size; i += 8)
+	{
+		const uint64_t x = load_u64(data + i);
+		if ((x & swar_high) != 0)
+		{
+			for (size_t j = i; j < i + 8; ++j)
+			{
+				data[j] = Lower ? fold_lower(data[j]) : fold_upper(data[j]);
+			}
+			continue;
+		}
+		store_u64(data + i, swar_flip_range(x, first));
+	}
+	for (; i < size; ++i)
+	{
+		data[i] = Lower ? fold_lower(data[i]) : fold_upper(data[i]);
+	}
+}
+
+// Index of the first position where the lower-cased inputs differ, or size
+inline size_t ifind_mismatch(const char* lhs, const char* rhs, size_t size)
+{
+	size_t i = 0;
+#if defined(__AVX2__)
+	for (; i + 32 <= size; i += 32)
+	{
+		const __m256i a =
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+		const __m256i b =
+			_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+		if (_mm256_movemask_epi8(_mm256_or_si256(a, b)) != 0)
+		{
+			break;
+		}
+		const __m256i eq = _mm256_cmpeq_epi8(avx_flip_range(a, 'A'),
+											 avx_flip_range(b, 'A'));
+		const uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+		if (mask != 0)
+		{
+			return i + std::countr_zero(mask);
+		}
+	}
+#endif
+#if defined(__SSE2__)
+	for (; i + 16 <= size; i += 16)
+	{
+		const __m128i a =
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+		const __m128i b =
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+		if (_mm_movemask_epi8(_mm_or_si128(a, b)) != 0)
+		{
+			break;
+		}
+		const __m128i eq =
+			_mm_cmpeq_epi8(sse_flip_range(a, 'A'), sse_flip_range(b, 'A'));
+		const uint32_t mask = ~_mm_movemask_epi8(eq) & 0xffffu;
+		if (mask != 0)
+		{
+			return i + std::countr_zero(mask);
+		}
+	}
+#endif
+	for (; i + 8 <= size; i += 8)
+	{
+		const uint64_t a = load_u64(lhs + i);
+		const uint64_t b = load_u64(rhs + i);
+		if (((a | b) & swar_high) != 0)
+		{
+			break;
+		}
+		const uint64_t diff = swar_lower(a) ^ swar_lower(b);
+		if (diff != 0)
+		{
+			if constexpr (std::endian::native == std::endian::little)
+			{
+				return i + std::countr_zero(diff) / 8;
+			}
+			break;
+		}
+	}
+	for (; i < size; ++i)
+	{
+		if (fold_lower(lhs[i]) != fold_lower(rhs[i]))
+		{
+			return i;
+		}
+	}
+	return size;
+}
+
+template <typename T>
+size_t ifind_mismatch(const T* lhs, const T* rhs, size_t size)
+{
+	for (size_t i = 0; i < size; ++i)
+	{
+		if (fold_lower(lhs[i]) != fold_lower(rhs[i]))
+		{
+			return i;
+		}
+	}
+	return size;
+}
+}  // namespace
+
+template <typename T>
+void to_lower(T* data, size_t size)
+{
+	if constexpr (std::is_same_v<T, char>)
+	{
+		fold_chars<true>(data, size);
+	}
+	else
+	{
+		for (size_t i = 0; i < size; ++i)
+		{
+			data[i] = fold_lower(data[i]);
+		}
+	}
+}
+
+template <typename T>
+void to_upper(T* data, size_t size)
+{
+	if constexpr (std::is_same_v<T, char>)
+	{
+		fold_chars<false>(data, size);
+	}
+	else
+	{
+		for (size_t i = 0; i < size; ++i)
+		{
+			data[i] = fold_upper(data[i]);
+		}
+	}
+}
+
+template <typename T>
+bool iequals(const T* lhs, size_t lhs_size, const T* rhs, size_t rhs_size)
+{
+	return lhs_size == rhs_size &&
+		   ifind_mismatch(lhs, rhs, lhs_size) == lhs_size;
+}
+
+template <typename T>
+int icompare(const T* lhs, size_t lhs_size, const T* rhs, size_t rhs_size)
+{
+	using U = std::make_unsigned_t<T>;
+	const size_t common = lhs_size < rhs_size ? lhs_size : rhs_size;
+	const size_t pos = ifind_mismatch(lhs, rhs, common);
+	if (pos != common)
+	{
+		const U a = static_cast<U>(fold_lower(lhs[pos]));
+		const U b = static_cast<U>(fold_lower(rhs[pos]));
+		return a < b ? -1 : 1;
+	}
+	if (lhs_size == rhs_size)
+	{
+		return 0;
+	}
+	return lhs_size < rhs_size ? -1 : 1;
+}
+}  // namespace bmstu
@@ -0,0 +1,286 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace bmstu
+{
+inline constexpr uint64_t fnv_offset_basis = 14695981039346656037ull;
+inline constexpr uint64_t fnv_prime = 1099511628211ull;
+
+constexpr uint64_t fixed_hash(const char* str,
+							  size_t size,
+							  uint64_t seed = 0) noexcept
+{
+	uint64_t hash = fnv_offset_basis ^ seed;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= static_cast<unsigned char>(str[i]);
+		hash *= fnv_prime;
+	}
+	return hash;
+}
+
+constexpr uint64_t fixed_hash(std::string_view str, uint64_t seed = 0) noexcept
+{
+	return fixed_hash(str.data(), str.size(), seed);
+}
+
+// Structural type: data_ must stay public to be usable as a template argument
+template <size_t N>
+struct fixed_string
+{
+	constexpr fixed_string(const char (&str)[N]) noexcept
+	{
+		for (size_t i = 0; i < N; ++i)
+		{
+			data_[i] = str[i];
+		}
+	}
+
+	constexpr size_t size() const noexcept { return N - 1; }
+
+	constexpr size_t length() const noexcept { return N - 1; }
+
+	constexpr bool empty() const noexcept { return N == 1; }
+
+	constexpr const char* c_str() const noexcept { return data_; }
+
+	constexpr const char* begin() const noexcept { return data_; }
+
+	constexpr const char* end() const noexcept { return data_ + N - 1; }
+
+	constexpr char operator[](size_t index) const noexcept
+	{
+		return data_[index];
+	}
+
+	constexpr uint64_t hash(uint64_t seed = 0) const noexcept
+	{
+		return fixed_hash(data_, N - 1, seed);
+	}
+
+	constexpr operator std::string_view() const noexcept
+	{
+		return {data_, N - 1};
+	}
+
+	template <size_t M>
+	friend constexpr bool operator==(const fixed_string& lhs,
+									 const fixed_string<M>& rhs) noexcept
+	{
+		return std::string_view(lhs) == std::string_view(rhs);
+	}
+
+	char data_[N] = {};
+};
+
+template <size_t N>
+fixed_string(const char (&)[N]) -> fixed_string<N>;
+
+// Perfect hash over a fixed keyword set, built at compile time with
+// hash-and-displace: every keyword hashes into a small bucket, and each bucket
+// gets a displacement that sends its keywords to free slots. A lookup costs
+// one pass over the input, two mixes and one final comparison.
+template <fixed_string... Keywords>
+class keyword_table
+{
+   public:
+	static constexpr int npos = -1;
+
+	static constexpr size_t size() noexcept { return sizeof...(Keywords); }
+
+	static constexpr int find(const char* str, size_t size) noexcept
+	{
+		const uint64_t hash = fixed_hash(str, size);
+		const uint32_t seed = table_.seeds[bucket_of(hash)];
+		const int16_t id = table_.slots[slot_of(hash, seed)];
+		if (id == npos)
+		{
+			return npos;
+		}
+		const std::string_view keyword = keywords_[id];
+		if (keyword.size() != size)
+		{
+			return npos;
+		}
+		for (size_t i = 0; i < size; ++i)
+		{
+			if (keyword[i] != str[i])
+			{
+				return npos;
+			}
+		}
+		return id;
+	}
+
+	static constexpr int find(std::string_view str) noexcept
+	{
+		return find(str.data(), str.size());
+	}
+
+	template <typename String>
+		requires requires(const String& str) {
+			{ str.c_str() } -> std::convertible_to<const char*>;
+			{ str.size() } -> std::convertible_to<size_t>;
+		}
+	static constexpr int find(const String& str) noexcept
+	{
+		return find(str.c_str(), str.size());
+	}
+
+	template <fixed_string Keyword>
+	static consteval int id_of()
+	{
+		const int id = find(std::string_view(Keyword));
+		if (id == npos)
+		{
+			throw "keyword is not in the table";
+		}
+		return id;
+	}
+
+	static constexpr std::string_view keyword(size_t id) noexcept
+	{
+		return keywords_[id];
+	}
+
+   private:
+	static_assert(sizeof...(Keywords) > 0, "keyword_table needs keywords");
+	static_assert(sizeof...(Keywords) < 0x7fff, "too many keywords");
+
+	static constexpr size_t count_ = sizeof...(Keywords);
+	static constexpr size_t buckets_ = std::bit_ceil((count_ + 1) / 2);
+	static constexpr size_t slots_ = std::bit_ceil(count_) * 2;
+	static constexpr uint32_t max_seed_ = 1u << 16;
+
+	static constexpr std::array<std::string_view, count_> keywords_ = {
+		std::string_view(Keywords)...};
+
+	struct table
+	{
+		std::array<uint32_t, buckets_> seeds{};
+		std::array<int16_t, slots_> slots{};
+	};
+
+	static constexpr uint64_t mix(uint64_t x) noexcept
+	{
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdull;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ull;
+		x ^= x >> 33;
+		return x;
+	}
+
+	static constexpr size_t bucket_of(uint64_t hash) noexcept
+	{
+		return (mix(hash) >> 32) & (buckets_ - 1);
+	}
+
+	static constexpr size_t slot_of(uint64_t hash, uint32_t seed) noexcept
+	{
+		return mix(hash ^ (seed * 0x9e3779b97f4a7c15ull)) & (slots_ - 1);
+	}
+
+	static consteval table build()
+	{
+		for (size_t i = 0; i < count_; ++i)
+		{
+			for (size_t j = i + 1; j < count_; ++j)
+			{
+				if (keywords_[i] == keywords_[j])
+				{
+					throw "duplicate keyword";
+				}
+			}
+		}
+
+		std::array<uint64_t, count_> hashes{};
+		std::array<size_t, buckets_> bucket_sizes{};
+		for (size_t i = 0; i < count_; ++i)
+		{
+			hashes[i] = fixed_hash(keywords_[i]);
+			++bucket_sizes[bucket_of(hashes[i])];
+		}
+
+		// largest buckets first: they are the hardest to place
+		std::array<size_t, buckets_> order{};
+		for (size_t i = 0; i < buckets_; ++i)
+		{
+			order[i] = i;
+		}
+		for (size_t i = 1; i < buckets_; ++i)
+		{
+			for (size_t j = i;
+				 j > 0 && bucket_sizes[order[j - 1]] < bucket_sizes[order[j]];
+				 --j)
+			{
+				std::swap(order[j - 1], order[j]);
+			}
+		}
+
+		table result;
+		for (auto& slot : result.slots)
+		{
+			slot = npos;
+		}
+
+		std::array<size_t, count_> members{};
+		std::array<size_t, count_> taken{};
+		for (size_t bucket : order)
+		{
+			size_t member_count = 0;
+			for (size_t i = 0; i < count_; ++i)
+			{
+				if (bucket_of(hashes[i]) == bucket)
+				{
+					members[member_count++] = i;
+				}
+			}
+			if (member_count == 0)
+			{
+				continue;
+			}
+
+			bool placed = false;
+			for (uint32_t seed = 0; seed < max_seed_ && !placed; ++seed)
+			{
+				placed = true;
+				for (size_t m = 0; m < member_count && placed; ++m)
+				{
+					taken[m] = slot_of(hashes[members[m]], seed);
+					if (result.slots[taken[m]] != npos)
+					{
+						placed = false;
+					}
+					for (size_t k = 0; k < m && placed; ++k)
+					{
+						placed = taken[k] != taken[m];
+					}
+				}
+				if (placed)
+				{
+					result.seeds[bucket] = seed;
+					for (size_t m = 0; m < member_count; ++m)
+					{
+						result.slots[taken[m]] =
+							static_cast<int16_t>(members[m]);
+					}
+				}
+			}
+			if (!placed)
+			{
+				throw "no perfect hash displacement found";
+			}
+		}
+		return result;
+	}
+
+	static constexpr table table_ = build();
+};
+}  // namespace bmstu
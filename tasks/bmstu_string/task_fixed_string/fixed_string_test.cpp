@@ -0,0 +1,221 @@
+#include "bmstu_fixed_string.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bmstu_map.h"
+#include "bmstu_sso_string.h"
+
+template <bmstu::fixed_string S>
+struct tagged
+{
+	static constexpr size_t size = S.size();
+	static constexpr uint64_t hash = S.hash();
+};
+
+using http_methods = bmstu::keyword_table<"GET",
+										  "HEAD",
+										  "POST",
+										  "PUT",
+										  "DELETE",
+										  "CONNECT",
+										  "OPTIONS",
+										  "TRACE",
+										  "PATCH">;
+
+TEST(FixedStringTest, ConstexprLength)
+{
+	constexpr bmstu::fixed_string str("keyword");
+	static_assert(str.size() == 7);
+	static_assert(str.length() == 7);
+	static_assert(!str.empty());
+	static_assert(str[0] == 'k');
+	static_assert(bmstu::fixed_string("").empty());
+	ASSERT_STREQ(str.c_str(), "keyword");
+}
+
+TEST(FixedStringTest, ConstexprHash)
+{
+	constexpr bmstu::fixed_string str("keyword");
+	static_assert(str.hash() == bmstu::fixed_hash("keyword", 7));
+	static_assert(str.hash() != bmstu::fixed_string("keyworD").hash());
+	static_assert(str.hash(1) != str.hash());
+	std::string runtime = "keyword";
+	ASSERT_EQ(bmstu::fixed_hash(runtime.data(), runtime.size()), str.hash());
+}
+
+TEST(FixedStringTest, TemplateArgument)
+{
+	static_assert(tagged<"abc">::size == 3);
+	static_assert(tagged<"abc">::hash == bmstu::fixed_hash("abc", 3));
+	static_assert(std::is_same_v<tagged<"abc">, tagged<"abc">>);
+	static_assert(!std::is_same_v<tagged<"abc">, tagged<"abd">>);
+}
+
+TEST(FixedStringTest, Compare)
+{
+	static_assert(bmstu::fixed_string("abc") == bmstu::fixed_string("abc"));
+	static_assert(!(bmstu::fixed_string("abc") == bmstu::fixed_string("ab")));
+	ASSERT_EQ(std::string_view(bmstu::fixed_string("abc")), "abc");
+}
+
+TEST(KeywordTableTest, FindsEveryKeyword)
+{
+	static_assert(http_methods::size() == 9);
+	for (size_t id = 0; id < http_methods::size(); ++id)
+	{
+		ASSERT_EQ(http_methods::find(http_methods::keyword(id)),
+				  static_cast<int>(id));
+	}
+}
+
+TEST(KeywordTableTest, CompileTimeLookup)
+{
+	static_assert(http_methods::find("GET") == 0);
+	static_assert(http_methods::find("PATCH") == 8);
+	static_assert(http_methods::find("get") == http_methods::npos);
+	static_assert(http_methods::id_of<"DELETE">() == 4);
+}
+
+TEST(KeywordTableTest, RejectsUnknown)
+{
+	ASSERT_EQ(http_methods::find(""), http_methods::npos);
+	ASSERT_EQ(http_methods::find("GE"), http_methods::npos);
+	ASSERT_EQ(http_methods::find("GETS"), http_methods::npos);
+	ASSERT_EQ(http_methods::find("POSt"), http_methods::npos);
+	ASSERT_EQ(http_methods::find("LINK"), http_methods::npos);
+}
+
+TEST(KeywordTableTest, StringInput)
+{
+	bmstu::string post("POST");
+	bmstu::string unknown("POSTS");
+	ASSERT_EQ(http_methods::find(post), 2);
+	ASSERT_EQ(http_methods::find(unknown), http_methods::npos);
+	ASSERT_EQ(http_methods::find(std::string("OPTIONS")), 6);
+}
+
+TEST(KeywordTableTest, Dispatch)
+{
+	auto dispatch = [](std::string_view token)
+	{
+		switch (http_methods::find(token))
+		{
+			case http_methods::id_of<"GET">():
+				return 1;
+			case http_methods::id_of<"PUT">():
+				return 2;
+			default:
+				return 0;
+		}
+	};
+	ASSERT_EQ(dispatch("GET"), 1);
+	ASSERT_EQ(dispatch("PUT"), 2);
+	ASSERT_EQ(dispatch("HEAD"), 0);
+	ASSERT_EQ(dispatch("XYZ"), 0);
+}
+
+using sql_keywords = bmstu::keyword_table<
+	"SELECT", "FROM", "WHERE", "INSERT", "INTO", "VALUES", "UPDATE", "SET",
+	"DELETE", "CREATE", "TABLE", "DROP", "ALTER", "INDEX", "JOIN", "LEFT",
+	"RIGHT", "INNER", "OUTER", "ON", "AS", "AND", "OR", "NOT", "NULL", "IS",
+	"IN", "LIKE", "BETWEEN", "ORDER", "BY", "GROUP", "HAVING", "LIMIT",
+	"OFFSET", "UNION", "ALL", "DISTINCT", "EXISTS", "CASE", "WHEN", "THEN",
+	"ELSE", "END", "PRIMARY", "KEY", "FOREIGN", "REFERENCES", "DEFAULT",
+	"CHECK", "UNIQUE", "VIEW", "TRIGGER", "BEGIN", "COMMIT", "ROLLBACK">;
+
+TEST(KeywordTableTest, LargerSet)
+{
+	for (size_t id = 0; id < sql_keywords::size(); ++id)
+	{
+		ASSERT_EQ(sql_keywords::find(sql_keywords::keyword(id)),
+				  static_cast<int>(id));
+	}
+	ASSERT_EQ(sql_keywords::find("SELECTS"), sql_keywords::npos);
+	ASSERT_EQ(sql_keywords::find("select"), sql_keywords::npos);
+}
+
+namespace
+{
+int if_else_find(std::string_view token)
+{
+	for (size_t id = 0; id < sql_keywords::size(); ++id)
+	{
+		if (token == sql_keywords::keyword(id))
+		{
+			return static_cast<int>(id);
+		}
+	}
+	return -1;
+}
+
+std::vector<std::string> make_tokens(size_t count)
+{
+	std::vector<std::string> tokens;
+	tokens.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		std::string token(sql_keywords::keyword(i % sql_keywords::size()));
+		if (i % 4 == 3)
+		{
+			token += "_x";
+		}
+		tokens.push_back(token);
+	}
+	return tokens;
+}
+
+template <typename Token, typename Lookup>
+void run_bench(const char* name,
+			   const std::vector<Token>& tokens,
+			   Lookup lookup)
+{
+	auto start = std::chrono::steady_clock::now();
+	long long sum = 0;
+	for (int round = 0; round < 20; ++round)
+	{
+		for (const auto& token : tokens)
+		{
+			sum += lookup(token);
+		}
+	}
+	auto elapsed = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start);
+	std::cout << name << ": " << elapsed.count() << " ms (checksum " << sum
+			  << ")" << std::endl;
+}
+}  // namespace
+
+// Run with --gtest_also_run_disabled_tests
+TEST(KeywordTableBench, DISABLED_Lookup)
+{
+	const auto tokens = make_tokens(1 << 16);
+
+	bmstu::map<bmstu::string, int> by_map;
+	for (size_t id = 0; id < sql_keywords::size(); ++id)
+	{
+		by_map.insert(std::string(sql_keywords::keyword(id)).c_str(),
+					  static_cast<int>(id));
+	}
+	// converted up front, so the map lookups don't pay for it
+	std::vector<bmstu::string> map_tokens;
+	map_tokens.reserve(tokens.size());
+	for (const std::string& token : tokens)
+	{
+		map_tokens.emplace_back(token.c_str());
+	}
+
+	run_bench("keyword_table", tokens,
+			  [](const std::string& token)
+			  { return sql_keywords::find(token); });
+	run_bench("if-else chain", tokens,
+			  [](const std::string& token) { return if_else_find(token); });
+	run_bench("bmstu::map", map_tokens,
+			  [&by_map](const bmstu::string& token)
+			  {
+				  const int* id = by_map.find(token);
+				  return id == nullptr ? -1 : *id;
+			  });
+}
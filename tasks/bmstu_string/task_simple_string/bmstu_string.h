@@ -5,6 +5,7 @@
 #include <utility>
 #include <algorithm>
 #include <initializer_list>
+#include "bmstu_ascii_case.h"
 
 namespace bmstu {
     template<typename T>
@@ -130,6 +131,17 @@ namespace bmstu {
             if (capacity_ > 0) data_[0] = 0;
         }
 
+        void to_lower() { bmstu::to_lower(data_, size_); }
+        void to_upper() { bmstu::to_upper(data_, size_); }
+
+        friend bool iequals(const simple_basic_string& lhs, const simple_basic_string& rhs) {
+            return bmstu::iequals(lhs.data_, lhs.size_, rhs.data_, rhs.size_);
+        }
+
+        friend int icompare(const simple_basic_string& lhs, const simple_basic_string& rhs) {
+            return bmstu::icompare(lhs.data_, lhs.size_, rhs.data_, rhs.size_);
+        }
+
         void reserve(size_t new_capacity) {
             if (new_capacity <= capacity_) return;
             T* new_data = new T[new_capacity];
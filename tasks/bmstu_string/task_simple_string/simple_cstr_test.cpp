@@ -289,3 +289,28 @@ TEST(StringTest, Item)
 	ASSERT_EQ(a_str[1], L'Т');
 	ASSERT_EQ(a_str[a_str.size() - 1], L'Г');
 }
+
+TEST(StringTest, CaseFolding)
+{
+	bmstu::string header("Content-Type: Text/HTML; Charset=UTF-8");
+	header.to_lower();
+	ASSERT_STREQ(header.c_str(), "content-type: text/html; charset=utf-8");
+	header.to_upper();
+	ASSERT_STREQ(header.c_str(), "CONTENT-TYPE: TEXT/HTML; CHARSET=UTF-8");
+
+	bmstu::wstring wide(L"Cache-Control");
+	wide.to_lower();
+	ASSERT_STREQ(wide.c_str(), L"cache-control");
+}
+
+TEST(StringTest, CaseInsensitiveCompare)
+{
+	ASSERT_TRUE(
+		iequals(bmstu::string("Set-Cookie"), bmstu::string("SET-COOKIE")));
+	ASSERT_FALSE(
+		iequals(bmstu::string("Set-Cookie"), bmstu::string("Set-Cookie2")));
+	ASSERT_EQ(icompare(bmstu::string("ETAG"), bmstu::string("etag")), 0);
+	ASSERT_LT(icompare(bmstu::string("age"), bmstu::string("VARY")), 0);
+	ASSERT_GT(icompare(bmstu::string("Vary"), bmstu::string("VA")), 0);
+	ASSERT_TRUE(iequals(bmstu::wstring(L"Range"), bmstu::wstring(L"RANGE")));
+}
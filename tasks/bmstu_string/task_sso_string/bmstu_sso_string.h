@@ -3,8 +3,10 @@
 #include <exception>
 #include <iostream>
 #include <algorithm>
+#include <compare>
 #include <utility>
 #include <cstring>
+#include "bmstu_ascii_case.h"
 
 namespace bmstu {
     template<typename T>
@@ -28,7 +30,7 @@ namespace bmstu {
         };
         
         Storage storage_;
-        bool is_long_;
+        bool is_long_ = false;
         
         bool is_long() const { return is_long_; }
         
@@ -114,6 +116,23 @@ namespace bmstu {
         }
         
     public:
+        // Disengaged state for compact_optional<basic_string>: a short string
+        // with a size byte that a real short string can never have
+        struct compact_policy {
+            static constexpr unsigned char empty_size = 0xFF;
+            static_assert(SSO_SIZE < empty_size);
+
+            static basic_string empty_value() {
+                basic_string str;
+                str.storage_.short_.size = empty_size;
+                return str;
+            }
+
+            static bool is_empty(const basic_string& str) {
+                return !str.is_long_ && str.storage_.short_.size == empty_size;
+            }
+        };
+
         basic_string() : is_long_(false) {
             storage_.short_.size = 0;
             storage_.short_.data[0] = 0;
@@ -206,6 +225,27 @@ namespace bmstu {
             size_ref() = 0;
             if (data()) data()[0] = 0;
         }
+
+        void to_lower() { bmstu::to_lower(data(), size()); }
+        void to_upper() { bmstu::to_upper(data(), size()); }
+
+        friend bool iequals(const basic_string& lhs, const basic_string& rhs) {
+            return bmstu::iequals(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+        }
+
+        friend int icompare(const basic_string& lhs, const basic_string& rhs) {
+            return bmstu::icompare(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+        }
+        
+        friend bool operator==(const basic_string& lhs, const basic_string& rhs) {
+            return lhs.size() == rhs.size() &&
+                   std::equal(lhs.data(), lhs.data() + lhs.size(), rhs.data());
+        }
+
+        friend auto operator<=>(const basic_string& lhs, const basic_string& rhs) {
+            return std::lexicographical_compare_three_way(
+                lhs.data(), lhs.data() + lhs.size(), rhs.data(), rhs.data() + rhs.size());
+        }
         
         T& operator[](size_t i) { return data()[i]; }
         const T& operator[](size_t i) const { return data()[i]; }